@@ -12,6 +12,10 @@
  *
  *  Equally so for 3D arrys:  array[nt][nr][nc]       
  *
+ *  The elements of 2D and 3D arrays are allocated at an address aligned to
+ *  ARRAY_ALIGN bytes (a cache line), so that e.g. no ConsS of 8 doubles
+ *  straddles two cache lines.
+ *
  *  TAG -- 8/2/2001
  *
  * EXAMPLE usage of 3D construct/destruct functions for arrays of type Real:
@@ -24,12 +28,20 @@
  *   - calloc_3d_array() - creates 3D array
  *   - free_1d_array()   - destroys 1D array
  *   - free_2d_array()   - destroys 2D array
- *   - free_3d_array()   - destroys 3D array				      */
+ *   - free_3d_array()   - destroys 3D array
+ *
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   - calloc_aligned()  - allocates and zeroes aligned memory		      */
 /*============================================================================*/
 
 #include <stdlib.h>
+#include <string.h>
 #include "prototypes.h"
 
+#define ARRAY_ALIGN 64
+
+static void* calloc_aligned(size_t n, size_t size);
+
 /*----------------------------------------------------------------------------*/
 /*! \fn void* calloc_1d_array(size_t nc, size_t size)
  *  \brief Construct 1D array = array[nc]  */
@@ -58,7 +70,7 @@ void** calloc_2d_array(size_t nr, size_t nc, size_t size)
     return NULL;
   }
 
-  if((array[0] = (void *)calloc(nr*nc,size)) == NULL){
+  if((array[0] = calloc_aligned(nr*nc,size)) == NULL){
     ath_error("[calloc_2d] failed to allocate memory (%d X %d of size %d)\n",
               (int)nr,(int)nc,(int)size);
     free((void *)array);
@@ -97,7 +109,7 @@ void*** calloc_3d_array(size_t nt, size_t nr, size_t nc, size_t size)
     array[i] = (void **)((unsigned char *)array[0] + i*nr*sizeof(void*));
   }
 
-  if((array[0][0] = (void *)calloc(nt*nr*nc,size)) == NULL){
+  if((array[0][0] = calloc_aligned(nt*nr*nc,size)) == NULL){
     ath_error("[calloc_3d] failed to alloc. memory (%d X %d X %d of size %d)\n",
               (int)nt,(int)nr,(int)nc,(int)size);
     free((void *)array[0]);
@@ -149,3 +161,17 @@ void free_3d_array(void *array)
   free(ta[0]);
   free(array);
 }
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void* calloc_aligned(size_t n, size_t size)
+ *  \brief Like calloc(n,size), but aligned to ARRAY_ALIGN bytes; the memory
+ *   is freed with free() */
+static void* calloc_aligned(size_t n, size_t size)
+{
+  void *ptr;
+
+  if (posix_memalign(&ptr, ARRAY_ALIGN, n*size) != 0) return NULL;
+  memset(ptr, 0, n*size);
+
+  return ptr;
+}
@@ -0,0 +1,352 @@
+#include "copyright.h"
+/*============================================================================*/
+/*! \file ath_async.c
+ *  \brief Functions to write output files in a background thread.
+ *
+ * PURPOSE: Functions to write output files in a background thread, so that
+ *   the integration proceeds while restart and vtk dumps are written.  A dump
+ *   function opens its file with ath_async_open() and closes it with
+ *   ath_async_close() instead of fopen()/fclose().  With ASYNC_IO, the file is
+ *   then first written into a staging buffer in memory (with open_memstream),
+ *   which is a complete copy of the file, so the arrays may change as soon as
+ *   the dump function returns.  ath_async_close() queues the buffer, and a
+ *   single writer thread drains the queue to disk.
+ *
+ *   The caller waits in two cases only:
+ *   - ath_async_open() waits until the files of the previous dump of the same
+ *     output are written, so each output has at most one dump in memory;
+ *   - ath_async_close() waits while the queued buffers and the one being
+ *     written hold more than ASYNC_MAXBYTE bytes.  A single larger file is
+ *     still queued once the queue is empty.
+ *   ath_async_wait() waits until all queued files are written, and is called
+ *   by main() before exiting.
+ *
+ *   The writer thread neither logs nor makes MPI calls.  It hands the files it
+ *   failed to write back to the main thread, which reports them with ath_perr()
+ *   the next time it enters one of the public functions.  MPI is initialized
+ *   with MPI_THREAD_FUNNELED.
+ *
+ *   Without ASYNC_IO, ath_async_open() and ath_async_close() simply call
+ *   fopen() and fclose().
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - ath_async_open()  - opens a file for writing (into a staging buffer)
+ * - ath_async_close() - closes a file and queues it for writing
+ * - ath_async_wait()  - waits until all queued files are written
+ *
+ * PRIVATE FUNCTION PROTOTYPES:
+ * - async_writer()  - the writer thread
+ * - async_pending() - is a previous dump of an output still being written?
+ * - async_report()  - reports the files the writer thread failed to write
+ * - wtime()         - wall clock time in seconds                            */
+/*============================================================================*/
+
+#ifdef __linux__
+#define _GNU_SOURCE /* open_memstream() */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "defs.h"
+#include "athena.h"
+#include "prototypes.h"
+
+#ifdef ASYNC_IO
+#include <pthread.h>
+#include <sys/time.h>
+
+/* maximum number of bytes in the queue and the file being written */
+#define ASYNC_MAXBYTE ((size_t)256*1024*1024)
+
+/*! \struct AsyncJob
+ *  \brief A file being staged, waiting to be written, or failed */
+typedef struct AsyncJob_s{
+  FILE *fp;          /*!< memory stream, while the file is being staged */
+  char *buf;         /*!< staging buffer */
+  size_t size;       /*!< size of the staging buffer */
+  char *fname;       /*!< name of the file on disk */
+  const OutputS *pOut; /*!< output this file belongs to */
+  int num;           /*!< output number (pOut->num) of the dump */
+  int err;           /*!< 0, or ASYNC_EOPEN, ASYNC_EWRITE if writing failed */
+  struct AsyncJob_s *next;
+}AsyncJob;
+
+enum {ASYNC_EOPEN=1, ASYNC_EWRITE};
+
+static AsyncJob *open_jobs = NULL;   /* files being staged */
+static AsyncJob *qfirst = NULL, *qlast = NULL; /* FIFO of staged files */
+static AsyncJob *busy = NULL;        /* file being written */
+static AsyncJob *failed = NULL;      /* files not written, to be reported */
+static size_t qbyte = 0;             /* bytes in the FIFO and busy */
+static int running = 0;
+static pthread_t writer;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t not_empty = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t job_done = PTHREAD_COND_INITIALIZER;
+
+/* statistics, reported by ath_async_wait() */
+static long nfile = 0, nfail = 0;
+static double nbyte = 0.0, twait = 0.0;
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   async_writer()  - the writer thread
+ *   async_pending() - is a previous dump of an output still being written?
+ *   async_report()  - reports the files the writer thread failed to write
+ *   wtime()         - wall clock time in seconds
+ *============================================================================*/
+static void *async_writer(void *arg);
+static int async_pending(const OutputS *pOut, const int num);
+static void async_report(void);
+static double wtime(void);
+#endif /* ASYNC_IO */
+
+/*============================================================================*/
+/*----------------------------- Public Functions -----------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn FILE *ath_async_open(const char *fname, const OutputS *pOut)
+ *  \brief Opens file fname of output pOut for writing.  With ASYNC_IO, waits
+ *   until the previous dump of pOut is written, and returns a stream to a
+ *   staging buffer in memory.  Returns NULL on error, as fopen(). */
+FILE *ath_async_open(const char *fname, const OutputS *pOut)
+{
+#ifdef ASYNC_IO
+  AsyncJob *job;
+  double t0;
+
+/* Wait for the files of the previous dump of this output */
+
+  pthread_mutex_lock(&lock);
+  t0 = wtime();
+  while (async_pending(pOut, pOut->num))
+    pthread_cond_wait(&job_done, &lock);
+  twait += wtime() - t0;
+  pthread_mutex_unlock(&lock);
+  async_report();
+
+  if ((job = (AsyncJob*)calloc(1, sizeof(AsyncJob))) == NULL) return NULL;
+  if ((job->fname = (char*)malloc(strlen(fname)+1)) == NULL) {
+    free(job);
+    return NULL;
+  }
+  strcpy(job->fname, fname);
+  job->pOut = pOut;
+  job->num = pOut->num;
+
+  if ((job->fp = open_memstream(&(job->buf), &(job->size))) == NULL) {
+    free(job->fname);
+    free(job);
+    return NULL;
+  }
+
+  job->next = open_jobs;
+  open_jobs = job;
+
+  return job->fp;
+#else
+  return fopen(fname, "wb");
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn int ath_async_close(FILE *fp)
+ *  \brief Closes a file opened with ath_async_open().  With ASYNC_IO, queues
+ *   its staging buffer for the writer thread, waiting first while more than
+ *   ASYNC_MAXBYTE bytes are queued.  Returns 0 on success, as fclose(). */
+int ath_async_close(FILE *fp)
+{
+#ifdef ASYNC_IO
+  AsyncJob *job, **pjob;
+  double t0;
+
+/* Find and unlink the job of this stream */
+
+  for (pjob = &open_jobs; *pjob != NULL; pjob = &((*pjob)->next))
+    if ((*pjob)->fp == fp) break;
+  if ((job = *pjob) == NULL)
+    return fclose(fp);
+  *pjob = job->next;
+  job->next = NULL;
+
+  if (fclose(job->fp) != 0) {
+    free(job->buf);
+    free(job->fname);
+    free(job);
+    return EOF;
+  }
+  job->fp = NULL;
+
+/* Queue the staging buffer, starting the writer thread if needed */
+
+  pthread_mutex_lock(&lock);
+  if (!running) {
+    if (pthread_create(&writer, NULL, async_writer, NULL) != 0) {
+      pthread_mutex_unlock(&lock);
+      ath_error("[ath_async_close]: Unable to start the writer thread\n");
+    }
+    running = 1;
+  }
+  t0 = wtime();
+  while ((qbyte > 0) && (qbyte + job->size > ASYNC_MAXBYTE))
+    pthread_cond_wait(&job_done, &lock);
+  twait += wtime() - t0;
+
+  if (qlast == NULL) qfirst = job;
+  else qlast->next = job;
+  qlast = job;
+  qbyte += job->size;
+  nfile++;
+  nbyte += (double)job->size;
+  pthread_cond_signal(&not_empty);
+  pthread_mutex_unlock(&lock);
+  async_report();
+
+  return 0;
+#else
+  return fclose(fp);
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void ath_async_wait(void)
+ *  \brief Waits until all queued files are written and stops the writer
+ *   thread.  Reports the files that could not be written, the number of files
+ *   written in the background and the time the integration waited for them. */
+void ath_async_wait(void)
+{
+#ifdef ASYNC_IO
+  double t0;
+
+  pthread_mutex_lock(&lock);
+  if (!running) {
+    pthread_mutex_unlock(&lock);
+    return;
+  }
+  t0 = wtime();
+  while ((qfirst != NULL) || (busy != NULL))
+    pthread_cond_wait(&job_done, &lock);
+  running = 0;
+  pthread_cond_signal(&not_empty);   /* let the writer thread exit */
+  pthread_mutex_unlock(&lock);
+  pthread_join(writer, NULL);
+  async_report();
+
+  ath_pout(0,"[ath_async_wait]: %ld files (%.3e bytes) written in the \
+background, %ld failed, waited %.3e s during the run and %.3e s at the end\n",
+           nfile-nfail,nbyte,nfail,twait,wtime()-t0);
+#endif
+
+  return;
+}
+
+#ifdef ASYNC_IO
+/*============================================================================*/
+/*----------------------------- Private Functions ----------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void *async_writer(void *arg)
+ *  \brief The writer thread: writes the queued staging buffers to disk, until
+ *   ath_async_wait() clears running with an empty queue.  Files that cannot
+ *   be written are moved to the failed list for the main thread to report. */
+static void *async_writer(void *arg)
+{
+  AsyncJob *job;
+  FILE *fp;
+  int err;
+
+  pthread_mutex_lock(&lock);
+  for (;;) {
+    while ((qfirst == NULL) && running)
+      pthread_cond_wait(&not_empty, &lock);
+    if (qfirst == NULL) break;
+
+    job = busy = qfirst;
+    if ((qfirst = job->next) == NULL) qlast = NULL;
+    job->next = NULL;
+    pthread_mutex_unlock(&lock);
+
+    err = 0;
+    if ((fp = fopen(job->fname, "wb")) == NULL) {
+      err = ASYNC_EOPEN;
+    } else {
+      if (fwrite(job->buf, 1, job->size, fp) != job->size) err = ASYNC_EWRITE;
+      if (fclose(fp) != 0) err = ASYNC_EWRITE;
+    }
+    free(job->buf);
+    job->buf = NULL;
+
+    pthread_mutex_lock(&lock);
+    busy = NULL;
+    qbyte -= job->size;
+    if (err) {
+      job->err = err;
+      job->next = failed;
+      failed = job;
+    } else {
+      free(job->fname);
+      free(job);
+    }
+    pthread_cond_broadcast(&job_done);
+  }
+  pthread_mutex_unlock(&lock);
+
+  return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int async_pending(const OutputS *pOut, const int num)
+ *  \brief Returns 1 if a file of output pOut from a dump other than num is
+ *   queued or being written.  Must be called with the lock held. */
+static int async_pending(const OutputS *pOut, const int num)
+{
+  AsyncJob *job;
+
+  if ((busy != NULL) && (busy->pOut == pOut) && (busy->num != num)) return 1;
+  for (job = qfirst; job != NULL; job = job->next)
+    if ((job->pOut == pOut) && (job->num != num)) return 1;
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void async_report(void)
+ *  \brief Reports, from the main thread, the files the writer thread failed
+ *   to write since the last call */
+static void async_report(void)
+{
+  AsyncJob *job, *list;
+
+  pthread_mutex_lock(&lock);
+  list = failed;
+  failed = NULL;
+  pthread_mutex_unlock(&lock);
+
+  while ((job = list) != NULL) {
+    list = job->next;
+    if (job->err == ASYNC_EOPEN)
+      ath_perr(-1,"[ath_async]: Unable to open %s\n",job->fname);
+    else
+      ath_perr(-1,"[ath_async]: Error writing %s\n",job->fname);
+    nfail++;
+    free(job->fname);
+    free(job);
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static double wtime(void)
+ *  \brief Wall clock time in seconds */
+static double wtime(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec + 1.0e-6*(double)tv.tv_usec;
+}
+
+#undef ASYNC_MAXBYTE
+
+#endif /* ASYNC_IO */
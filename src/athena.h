@@ -212,6 +212,7 @@ typedef struct Unit_S{
 typedef struct Grain_s{
   Real x1,x2,x3;	/*!< coordinate in X,Y,Z */
   Real v1,v2,v3;	/*!< velocity in X,Y,Z */
+  Real x1_0,x2_0,x3_0;	/*!< initial coordinate, shifted with periodic BCs */
   int property;		/*!< index of particle properties */
   short pos;		/*!< position: 0: ghost; 1: grid; >=10: cross out/in; */
   long my_id;		/*!< particle id */
@@ -261,6 +262,17 @@ typedef struct GPCouple_s{
 #endif
 }GPCouple;
 
+/*! \enum MomQuantity
+ *  \brief Quantities of the binned particle moments, see moments_particle.c */
+enum MomQuantity {mom_d, mom_M1, mom_M2, mom_M3, mom_J1, mom_J2, mom_J3,
+                  mom_P11, mom_P12, mom_P13, mom_P22, mom_P23, mom_P33, mom_E,
+                  NMOMQ};
+
+/*! \enum CRDep
+ *  \brief Quantities deposited for the back-reaction of the particles, see
+ *   backreaction_particle.c */
+enum CRDep {crd_q, crd_J1, crd_J2, crd_J3, crd_E, NCRDEP};
+
 #endif /* PARTICLES */
 
 /*----------------------------------------------------------------------------*/
@@ -333,6 +345,8 @@ typedef struct Grid_s{
   GrainS *particle;          /*!< array of all particles */
   GrainAux *parsub;          /*!< supplemental particle information */
   GPCouple ***Coup;          /*!< array of gas-particle coupling */
+  Real ****Mom;              /*!< binned particle moments [n][k][j][i] */
+  int nMom;                  /*!< number of arrays in Mom */
   ConsS*** Uhalf; // conserved variables at 1/2 step
   PrimS*** Whalf; // primitive variables at 1/2 step
 #endif /* PARTICLES */
@@ -461,6 +475,17 @@ typedef Real (*ConsFun_t)(const GridS *pG, const int i,const int j,const int k);
  *  \brief Particle property selection function */
 typedef int (*PropFun_t)(const GrainS *gr, const GrainAux *grsub);
 typedef Real (*Parfun_t)(const GridS *pG, const GrainS *gr);
+/*! \fn long (*InjectFun_t)(GridS *pG, GrainS *gr, long nslot)
+ *  \brief Particle injection function, see inject_particle.c */
+typedef long (*InjectFun_t)(GridS *pG, GrainS *gr, long nslot);
+/*! \fn void (*DepFun_t)(GridS *pG, const GrainS *gr, Real weight[3][3][3],
+ *                        int is, int js, int ks)
+ *  \brief Particle deposition function, see deposit_particle.c */
+typedef void (*DepFun_t)(GridS *pG, const GrainS *gr, Real weight[3][3][3],
+                         int is, int js, int ks);
+/*! \fn void (*CRSrcFun_t)(GridS *pG, Real ****crd, Real dt)
+ *  \brief Source terms of the back-reaction of the particles */
+typedef void (*CRSrcFun_t)(GridS *pG, Real ****crd, Real dt);
 #endif
 
 /*! \struct OutputS
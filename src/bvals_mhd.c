@@ -42,10 +42,23 @@
  * With SELF-GRAVITY: BCs for Phi are set independently of the MHD variables
  *   in a separate function bvals_grav(). 
  *
+ * The split-phase exchange bvals_mhd_start()/bvals_mhd_finish() instead sets
+ *   all ghost zones (edges and corners included) in a single round of
+ *   messages with the 26 neighbours of the Grid, when all its boundaries are
+ *   MPI or periodic, so that the integrator can compute on the active zones
+ *   while the messages are in flight.  It falls back to bvals_mhd() otherwise.
+ *   Its messages are described by MPI derived datatypes (subarrays of U, B1i,
+ *   B2i and B3i) and persistent requests, both set up once by
+ *   bvals_mhd_init(), so they are sent from and received into the Grid
+ *   arrays directly, without packing.
+ *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - bvals_mhd()      - calls appropriate functions to set ghost cells
+ * - bvals_mhd_start()  - starts the split-phase exchange of the ghost cells
+ * - bvals_mhd_finish() - completes the split-phase exchange
  * - bvals_mhd_init() - sets function pointers used by bvals_mhd()
  * - bvals_mhd_fun()  - enrolls a pointer to a user-defined BC function
+ * - bvals_mhd_destruct() - frees the MPI buffers, requests and datatypes
  *
  * PRIVATE FUNCTION PROTOTYPES:
  * - reflect_ix1()  - reflecting BCs at boundary ix1
@@ -83,11 +96,24 @@
  * - unpack_ix2()   - unpack data for MPI non-blocking receive at ix2 boundary
  * - unpack_ox2()   - unpack data for MPI non-blocking receive at ox2 boundary
  * - unpack_ix3()   - unpack data for MPI non-blocking receive at ix3 boundary
- * - unpack_ox3()   - unpack data for MPI non-blocking receive at ox3 boundary*/
+ * - unpack_ox3()   - unpack data for MPI non-blocking receive at ox3 boundary
+ * - pack_cons()    - copies a row of conserved variables to the send buffer
+ * - unpack_cons()  - copies a row of conserved variables from the recv buffer
+ * - bvals26_ok()   - tests whether the split-phase exchange can be used
+ * - bvals26_init() - sets the datatypes and requests of the exchange
+ * - dir26()        - offset of the neighbour in one of the 26 directions
+ * - range26()      - index range exchanged with one neighbour
+ * - type26()       - datatype of the message to/from one neighbour
+ *
+ * The conserved variables are packed cell by cell, NVAR doubles per cell, so
+ * when ConsS holds just these NVAR variables (all but with CYLINDRICAL; MPI
+ * requires double precision) a row of cells is copied as one block.
+ */
 /*============================================================================*/
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "defs.h"
 #include "athena.h"
 #include "globals.h"
@@ -96,9 +122,30 @@
 #ifdef MPI_PARALLEL
 /* MPI send and receive buffers */
 static double **send_buf = NULL, **recv_buf = NULL;
-static MPI_Request *recv_rq, *send_rq;
+static MPI_Request *recv_rq = NULL, *send_rq = NULL;
 #endif /* MPI_PARALLEL */
 
+/* The split-phase exchange of bvals_mhd_start() is used when nothing but the
+ * integrator reads the ghost zones (or changes the active zones, as the
+ * operator-split cooling of Step 9b in main.c does) between the end of a
+ * step and the next */
+#if defined(MPI_PARALLEL) && !defined(SHEARING_BOX) && \
+    !defined(STATIC_MESH_REFINEMENT) && !defined(THERMAL_CONDUCTION) && \
+    !defined(RESISTIVITY) && !defined(VISCOSITY) && \
+    !defined(OPERATOR_SPLIT_COOLING)
+#define BVALS26
+#endif
+
+#ifdef BVALS26
+/* Persistent requests of the exchange with the neighbours in the nq26
+ * directions q (see dir26()): the receives first, then the sends */
+static DomainS *pD26 = NULL;      /* Domain for which they are set up */
+static int pend26 = 0;            /* 1 while an exchange is in flight */
+static int nq26 = 0;              /* number of directions */
+static MPI_Datatype type26_rcv[26], type26_snd[26];
+static MPI_Request rq26[52];
+#endif /* BVALS26 */
+
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
  *   reflect_???()  - reflecting BCs at boundary ???
@@ -107,6 +154,13 @@ static MPI_Request *recv_rq, *send_rq;
  *   conduct_???()  - conducting BCs at boundary ???
  *   pack_???()     - pack data for MPI non-blocking send at ??? boundary
  *   unpack_???()   - unpack data for MPI non-blocking receive at ??? boundary
+ *   pack_cons()    - copies a row of conserved variables to the send buffer
+ *   unpack_cons()  - copies a row of conserved variables from the recv buffer
+ *   bvals26_ok()   - tests whether the split-phase exchange can be used
+ *   bvals26_init() - sets the datatypes and requests of the exchange
+ *   dir26()        - offset of the neighbour in one of the 26 directions
+ *   range26()      - index range exchanged with one neighbour
+ *   type26()       - datatype of the message to/from one neighbour
  *============================================================================*/
 
 static void reflect_ix1(GridS *pG);
@@ -153,8 +207,20 @@ static void unpack_ix2(GridS *pG);
 static void unpack_ox2(GridS *pG);
 static void unpack_ix3(GridS *pG);
 static void unpack_ox3(GridS *pG);
+
+static double *pack_cons(double *pSnd, const ConsS *pU, int n);
+static double *unpack_cons(double *pRcv, ConsS *pU, int n);
 #endif /* MPI_PARALLEL */
 
+#ifdef BVALS26
+static int  bvals26_ok(DomainS *pD);
+static void bvals26_init(DomainS *pD);
+static void dir26(int q, int a[3]);
+static void range26(GridS *pG, const int a[3], int face, int snd,
+                    int lo[3], int hi[3]);
+static MPI_Datatype type26(GridS *pG, int q, int snd);
+#endif /* BVALS26 */
+
 /*=========================== PUBLIC FUNCTIONS ===============================*/
 
 /*----------------------------------------------------------------------------*/
@@ -181,6 +247,11 @@ void bvals_mhd(DomainS *pD)
   int cnt, cnt2, cnt3, ierr, mIndex;
 #endif /* MPI_PARALLEL */
 
+#ifdef BVALS26
+/* complete a pending exchange, whose unpacking would overwrite the BCs */
+  if (pend26 != 0) bvals_mhd_finish(pD26);
+#endif
+
 /*--- Step 1. ------------------------------------------------------------------
  * Boundary Conditions in x1-direction */
 
@@ -505,6 +576,67 @@ void bvals_mhd(DomainS *pD)
   return;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn void bvals_mhd_start(DomainS *pD)
+ *  \brief Starts a split-phase exchange of the ghost zones, to be completed
+ *   by bvals_mhd_finish().
+ *
+ *   When every boundary of the Grid in each dimension with Nx>1 is either an
+ *   MPI boundary or periodic, the ghost zones (including the edges and
+ *   corners) are exchanged with all 26 (8 in 2D, 2 in 1D) neighbours in a
+ *   single round of non-blocking messages, and this function returns as soon
+ *   as they are started.  The regions exchanged are those set by the x1-x2-x3
+ *   sequence of bvals_mhd(), so the ghost zones are identical.  Otherwise
+ *   (physical or user BCs, shearing box, SMR, explicit diffusion or
+ *   operator-split cooling) it just calls bvals_mhd().  The persistent
+ *   requests are set up by bvals_mhd_init() for the Grid of the Domain on
+ *   this processor.
+ *
+ *   The active zones must not change, and the ghost zones must not be read,
+ *   until bvals_mhd_finish() is called.
+ */
+
+void bvals_mhd_start(DomainS *pD)
+{
+#ifdef BVALS26
+  int ierr;
+
+  if (pend26 != 0) bvals_mhd_finish(pD26);
+
+  if (pD != pD26) {
+    bvals_mhd(pD);
+    return;
+  }
+
+  ierr = MPI_Startall(2*nq26, rq26);
+  pend26 = 1;
+#else
+  bvals_mhd(pD);
+#endif /* BVALS26 */
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void bvals_mhd_finish(DomainS *pD)
+ *  \brief Completes the exchange started by bvals_mhd_start().  Does nothing
+ *   if none is pending.
+ */
+
+void bvals_mhd_finish(DomainS *pD)
+{
+#ifdef BVALS26
+  int ierr;
+
+  if (pend26 == 0 || pD != pD26) return;
+
+  ierr = MPI_Waitall(2*nq26, rq26, MPI_STATUSES_IGNORE);
+  pend26 = 0;
+#endif /* BVALS26 */
+
+  return;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \fn void bvals_mhd_init(MeshS *pM)
  *  \brief Sets function pointers for physical boundaries during
@@ -831,6 +963,12 @@ void bvals_mhd_init(MeshS *pM)
       }
     }
 
+#ifdef BVALS26
+/* Set up the split-phase exchange with the 26 neighbours, if possible */
+
+    if (pD26 == NULL && bvals26_ok(pD) == 1) bvals26_init(pD);
+#endif
+
 /* Figure out largest size needed for send/receive buffers with MPI ----------*/
 
 #ifdef MPI_PARALLEL
@@ -940,6 +1078,42 @@ void bvals_mhd_fun(DomainS *pD, enum BCDirection dir, VGFun_t prob_bc)
   return;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn void bvals_mhd_destruct(void)
+ *  \brief Frees the send/receive buffers, and the persistent requests and
+ *   datatypes of the split-phase exchange, with MPI.
+ */
+
+void bvals_mhd_destruct(void)
+{
+#ifdef MPI_PARALLEL
+#ifdef BVALS26
+  int n;
+
+  if (pD26 != NULL) {
+    bvals_mhd_finish(pD26);
+    for (n=0; n<nq26; n++) {
+      MPI_Request_free(&(rq26[n]));
+      MPI_Request_free(&(rq26[nq26+n]));
+      MPI_Type_free(&(type26_rcv[n]));
+      MPI_Type_free(&(type26_snd[n]));
+    }
+    nq26 = 0;
+    pD26 = NULL;
+  }
+#endif /* BVALS26 */
+
+  if (send_buf != NULL) free_2d_array(send_buf);
+  if (recv_buf != NULL) free_2d_array(recv_buf);
+  send_buf = recv_buf = NULL;
+  if (recv_rq != NULL) free_1d_array(recv_rq);
+  if (send_rq != NULL) free_1d_array(send_rq);
+  recv_rq = send_rq = NULL;
+#endif /* MPI_PARALLEL */
+
+  return;
+}
+
 /*=========================== PRIVATE FUNCTIONS ==============================*/
 /* Following are the functions:
  *   reflecting_???:   where ???=[ix1,ox1,ix2,ox2,ix3,ox3]
@@ -2307,7 +2481,7 @@ static void ProlongateLater(GridS *pGrid __attribute((unused)))
   return;
 }
 
-#ifdef MPI_PARALLEL  /* This ifdef wraps the next 12 funs; ~800 lines */
+#ifdef MPI_PARALLEL  /* This ifdef wraps the next 14 funs; ~800 lines */
 /*----------------------------------------------------------------------------*/
 /*! \fn static void pack_ix1(GridS *pG)
  *  \brief PACK boundary conditions for MPI_Isend, Inner x1 boundary */
@@ -2320,32 +2494,13 @@ static void pack_ix1(GridS *pG)
   int i,j,k;
 #ifdef MHD
   int ju, ku; /* j-upper, k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
 #endif
   double *pSnd;
   pSnd = (double*)&(send_buf[0][0]);
 
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
-      for (i=is; i<=is+(nghost-1); i++){
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
-#endif /* BAROTROPIC */
-#ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
-#endif
-      }
+      pSnd = pack_cons(pSnd, &(pG->U[k][j][is]), nghost);
     }
   }
 
@@ -2393,32 +2548,13 @@ static void pack_ox1(GridS *pG)
   int i,j,k;
 #ifdef MHD
   int ju, ku; /* j-upper, k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
 #endif
   double *pSnd;
   pSnd = (double*)&(send_buf[1][0]);
 
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
-      for (i=ie-(nghost-1); i<=ie; i++){
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
-#endif /* BAROTROPIC */
-#ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
-#endif
-      }
+      pSnd = pack_cons(pSnd, &(pG->U[k][j][ie-(nghost-1)]), nghost);
     }
   }
 
@@ -2465,32 +2601,13 @@ static void pack_ix2(GridS *pG)
   int i,j,k;
 #ifdef MHD
   int ku; /* k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
 #endif
   double *pSnd;
   pSnd = (double*)&(send_buf[0][0]);
 
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=js+(nghost-1); j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
-#endif /* BAROTROPIC */
-#ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
-#endif
-      }
+      pSnd = pack_cons(pSnd, &(pG->U[k][j][is-nghost]), ie-is+1+2*nghost);
     }
   }
 
@@ -2538,32 +2655,13 @@ static void pack_ox2(GridS *pG)
   int i,j,k;
 #ifdef MHD
   int ku; /* k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
 #endif
   double *pSnd;
   pSnd = (double*)&(send_buf[1][0]);
 
   for (k=ks; k<=ke; k++){
     for (j=je-(nghost-1); j<=je; j++){
-      for (i=is-nghost; i<=ie+nghost; i++){
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
-#endif /* BAROTROPIC */
-#ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
-#endif
-      }
+      pSnd = pack_cons(pSnd, &(pG->U[k][j][is-nghost]), ie-is+1+2*nghost);
     }
   }
 
@@ -2609,31 +2707,12 @@ static void pack_ix3(GridS *pG)
   int js = pG->js, je = pG->je;
   int ks = pG->ks, ke = pG->ke;
   int i,j,k;
-#if (NSCALARS > 0)
-  int n;
-#endif
   double *pSnd;
   pSnd = (double*)&(send_buf[0][0]);
 
   for (k=ks; k<=ks+(nghost-1); k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
-#endif /* BAROTROPIC */
-#ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
-#endif
-      }
+      pSnd = pack_cons(pSnd, &(pG->U[k][j][is-nghost]), ie-is+1+2*nghost);
     }
   }
 
@@ -2679,31 +2758,12 @@ static void pack_ox3(GridS *pG)
   int js = pG->js, je = pG->je;
   int ks = pG->ks, ke = pG->ke;
   int i,j,k;
-#if (NSCALARS > 0)
-  int n;
-#endif
   double *pSnd;
   pSnd = (double*)&(send_buf[1][0]);
 
   for (k=ke-(nghost-1); k<=ke; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
-#endif /* BAROTROPIC */
-#ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
-#endif
-      }
+      pSnd = pack_cons(pSnd, &(pG->U[k][j][is-nghost]), ie-is+1+2*nghost);
     }
   }
 
@@ -2751,32 +2811,13 @@ static void unpack_ix1(GridS *pG)
   int i,j,k;
 #ifdef MHD
   int ju, ku; /* j-upper, k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
 #endif
   double *pRcv;
   pRcv = (double*)&(recv_buf[0][0]);
 
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
-      for (i=is-nghost; i<=is-1; i++){
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
-#ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
-#endif /* BAROTROPIC */
-#ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
-#endif
-      }
+      pRcv = unpack_cons(pRcv, &(pG->U[k][j][is-nghost]), nghost);
     }
   }
 
@@ -2824,32 +2865,13 @@ static void unpack_ox1(GridS *pG)
   int i,j,k;
 #ifdef MHD
   int ju, ku; /* j-upper, k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
 #endif
   double *pRcv;
   pRcv = (double*)&(recv_buf[1][0]);
 
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
-      for (i=ie+1; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
-#ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
-#endif /* BAROTROPIC */
-#ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
-#endif
-      }
+      pRcv = unpack_cons(pRcv, &(pG->U[k][j][ie+1]), nghost);
     }
   }
 
@@ -2897,32 +2919,13 @@ static void unpack_ix2(GridS *pG)
   int i,j,k;
 #ifdef MHD
   int ku; /* k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
 #endif
   double *pRcv;
   pRcv = (double*)&(recv_buf[0][0]);
 
   for (k=ks; k<=ke; k++) {
     for (j=js-nghost; j<=js-1; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
-#ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
-#endif /* BAROTROPIC */
-#ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
-#endif
-      }
+      pRcv = unpack_cons(pRcv, &(pG->U[k][j][is-nghost]), ie-is+1+2*nghost);
     }
   }
 
@@ -2970,32 +2973,13 @@ static void unpack_ox2(GridS *pG)
   int i,j,k;
 #ifdef MHD
   int ku; /* k-upper */
-#endif
-#if (NSCALARS > 0)
-  int n;
 #endif
   double *pRcv;
   pRcv = (double*)&(recv_buf[1][0]);
 
   for (k=ks; k<=ke; k++) {
     for (j=je+1; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
-#ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
-#endif /* BAROTROPIC */
-#ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
-#endif
-      }
+      pRcv = unpack_cons(pRcv, &(pG->U[k][j][is-nghost]), ie-is+1+2*nghost);
     }
   }
 
@@ -3041,31 +3025,12 @@ static void unpack_ix3(GridS *pG)
   int js = pG->js, je = pG->je;
   int ks = pG->ks;
   int i,j,k;
-#if (NSCALARS > 0)
-  int n;
-#endif
   double *pRcv;
   pRcv = (double*)&(recv_buf[0][0]);
 
   for (k=ks-nghost; k<=ks-1; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
-#ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
-#endif /* BAROTROPIC */
-#ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
-#endif
-      }
+      pRcv = unpack_cons(pRcv, &(pG->U[k][j][is-nghost]), ie-is+1+2*nghost);
     }
   }
 
@@ -3111,31 +3076,12 @@ static void unpack_ox3(GridS *pG)
   int js = pG->js, je = pG->je;
   int ke = pG->ke;
   int i,j,k;
-#if (NSCALARS > 0)
-  int n;
-#endif
   double *pRcv;
   pRcv = (double*)&(recv_buf[1][0]);
 
   for (k=ke+1; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
-#ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
-#endif /* BAROTROPIC */
-#ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
-#endif /* MHD */
-#if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
-#endif
-      }
+      pRcv = unpack_cons(pRcv, &(pG->U[k][j][is-nghost]), ie-is+1+2*nghost);
     }
   }
 
@@ -3170,4 +3116,261 @@ static void unpack_ox3(GridS *pG)
 
   return;
 }
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static double *pack_cons(double *pSnd, const ConsS *pU, int n)
+ *  \brief Copies the conserved variables of the n cells pU[0..n-1] to the
+ *   send buffer at pSnd, and returns the position after them */
+
+static double *pack_cons(double *pSnd, const ConsS *pU, int n)
+{
+#ifndef CYLINDRICAL
+  memcpy(pSnd, pU, n*sizeof(ConsS));
+  pSnd += n*(NVAR);
+#else
+  int i;
+#if (NSCALARS > 0)
+  int m;
+#endif
+
+  for (i=0; i<n; i++){
+    *(pSnd++) = pU[i].d;
+    *(pSnd++) = pU[i].M1;
+    *(pSnd++) = pU[i].M2;
+    *(pSnd++) = pU[i].M3;
+#ifndef BAROTROPIC
+    *(pSnd++) = pU[i].E;
+#endif /* BAROTROPIC */
+#ifdef MHD
+    *(pSnd++) = pU[i].B1c;
+    *(pSnd++) = pU[i].B2c;
+    *(pSnd++) = pU[i].B3c;
+#endif /* MHD */
+#if (NSCALARS > 0)
+    for (m=0; m<NSCALARS; m++) *(pSnd++) = pU[i].s[m];
+#endif
+  }
+#endif /* CYLINDRICAL */
+
+  return pSnd;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static double *unpack_cons(double *pRcv, ConsS *pU, int n)
+ *  \brief Copies the conserved variables of the n cells pU[0..n-1] from the
+ *   receive buffer at pRcv, and returns the position after them */
+
+static double *unpack_cons(double *pRcv, ConsS *pU, int n)
+{
+#ifndef CYLINDRICAL
+  memcpy(pU, pRcv, n*sizeof(ConsS));
+  pRcv += n*(NVAR);
+#else
+  int i;
+#if (NSCALARS > 0)
+  int m;
+#endif
+
+  for (i=0; i<n; i++){
+    pU[i].d  = *(pRcv++);
+    pU[i].M1 = *(pRcv++);
+    pU[i].M2 = *(pRcv++);
+    pU[i].M3 = *(pRcv++);
+#ifndef BAROTROPIC
+    pU[i].E  = *(pRcv++);
+#endif /* BAROTROPIC */
+#ifdef MHD
+    pU[i].B1c = *(pRcv++);
+    pU[i].B2c = *(pRcv++);
+    pU[i].B3c = *(pRcv++);
+#endif /* MHD */
+#if (NSCALARS > 0)
+    for (m=0; m<NSCALARS; m++) pU[i].s[m] = *(pRcv++);
+#endif
+  }
+#endif /* CYLINDRICAL */
+
+  return pRcv;
+}
+
+#ifdef BVALS26
+/*----------------------------------------------------------------------------*/
+/*! \fn static int bvals26_ok(DomainS *pD)
+ *  \brief Returns 1 if every boundary of the Grid in the dimensions with Nx>1
+ *   is an MPI boundary or periodic (and Nx>=nghost), so that all its ghost
+ *   zones are copies of active zones of the neighbouring Grids */
+
+static int bvals26_ok(DomainS *pD)
+{
+  GridS *pG = pD->Grid;
+
+  if (pG->Nx[0] > 1) {
+    if (pG->Nx[0] < nghost) return 0;
+    if (pG->lx1_id < 0 && pD->ix1_BCFun != periodic_ix1) return 0;
+    if (pG->rx1_id < 0 && pD->ox1_BCFun != periodic_ox1) return 0;
+  }
+  if (pG->Nx[1] > 1) {
+    if (pG->Nx[1] < nghost) return 0;
+    if (pG->lx2_id < 0 && pD->ix2_BCFun != periodic_ix2) return 0;
+    if (pG->rx2_id < 0 && pD->ox2_BCFun != periodic_ox2) return 0;
+  }
+  if (pG->Nx[2] > 1) {
+    if (pG->Nx[2] < nghost) return 0;
+    if (pG->lx3_id < 0 && pD->ix3_BCFun != periodic_ix3) return 0;
+    if (pG->rx3_id < 0 && pD->ox3_BCFun != periodic_ox3) return 0;
+  }
+
+  return 1;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void bvals26_init(DomainS *pD)
+ *  \brief Sets the IDs of the neighbours of the Grid in all directions (with
+ *   periodic wrap), the datatypes of the messages to/from each, and the
+ *   persistent requests for them */
+
+static void bvals26_init(DomainS *pD)
+{
+  GridS *pG = pD->Grid;
+  int a[3],myL,myM,myN,l,m,n,q,nb,ierr;
+
+  get_myGridIndex(pD, myID_Comm_world, &myL, &myM, &myN);
+
+  nq26 = 0;
+  for (q=0; q<27; q++) {
+    dir26(q,a);
+    if (q == 13) continue;
+    if ((a[0] != 0 && pG->Nx[0] == 1) || (a[1] != 0 && pG->Nx[1] == 1) ||
+        (a[2] != 0 && pG->Nx[2] == 1)) continue;
+
+    l = (myL + a[0] + pD->NGrid[0]) % pD->NGrid[0];
+    m = (myM + a[1] + pD->NGrid[1]) % pD->NGrid[1];
+    n = (myN + a[2] + pD->NGrid[2]) % pD->NGrid[2];
+    nb = pD->GData[n][m][l].ID_Comm_Domain;
+
+/* The message from the neighbour at offset a is tagged with q, and that to
+ * it with 26-q, the direction of this Grid seen from the neighbour */
+    type26_rcv[nq26] = type26(pG,q,0);
+    type26_snd[nq26] = type26(pG,q,1);
+    ierr = MPI_Recv_init(MPI_BOTTOM,1,type26_rcv[nq26],nb,bvals26_tag+q,
+      pD->Comm_Domain, &(rq26[nq26]));
+    ierr = MPI_Send_init(MPI_BOTTOM,1,type26_snd[nq26],nb,bvals26_tag+26-q,
+      pD->Comm_Domain, &(rq26[26+nq26]));
+    nq26++;
+  }
+
+/* Move the sends after the receives, so all can be started at once */
+  for (n=0; n<nq26; n++) rq26[nq26+n] = rq26[26+n];
+
+  pD26 = pD;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void dir26(int q, int a[3])
+ *  \brief Offset (-1, 0 or 1 in x1, x2, x3) of the neighbour in direction
+ *   q = (a1+1) + 3*(a2+1) + 9*(a3+1); the opposite direction is 26-q */
+
+static void dir26(int q, int a[3])
+{
+  a[0] = q%3 - 1;
+  a[1] = (q/3)%3 - 1;
+  a[2] = q/9 - 1;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void range26(GridS *pG, const int a[3], int face, int snd,
+ *                          int lo[3], int hi[3])
+ *  \brief Index range of the region exchanged with the neighbour at offset
+ *   a: the active zones sent to it (snd=1), or the ghost zones received from
+ *   it (snd=0).  face=0,1,2 for B1i,B2i,B3i, which are exchanged as in
+ *   bvals_mhd(): not at the face i=is-nghost (or ie+1 from the neighbour on
+ *   the right, which is set by this Grid), and face=-1 for U */
+
+static void range26(GridS *pG, const int a[3], int face, int snd,
+                    int lo[3], int hi[3])
+{
+  int d,f,s,e;
+
+  for (d=0; d<3; d++) {
+    s = (d == 0) ? pG->is : ((d == 1) ? pG->js : pG->ks);
+    e = (d == 0) ? pG->ie : ((d == 1) ? pG->je : pG->ke);
+    f = (face == d) ? 1 : 0;
+
+    if (a[d] == 0) {
+      lo[d] = s;
+      hi[d] = (f == 1 && pG->Nx[d] > 1) ? e+1 : e;
+    } else if (snd == 1) {
+      lo[d] = (a[d] < 0) ? s + f : e - nghost + 1 + f;
+      hi[d] = (a[d] < 0) ? s + nghost - 1 : e;
+    } else {
+      lo[d] = (a[d] < 0) ? s - nghost + f : e + 1 + f;
+      hi[d] = (a[d] < 0) ? s - 1 : e + nghost;
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static MPI_Datatype type26(GridS *pG, int q, int snd)
+ *  \brief Datatype of the active zones sent to (snd=1), or of the ghost zones
+ *   received from (snd=0), the neighbour in direction q: the subarrays of U,
+ *   B1i, B2i and B3i at their absolute addresses (to be used with
+ *   MPI_BOTTOM).  Of each ConsS only the NVAR variables are exchanged. */
+
+static MPI_Datatype type26(GridS *pG, int q, int snd)
+{
+  MPI_Datatype cons, cons1, sub[4], type;
+  MPI_Aint disp[4];
+  int blen[4] = {1, 1, 1, 1};
+  int a[3],lo[3],hi[3],size[3],subsize[3],start[3],d,nf=1,ierr;
+#ifdef MHD
+  int f;
+#endif
+
+  dir26(q,a);
+  for (d=0; d<3; d++) size[2-d] = (pG->Nx[d] > 1) ? pG->Nx[d] + 2*nghost : 1;
+
+  ierr = MPI_Type_contiguous(NVAR, MPI_DOUBLE, &cons1);
+  ierr = MPI_Type_create_resized(cons1, 0, (MPI_Aint)sizeof(ConsS), &cons);
+
+  range26(pG,a,-1,snd,lo,hi);
+  for (d=0; d<3; d++) {
+    subsize[2-d] = hi[d] - lo[d] + 1;
+    start[2-d] = lo[d];
+  }
+  ierr = MPI_Type_create_subarray(3,size,subsize,start,MPI_ORDER_C,cons,
+    &(sub[0]));
+  ierr = MPI_Get_address(&(pG->U[0][0][0]), &(disp[0]));
+
+#ifdef MHD
+  for (f=0; f<3; f++) {
+    range26(pG,a,f,snd,lo,hi);
+    for (d=0; d<3; d++) {
+      subsize[2-d] = hi[d] - lo[d] + 1;
+      start[2-d] = lo[d];
+    }
+    ierr = MPI_Type_create_subarray(3,size,subsize,start,MPI_ORDER_C,
+      MPI_DOUBLE, &(sub[f+1]));
+  }
+  ierr = MPI_Get_address(&(pG->B1i[0][0][0]), &(disp[1]));
+  ierr = MPI_Get_address(&(pG->B2i[0][0][0]), &(disp[2]));
+  ierr = MPI_Get_address(&(pG->B3i[0][0][0]), &(disp[3]));
+  nf = 4;
+#endif /* MHD */
+
+  ierr = MPI_Type_create_struct(nf, blen, disp, sub, &type);
+  ierr = MPI_Type_commit(&type);
+
+  for (d=0; d<nf; d++) MPI_Type_free(&(sub[d]));
+  MPI_Type_free(&cons);
+  MPI_Type_free(&cons1);
+
+  return type;
+}
+#endif /* BVALS26 */
 #endif /* MPI_PARALLEL */
@@ -10,6 +10,7 @@
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - Cons_to_Prim()     - converts Cons type to Prim type
+ * - Cons_to_Prim_pencil() - converts a row of cells il..iu
  * - Cons1D_to_Prim1D() - converts 1D vector (Bx passed through arguments)
  * - Prim1D_to_Cons1D() - converts 1D vector (Bx passed through arguments)
  * - cfast()            - computes fast magnetosonic speed
@@ -17,7 +18,11 @@
  * For special relativity, there are two versions of the Cons1D_to_Prim1D
  * functions, one for HYDRO and one for MHD. There is also a 'check_Prim'
  * and 'check_Prim1D' routine for SRMHD which returns a primitve state
- * without verifying physical status.
+ * without verifying physical status.  For SRMHD, Cons_to_Prim_pencil() and
+ * check_Prim_pencil() iterate the Newton-Raphson inversion of all the cells
+ * of a row together, optionally starting from a guess for the primitives
+ * (e.g. those of the previous step), and fall back on the cell-by-cell
+ * functions for the cells which do not converge.
  *
  * REFERENCE:
  *   S. Noble et al., "Primitive Variable Solvers for Conservative General
@@ -87,8 +92,23 @@ void FUNV2(const Real d, const Real v2,
 	   const Real p, const Real Bsq, const Real Msq, const Real Ssq,
 	   Real *W, Real *f);
 
+/*! \fn static void newton_pencil(const int n, const ConsS *pU,
+ *                    const PrimS *pWg, const int max_iter, Real *Q, int *st,
+ *                    int *warm)
+ *  \brief Newton-Raphson iteration for Q of n cells together */
+static void newton_pencil(const int n, const ConsS *pU, const PrimS *pWg,
+                          const int max_iter, Real *Q, int *st, int *warm);
+
+/*! \fn static void prim_pencil(const ConsS *pU, const Real Q, Real *Vsq,
+ *                               PrimS *pW)
+ *  \brief Primitives of one cell from the converged Q */
+static void prim_pencil(const ConsS *pU, const Real Q, Real *Vsq, PrimS *pW);
+
 /* Parameter controlling accuracy of inversion scheme for SRMHD*/
 static Real tol=1.0e-10;
+
+/* Number of cells iterated together by the pencil inversions */
+#define NPENCIL 64
 #endif /* SPECIAL_RELATIVITY && MHD */
 
 
@@ -203,6 +223,24 @@ ConsS Prim_to_Cons (const PrimS *pW)
   return Cons;
 }
 
+#if !(defined(SPECIAL_RELATIVITY) && defined(MHD))
+/*----------------------------------------------------------------------------*/
+/*! \fn void Cons_to_Prim_pencil(const int il, const int iu, const ConsS *pU,
+ *                               PrimS *pW, const PrimS *pWg)
+ *  \brief Converts the cells il..iu of a row with Cons_to_Prim().  The guess
+ *   pWg is only used by the SRMHD version, and is ignored here.
+ */
+void Cons_to_Prim_pencil(const int il, const int iu, const ConsS *pU,
+                         PrimS *pW, const PrimS *pWg)
+{
+  int i;
+
+  for (i=il; i<=iu; i++) pW[i] = Cons_to_Prim(&(pU[i]));
+
+  return;
+}
+#endif /* not (SPECIAL_RELATIVITY && MHD) */
+
 #ifdef SPECIAL_RELATIVITY /* special relativity only */
 #ifdef MHD /* MHD only */
 /*----------------------------------------------------------------------------*/
@@ -374,6 +412,24 @@ PrimS check_Prim(const ConsS *pCons)
 
   return Prim;
 }
+
+#ifndef MHD
+/*----------------------------------------------------------------------------*/
+/*! \fn void check_Prim_pencil(const int il, const int iu, const ConsS *pU,
+ *                             PrimS *pW, const PrimS *pWg)
+ *  \brief Converts the cells il..iu of a row with check_Prim().  The guess
+ *   pWg is only used by the SRMHD version, and is ignored here.
+ */
+void check_Prim_pencil(const int il, const int iu, const ConsS *pU,
+                       PrimS *pW, const PrimS *pWg)
+{
+  int i;
+
+  for (i=il; i<=iu; i++) pW[i] = check_Prim(&(pU[i]));
+
+  return;
+}
+#endif /* MHD */
 #endif /* SPECIAL_RELATIVITY && MHD */
 
 #ifndef SPECIAL_RELATIVITY /* Following versions for Newtonian dynamics */
@@ -765,8 +821,8 @@ Prim1DS Cons1D_to_Prim1D(const Cons1DS *U, const Real *Bx)
 
     tmp1 = 1.0 / Q;
     tmp2 = 1.0 / (Q + Bsq);
-    Prim1D.d = MAX(rho,1.0e-4);
-    Prim1D.P = MAX(pgas,1.0e-5);
+    Prim1D.d = MAX(rho,SR_DENSITY_FLOOR);
+    Prim1D.P = MAX(pgas,SR_PRESSURE_FLOOR);
     Prim1D.Vx = (U->Mx + S*(*Bx)*tmp1)*tmp2;
     Prim1D.Vy = (U->My + S*U->By*tmp1)*tmp2;
     Prim1D.Vz = (U->Mz + S*U->Bz*tmp1)*tmp2;
@@ -794,8 +850,8 @@ Prim1DS Cons1D_to_Prim1D(const Cons1DS *U, const Real *Bx)
     rho = d / sqrt(fabs(Gsq));
     pgas = Gamma_1*Chi/Gamma;
 
-    Prim1D.d = MAX(rho,1.0e-4);
-    Prim1D.P = MAX(pgas,1.0e-5);
+    Prim1D.d = MAX(rho,SR_DENSITY_FLOOR);
+    Prim1D.P = MAX(pgas,SR_PRESSURE_FLOOR);
     Prim1D.By = U->By;
     Prim1D.Bz = U->Bz;
 
@@ -813,8 +869,8 @@ Prim1DS Cons1D_to_Prim1D(const Cons1DS *U, const Real *Bx)
     /* It worked!!! Should have a valid solution, so now set up primitives */
     tmp1 = 1.0 / Q;
     tmp2 = 1.0 / (Q + Bsq);
-    Prim1D.d = MAX(rho,1.0e-4);
-    Prim1D.P = MAX(pgas,1.0e-5);
+    Prim1D.d = MAX(rho,SR_DENSITY_FLOOR);
+    Prim1D.P = MAX(pgas,SR_PRESSURE_FLOOR);
     Prim1D.Vx = (U->Mx + S*(*Bx)*tmp1)*tmp2;
     Prim1D.Vy = (U->My + S*U->By*tmp1)*tmp2;
     Prim1D.Vz = (U->Mz + S*U->Bz*tmp1)*tmp2;
@@ -979,6 +1035,92 @@ Prim1DS check_Prim1D (const Cons1DS *U, const Real *Bx)
 	  
   return Prim1D;
 }
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void Cons_to_Prim_pencil(const int il, const int iu, const ConsS *pU,
+ *                               PrimS *pW, const PrimS *pWg)
+ *  \brief Cons_to_Prim() of the cells il..iu of a row: SPECIAL RELATIVISTIC
+ *   MHD VERSION
+ *
+ * The Newton-Raphson iteration of Cons1D_to_Prim1D() is carried out for
+ * NPENCIL cells at a time, masking the cells which have converged.  Without a
+ * guess (pWg = NULL) every cell starts from the root of Eqn. A27, and the
+ * result is identical to that of Cons_to_Prim().  Otherwise the iteration
+ * starts from Q = rho*h*gamma^2 of the physical cells of pWg (which may be pW
+ * itself), e.g. the primitives of the previous (half) step.  Since the
+ * iteration converges quadratically, this only saves an iteration if the
+ * state changes very little over the step.  Cells that do not converge to a
+ * physical state are done again by Cons_to_Prim(), from the usual guess.
+ */
+void Cons_to_Prim_pencil(const int il, const int iu, const ConsS *pU,
+                         PrimS *pW, const PrimS *pWg)
+{
+  Real Q[NPENCIL], Vsq;
+  int st[NPENCIL], warm[NPENCIL];
+  int i, m, n;
+  PrimS Prim;
+
+  for (i=il; i<=iu; i+=NPENCIL) {
+    n = MIN(NPENCIL, iu-i+1);
+    newton_pencil(n, &(pU[i]), (pWg == NULL ? NULL : &(pWg[i])), 100000,
+                  Q, st, warm);
+
+    for (m=0; m<n; m++) {
+      if (st[m] == 1) {
+        prim_pencil(&(pU[i+m]), Q[m], &Vsq, &Prim);
+        if (Prim.P >= 0.0 && Vsq <= 1.0 && Vsq >= 0.0) {
+          Prim.d = MAX(Prim.d,SR_DENSITY_FLOOR);
+          Prim.P = MAX(Prim.P,SR_PRESSURE_FLOOR);
+          pW[i+m] = Prim;
+          continue;
+        }
+      }
+      pW[i+m] = Cons_to_Prim(&(pU[i+m]));
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void check_Prim_pencil(const int il, const int iu, const ConsS *pU,
+ *                             PrimS *pW, const PrimS *pWg)
+ *  \brief check_Prim() of the cells il..iu of a row: SPECIAL RELATIVISTIC
+ *   MHD VERSION
+ *
+ * As Cons_to_Prim_pencil(), but with the iteration limit of check_Prim1D()
+ * and without floors, so that unphysical cells are returned to the caller
+ * (d = -1 if the iteration fails).  With a guess pWg, cells which converge to
+ * an unphysical state are done again by check_Prim() before being returned.
+ */
+void check_Prim_pencil(const int il, const int iu, const ConsS *pU,
+                       PrimS *pW, const PrimS *pWg)
+{
+  Real Q[NPENCIL], Vsq;
+  int st[NPENCIL], warm[NPENCIL];
+  int i, m, n;
+  PrimS Prim;
+
+  for (i=il; i<=iu; i+=NPENCIL) {
+    n = MIN(NPENCIL, iu-i+1);
+    newton_pencil(n, &(pU[i]), (pWg == NULL ? NULL : &(pWg[i])), 1000,
+                  Q, st, warm);
+
+    for (m=0; m<n; m++) {
+      if (st[m] == 1) {
+        prim_pencil(&(pU[i+m]), Q[m], &Vsq, &Prim);
+        if (warm[m] == 0 ||
+            (Prim.d > 0.0 && Prim.P > 0.0 && Vsq < 1.0 && Vsq >= 0.0)) {
+          pW[i+m] = Prim;
+          continue;
+        }
+      }
+      pW[i+m] = check_Prim(&(pU[i+m]));
+    }
+  }
+
+  return;
+}
 #endif /* SPECIAL_RELATIVITY && MHD */
 
 #ifdef SPECIAL_RELATIVITY /* special relativity only */
@@ -1342,4 +1484,157 @@ void FUNV2(const Real d, const Real v2,
   *f /= ((*W) + Bsq)*((*W) + Bsq)*W2;
   *f -= v2;
 }
+
+/*! \fn static void newton_pencil(const int n, const ConsS *pU,
+ *                    const PrimS *pWg, const int max_iter, Real *Q, int *st,
+ *                    int *warm)
+ *  \brief Newton-Raphson iteration for Q of n cells together
+ *
+ * The arithmetic is that of Cons1D_to_Prim1D(), applied to all the cells on
+ * each pass, with the update only kept for the cells still iterating.  On
+ * return st[m] = 1 if cell m converged, -1 if it produced a NaN and 0 if it
+ * reached max_iter, and warm[m] = 1 if it started from the guess pWg.
+ */
+static void newton_pencil(const int n, const ConsS *pU, const PrimS *pWg,
+                          const int max_iter, Real *Q, int *st, int *warm)
+{
+  Real Bsq[NPENCIL], Msq[NPENCIL], Ssq[NPENCIL], E[NPENCIL], d[NPENCIL];
+  Real dQ[NPENCIL];
+  Real S, scrh1, scrh2, Qw, vsq, Vsq, Gsq, Chi, pgas, fQ, dfQ, dQstep, Qn;
+  int m, it, nact, bad, act, stn;
+
+  Gamma_1overGamma = Gamma_1/Gamma;
+
+  for (m=0; m<n; m++) {
+    Bsq[m] = SQR(pU[m].B1c) + SQR(pU[m].B2c) + SQR(pU[m].B3c);
+    Msq[m] = SQR(pU[m].M1) + SQR(pU[m].M2) + SQR(pU[m].M3);
+    S = pU[m].M1 * pU[m].B1c + pU[m].M2 * pU[m].B2c + pU[m].M3 * pU[m].B3c;
+    Ssq[m] = SQR(S);
+    E[m] = pU[m].E;
+    d[m] = pU[m].d;
+
+    /* Starting guess from Eqn. A27, as in Cons1D_to_Prim1D() */
+    scrh1 = -4.0*(E[m] - Bsq[m]);
+    scrh2 = Msq[m] - 2.0*E[m]*Bsq[m] + Bsq[m]*Bsq[m];
+    Q[m] = ( - scrh1 + sqrt(fabs(scrh1*scrh1 - 12.0*scrh2)))/6.0;
+
+    st[m] = 0;
+    if (Q[m] < 0.0) {
+      Q[m] = d[m];
+    } else if (Q[m] != Q[m]) {
+      st[m] = -1;
+    }
+    dQ[m] = 1.0;
+
+    /* or from Q = rho*h*gamma^2 of the guess, if it is physical */
+    warm[m] = 0;
+    if (pWg != NULL) {
+      vsq = SQR(pWg[m].V1) + SQR(pWg[m].V2) + SQR(pWg[m].V3);
+      if (pWg[m].d > 0.0 && pWg[m].P > 0.0 && vsq < 1.0) {
+        Qw = (pWg[m].d + Gamma/Gamma_1*pWg[m].P)/(1.0 - vsq);
+        if (Qw < HUGE_NUMBER) {
+          Q[m] = Qw;
+          st[m] = 0;
+          warm[m] = 1;
+        }
+      }
+    }
+  }
+
+  /* First iteration, with the overshoot guard of Cons1D_to_Prim1D() for the
+   * cells starting from the usual guess */
+  nact = 0;
+  for (m=0; m<n; m++) {
+    if (st[m] != 0) continue;
+
+    Vsq = calc_vsq (Bsq[m],Msq[m],Ssq[m],Q[m]);
+    Gsq = 1.0/(1.0-Vsq);
+    Chi = calc_chi (d[m],Vsq,Gsq,Q[m]);
+    pgas = Gamma_1*Chi/Gamma;
+
+    fQ = calc_func (Q[m], E[m], Bsq[m], Ssq[m], Vsq, pgas);
+    dfQ = calc_dfunc (Q[m], Bsq[m], Msq[m], Ssq[m], d[m], Vsq, Gsq, Chi);
+    bad = (fQ != fQ) || (dfQ != dfQ);
+
+    if (fabs(fQ) < 0.1 && warm[m] == 0) {
+      Q[m] *= 10;
+      Vsq = calc_vsq (Bsq[m],Msq[m],Ssq[m],Q[m]);
+      Gsq = 1.0/(1.0-Vsq);
+      Chi = calc_chi (d[m],Vsq,Gsq,Q[m]);
+      pgas = Gamma_1*Chi/Gamma;
+
+      fQ = calc_func (Q[m], E[m], Bsq[m], Ssq[m], Vsq, pgas);
+      dfQ = calc_dfunc (Q[m], Bsq[m], Msq[m], Ssq[m], d[m], Vsq, Gsq, Chi);
+    }
+
+    dQ[m] = fQ / dfQ;
+    Q[m] -= dQ[m];
+    bad = bad || (dQ[m] != dQ[m]) || (Q[m] != Q[m]);
+    st[m] = bad ? -1 : 0;
+    nact += (st[m] == 0);
+  }
+
+  /* Further iterations of all the cells, without branches, keeping the
+   * update only for the cells still iterating (the iterations of the cells
+   * are independent, and overlap in the pipeline).  The
+   * convergence test uses the step of the previous iteration, and the
+   * converged cell takes one more step, as in Cons1D_to_Prim1D() */
+  for (it=1; it<max_iter && nact > 0; it++) {
+    nact = 0;
+    for (m=0; m<n; m++) {
+      Vsq = calc_vsq (Bsq[m],Msq[m],Ssq[m],Q[m]);
+      Gsq = 1.0/(1.0-Vsq);
+      Chi = calc_chi (d[m],Vsq,Gsq,Q[m]);
+      pgas = Gamma_1*Chi/Gamma;
+
+      fQ = calc_func (Q[m], E[m], Bsq[m], Ssq[m], Vsq, pgas);
+      dfQ = calc_dfunc (Q[m], Bsq[m], Msq[m], Ssq[m], d[m], Vsq, Gsq, Chi);
+      dQstep = fQ / dfQ;
+      Qn = Q[m] - dQstep;
+      bad = (fQ != fQ) | (dfQ != dfQ) | (dQstep != dQstep) | (Qn != Qn);
+
+      act = (st[m] == 0);
+      stn = bad ? -1 : (fabs(dQ[m]) <= tol);
+      st[m] = act ? stn : st[m];
+      Q[m] = act ? Qn : Q[m];
+      dQ[m] = act ? dQstep : dQ[m];
+      nact += (st[m] == 0);
+    }
+  }
+
+  return;
+}
+
+/*! \fn static void prim_pencil(const ConsS *pU, const Real Q, Real *Vsq,
+ *                               PrimS *pW)
+ *  \brief Primitives of one cell from the converged Q, without floors, as
+ *   returned by check_Prim1D() */
+static void prim_pencil(const ConsS *pU, const Real Q, Real *Vsq, PrimS *pW)
+{
+  Real Bsq, Msq, S, Ssq, d, Gsq, Chi, tmp1, tmp2;
+
+  Bsq = SQR(pU->B1c) + SQR(pU->B2c) + SQR(pU->B3c);
+  Msq = SQR(pU->M1) + SQR(pU->M2) + SQR(pU->M3);
+  S = pU->M1 * pU->B1c + pU->M2 * pU->B2c + pU->M3 * pU->B3c;
+  Ssq = SQR(S);
+  d = pU->d;
+
+  *Vsq = calc_vsq (Bsq,Msq,Ssq,Q);
+  Gsq = 1.0/(1.0-(*Vsq));
+  Chi = calc_chi (d,*Vsq,Gsq,Q);
+
+  tmp1 = 1.0 / Q;
+  tmp2 = 1.0 / (Q + Bsq);
+  pW->d = d / sqrt(fabs(Gsq));
+  pW->P = Gamma_1*Chi/Gamma;
+  pW->V1 = (pU->M1 + S*pU->B1c*tmp1)*tmp2;
+  pW->V2 = (pU->M2 + S*pU->B2c*tmp1)*tmp2;
+  pW->V3 = (pU->M3 + S*pU->B3c*tmp1)*tmp2;
+
+  pW->B1c = pU->B1c;
+  pW->B2c = pU->B2c;
+  pW->B3c = pU->B3c;
+
+  return;
+}
 #endif /* SPECIAL_RELATIVITY && MHD */
@@ -40,6 +40,20 @@ void dump_binary(MeshS *pM, OutputS *pOut)
   Real dat[2],*datax,*datay,*dataz;
   Real *pData,x1,x2,x3;
   int coordsys = -1;
+#ifdef PARTICLES
+  int ipar[4] = {-1,-1,-1,-1}; /* index in Mom of dpar, M1par..M3par */
+
+/* Binned particle moments, see particle_moments() */
+
+  if (pOut->out_pargrid) {
+    ipar[0] = particle_moment_index(pOut->par_prop, -1, mom_d);
+    ipar[1] = particle_moment_index(pOut->par_prop, -1, mom_M1);
+    ipar[2] = particle_moment_index(pOut->par_prop, -1, mom_M2);
+    ipar[3] = particle_moment_index(pOut->par_prop, -1, mom_M3);
+    if (ipar[0] < 0)
+      ath_error("[dump_binary]: Particles of this output not binned\n");
+  }
+#endif
 
 /* Loop over all Domains in Mesh, and output Grid data */
 
@@ -224,34 +238,14 @@ void dump_binary(MeshS *pM, OutputS *pOut)
 
 #ifdef PARTICLES
         if (pOut->out_pargrid) {
+          for (n=0; n<4; n++) {
           for (k=0; k<ndata[2]; k++) {
           for (j=0; j<ndata[1]; j++) {
             for (i=0; i<ndata[0]; i++) {
-              datax[i] = pGrid->Coup[k+kl][j+jl][i+il].grid_d;
+              datax[i] = pGrid->Mom[ipar[n]][k+kl][j+jl][i+il];
             }
             fwrite(datax,sizeof(Real),(size_t)ndata[0],p_binfile);
-          }}
-          for (k=0; k<ndata[2]; k++) {
-          for (j=0; j<ndata[1]; j++) {
-            for (i=0; i<ndata[0]; i++) {
-              datax[i] = pGrid->Coup[k+kl][j+jl][i+il].grid_v1;
-            }
-            fwrite(datax,sizeof(Real),(size_t)ndata[0],p_binfile);
-          }}
-          for (k=0; k<ndata[2]; k++) {
-          for (j=0; j<ndata[1]; j++) {
-            for (i=0; i<ndata[0]; i++) {
-              datax[i] = pGrid->Coup[k+kl][j+jl][i+il].grid_v2;
-            }
-            fwrite(datax,sizeof(Real),(size_t)ndata[0],p_binfile);
-          }}
-          for (k=0; k<ndata[2]; k++) {
-          for (j=0; j<ndata[1]; j++) {
-            for (i=0; i<ndata[0]; i++) {
-              datax[i] = pGrid->Coup[k+kl][j+jl][i+il].grid_v3;
-            }
-            fwrite(datax,sizeof(Real),(size_t)ndata[0],p_binfile);
-          }}
+          }}}
         }
 #endif
 
@@ -47,6 +47,20 @@ void dump_tab_cons(MeshS *pM, OutputS *pOut)
 #if (NSCALARS > 0)
   int n;
 #endif
+#ifdef PARTICLES
+  int ipar[4] = {-1,-1,-1,-1}; /* index in Mom of dpar, M1par..M3par */
+
+/* Binned particle moments, see particle_moments() */
+
+  if (pOut->out_pargrid) {
+    ipar[0] = particle_moment_index(pOut->par_prop, -1, mom_d);
+    ipar[1] = particle_moment_index(pOut->par_prop, -1, mom_M1);
+    ipar[2] = particle_moment_index(pOut->par_prop, -1, mom_M2);
+    ipar[3] = particle_moment_index(pOut->par_prop, -1, mom_M3);
+    if (ipar[0] < 0)
+      ath_error("[dump_tab_cons]: Particles of this output not binned\n");
+  }
+#endif
 
 /* Add a white space to the format, setup format for integer zone columns */
   if(pOut->dat_fmt == NULL){
@@ -252,10 +266,10 @@ void dump_tab_cons(MeshS *pM, OutputS *pOut)
 
 #ifdef PARTICLES
               if (pOut->out_pargrid) {
-                fprintf(pfile,fmt,pG->Coup[k][j][i].grid_d);
-                fprintf(pfile,fmt,pG->Coup[k][j][i].grid_v1);
-                fprintf(pfile,fmt,pG->Coup[k][j][i].grid_v2);
-                fprintf(pfile,fmt,pG->Coup[k][j][i].grid_v3);
+                fprintf(pfile,fmt,pG->Mom[ipar[0]][k][j][i]);
+                fprintf(pfile,fmt,pG->Mom[ipar[1]][k][j][i]);
+                fprintf(pfile,fmt,pG->Mom[ipar[2]][k][j][i]);
+                fprintf(pfile,fmt,pG->Mom[ipar[3]][k][j][i]);
               }
 #endif
 
@@ -293,11 +307,25 @@ void dump_tab_prim(MeshS *pM, OutputS *pOut)
   int col_cnt, nmax;
 #ifdef PARTICLES
   Real d1;
+  int ipar[4] = {-1,-1,-1,-1}; /* index in Mom of dpar, M1par..M3par */
 #endif
 #if (NSCALARS > 0)
   int n;
 #endif
 
+#ifdef PARTICLES
+/* Binned particle moments, see particle_moments() */
+
+  if (pOut->out_pargrid) {
+    ipar[0] = particle_moment_index(pOut->par_prop, -1, mom_d);
+    ipar[1] = particle_moment_index(pOut->par_prop, -1, mom_M1);
+    ipar[2] = particle_moment_index(pOut->par_prop, -1, mom_M2);
+    ipar[3] = particle_moment_index(pOut->par_prop, -1, mom_M3);
+    if (ipar[0] < 0)
+      ath_error("[dump_tab_prim]: Particles of this output not binned\n");
+  }
+#endif
+
 /* Add a white space to the format, setup format for integer zone columns */
   if(pOut->dat_fmt == NULL){
     sprintf(fmt," %%12.8e"); /* Use a default format */
@@ -502,14 +530,14 @@ void dump_tab_prim(MeshS *pM, OutputS *pOut)
 
 #ifdef PARTICLES
               if (pOut->out_pargrid) {
-                fprintf(pfile,fmt,pG->Coup[k][j][i].grid_d);
-                if (pG->Coup[k][j][i].grid_d>0.0)
-                  d1 = 1.0/pG->Coup[k][j][i].grid_d;
+                fprintf(pfile,fmt,pG->Mom[ipar[0]][k][j][i]);
+                if (pG->Mom[ipar[0]][k][j][i]>0.0)
+                  d1 = 1.0/pG->Mom[ipar[0]][k][j][i];
                 else
                   d1 = 0.0;
-                fprintf(pfile,fmt,pG->Coup[k][j][i].grid_v1*d1);
-                fprintf(pfile,fmt,pG->Coup[k][j][i].grid_v2*d1);
-                fprintf(pfile,fmt,pG->Coup[k][j][i].grid_v3*d1);
+                fprintf(pfile,fmt,pG->Mom[ipar[1]][k][j][i]*d1);
+                fprintf(pfile,fmt,pG->Mom[ipar[2]][k][j][i]*d1);
+                fprintf(pfile,fmt,pG->Mom[ipar[3]][k][j][i]*d1);
               }
 #endif
 
@@ -6,6 +6,7 @@
  * PURPOSE: Function to write a dump in VTK "legacy" format.  With SMR,
  *   dumps are made for all levels and domains, unless nlevel and ndomain are
  *   specified in <output> block.  Works for BOTH conserved and primitives.
+ *   With ASYNC_IO the file is written in the background (see ath_async.c).
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - dump_vtk() - writes VTK dump (all variables).			      */
@@ -41,6 +42,20 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
 #if (NSCALARS > 0)
   int n;
 #endif
+#ifdef PARTICLES
+  int ipar[4] = {-1,-1,-1,-1}; /* index in Mom of dpar, M1par..M3par */
+
+/* Binned particle moments, see particle_moments() */
+
+  if (pOut->out_pargrid) {
+    ipar[0] = particle_moment_index(pOut->par_prop, -1, mom_d);
+    ipar[1] = particle_moment_index(pOut->par_prop, -1, mom_M1);
+    ipar[2] = particle_moment_index(pOut->par_prop, -1, mom_M2);
+    ipar[3] = particle_moment_index(pOut->par_prop, -1, mom_M3);
+    if (ipar[0] < 0)
+      ath_error("[dump_vtk]: Particles of this output not binned\n");
+  }
+#endif
 
 /* Loop over all Domains in Mesh, and output Grid data */
 
@@ -103,7 +118,7 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
           ath_error("[dump_vtk]: Error constructing filename\n");
         }
 
-        if((pfile = fopen(fname,"w")) == NULL){
+        if((pfile = ath_async_open(fname,pOut)) == NULL){
           ath_error("[dump_vtk]: Unable to open vtk dump file\n");
           return;
         }
@@ -267,7 +282,7 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
           for (k=kl; k<=ku; k++) {
             for (j=jl; j<=ju; j++) {
               for (i=il; i<=iu; i++) {
-                data[i-il] = pGrid->Coup[k][j][i].grid_d;
+                data[i-il] = pGrid->Mom[ipar[0]][k][j][i];
               }
               if(!big_end) ath_bswap(data,sizeof(float),iu-il+1);
               fwrite(data,sizeof(float),(size_t)ndata0,pfile);
@@ -277,9 +292,9 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
           for (k=kl; k<=ku; k++) {
             for (j=jl; j<=ju; j++) {
               for (i=il; i<=iu; i++) {
-                data[3*(i-il)] = pGrid->Coup[k][j][i].grid_v1;
-                data[3*(i-il)+1] = pGrid->Coup[k][j][i].grid_v2;
-                data[3*(i-il)+2] = pGrid->Coup[k][j][i].grid_v3;
+                data[3*(i-il)] = pGrid->Mom[ipar[1]][k][j][i];
+                data[3*(i-il)+1] = pGrid->Mom[ipar[2]][k][j][i];
+                data[3*(i-il)+2] = pGrid->Mom[ipar[3]][k][j][i];
               }
               if(!big_end) ath_bswap(data,sizeof(float),3*(iu-il+1));
               fwrite(data,sizeof(float),(size_t)(3*ndata0),pfile);
@@ -316,7 +331,7 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
 
 /* close file and free memory */
 
-        fclose(pfile);
+        ath_async_close(pfile);
         free(data);
         if(strcmp(pOut->out,"prim") == 0) free_3d_array(W);
       }}
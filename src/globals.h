@@ -70,6 +70,9 @@ ShearFun_t ShearProfile = NULL;
 #endif
 
 Real etah=0.0;
+#ifdef OPENMP
+#pragma omp threadprivate(etah)
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* definitions included everywhere except main.c  */
@@ -133,5 +136,8 @@ extern ShearFun_t ShearProfile;
 #endif
 
 extern Real etah;
+#ifdef OPENMP
+#pragma omp threadprivate(etah)
+#endif
 #endif /* MAIN_C */
 #endif /* GLOBALS_H */
@@ -29,6 +29,10 @@ VDFun_t integrate_init(MeshS *pM)
   dim = 0;
   for (i=0; i<3; i++) if(pM->Nx[i] > 1) dim++;
 
+#if defined(SPECIAL_RELATIVITY) && defined(HLLD_FLUX)
+  hybrid_flux_init();
+#endif
+
 /* set function pointer to appropriate integrator based on dimensions */
   switch(dim){
 
@@ -71,6 +75,9 @@ VDFun_t integrate_init(MeshS *pM)
     cfl = par_getd("time","cour_no");
     if (cfl > 0.5)
       ath_error("<time>cour_no=%e, must be <= 0.5 with 3D VL integrator\n",cfl);
+#ifdef SPECIAL_RELATIVITY
+    if (par_geti_def("time","tile",0) > 0) return integrate_3d_vl_tiled;
+#endif
     return integrate_3d_vl;
 #else
     ath_err("[integrate_init]: Invalid integrator defined for 3D problem");
@@ -92,6 +99,10 @@ VDFun_t integrate_init(MeshS *pM)
  *  \brief Free memory */
 void integrate_destruct()
 {
+#if defined(SPECIAL_RELATIVITY) && defined(HLLD_FLUX)
+  hybrid_flux_destruct();
+#endif
+
   switch(dim){
   case 1:
     integrate_destruct_1d();
@@ -105,6 +105,9 @@ void integrate_1d_ctu(DomainS *pD)
   iu = ie + 1;
 #endif
 
+/* Complete the boundary exchange started by bvals_mhd_start() */
+  bvals_mhd_finish(pD);
+
 /* Compute predictor feedback from particle drag */
 #ifdef FEEDBACK
   feedback_predictor(pD);
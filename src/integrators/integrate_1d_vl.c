@@ -75,6 +75,9 @@ void integrate_1d_vl(DomainS *pD)
 #endif /* CYLINDRICAL */
   Real lsf=1.0, rsf=1.0;
 
+/* Complete the boundary exchange started by bvals_mhd_start() */
+  bvals_mhd_finish(pD);
+
   for (i=is-nghost; i<=ie+nghost; i++) {
     Uhalf[i] = pG->U[ks][js][i];
   }
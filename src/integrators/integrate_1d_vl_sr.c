@@ -90,6 +90,9 @@ void integrate_1d_vl(DomainS *pD)
 
   int il=is-(nghost-1), iu=ie+(nghost-1);
 
+/* Complete the boundary exchange started by bvals_mhd_start() */
+  bvals_mhd_finish(pD);
+
   for (i=is-nghost; i<=ie+nghost; i++) {
     Uhalf[i] = pG->U[ks][js][i];
     W[i] = Cons_to_Prim(&(pG->U[ks][js][i]));
@@ -142,9 +145,7 @@ void integrate_1d_vl(DomainS *pD)
 /*--- Step 1d ------------------------------------------------------------------
  * Compute flux in x1-direction */
 
-  for (i=il; i<=ie+nghost; i++) {
-    fluxes(Ul[i],Ur[i],Wl[i],Wr[i],Bxi[i],&x1Flux[i]);
-  }
+  fluxes_pencil(il,ie+nghost,Ul,Ur,Wl,Wr,Bxi,x1Flux);
 
 /*=== STEPS 2-4: Not needed in 1D ===*/
 
@@ -303,10 +304,10 @@ void integrate_1d_vl(DomainS *pD)
   for (i=is; i<=ie+1; i++) {
     Ul[i] = Prim1D_to_Cons1D(&Wl_x1Face[i],&Bxi[i]);
     Ur[i] = Prim1D_to_Cons1D(&Wr_x1Face[i],&Bxi[i]);
-
-    fluxes(Ul[i],Ur[i],Wl_x1Face[i],Wr_x1Face[i],Bxi[i],&x1Flux[i]);
   }
 
+  fluxes_pencil(is,ie+1,Ul,Ur,Wl_x1Face,Wr_x1Face,Bxi,x1Flux);
+
 /*=== STEP 12: Not needed in 1D ===*/
         
 /*=== STEP 13: Add source terms for a full timestep using n+1/2 states =======*/
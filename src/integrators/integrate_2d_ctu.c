@@ -161,6 +161,9 @@ void integrate_2d_ctu(DomainS *pD)
     ath_error("[integrate_2d_ctu]:  OrbitalProfile() and ShearProfile() *must* be defined.\n");
 #endif
 
+/* Complete the boundary exchange started by bvals_mhd_start() */
+  bvals_mhd_finish(pD);
+
 /* With particles, one more ghost cell must be updated in predict step */
 #ifdef PARTICLES
   Real d1;
@@ -149,6 +149,9 @@ void integrate_2d_vl(DomainS *pD)
     ath_error("[integrate_2d_vl]:  OrbitalProfile() and ShearProfile() *must* be defined.\n");
 #endif
 
+/* Complete the boundary exchange started by bvals_mhd_start() */
+  bvals_mhd_finish(pD);
+
 /* Set etah=0 so first calls to flux functions do not use H-correction */
   etah = 0.0;
 
@@ -146,6 +146,9 @@ void integrate_2d_vl(DomainS *pD)
   int il=is-(nghost-1), iu=ie+(nghost-1);
   int jl=js-(nghost-1), ju=je+(nghost-1);
   #endif //PARTICLES
+/* Complete the boundary exchange started by bvals_mhd_start() */
+  bvals_mhd_finish(pD);
+
   #ifdef PARTICLES
   // give particles access to half-step quantities
   pG->Uhalf = &Uhalf;
@@ -214,12 +217,12 @@ void integrate_2d_vl(DomainS *pD)
 /*--- Step 1d ------------------------------------------------------------------
  * Compute flux in x1-direction */
 
-    for (i=il; i<=ie+nghost; i++) {
-      fluxes(Ul[i],Ur[i],Wl[i],Wr[i],Bxi[i],&x1Flux[j][i]);
+    fluxes_pencil(il,ie+nghost,Ul,Ur,Wl,Wr,Bxi,x1Flux[j]);
 #ifdef USE_ENTROPY_FIX
+    for (i=il; i<=ie+nghost; i++) {
       entropy_flux(Ul[i],Ur[i],Wl[i],Wr[i],Bxi[i],&x1FluxS[j][i]);
-#endif
     }
+#endif
   }
 
 /*=== STEP 2: Compute first-order fluxes at t^{n} in x2-direction ============*/
@@ -266,8 +269,9 @@ void integrate_2d_vl(DomainS *pD)
 /*--- Step 2d ------------------------------------------------------------------
  * Compute flux in x2-direction */
 
+    fluxes_pencil(jl,je+nghost,Ul,Ur,Wl,Wr,Bxi,U1d);
     for (j=jl; j<=je+nghost; j++) {
-      fluxes(Ul[j],Ur[j],Wl[j],Wr[j],Bxi[j],&x2Flux[j][i]);
+      x2Flux[j][i] = U1d[j];
 #ifdef USE_ENTROPY_FIX
       entropy_flux(Ul[j],Ur[j],Wl[j],Wr[j],Bxi[j],&x2FluxS[j][i]);
 #endif
@@ -707,13 +711,16 @@ void integrate_2d_vl(DomainS *pD)
 #endif
       Ul[i] = Prim1D_to_Cons1D(&Wl_x1Face[j][i],&Bx);
       Ur[i] = Prim1D_to_Cons1D(&Wr_x1Face[j][i],&Bx);
+      Bxi[i] = Bx;
+    }
 
-      fluxes(Ul[i],Ur[i],Wl_x1Face[j][i],Wr_x1Face[j][i],Bx,&x1Flux[j][i]);
+    fluxes_pencil(is,ie+1,Ul,Ur,Wl_x1Face[j],Wr_x1Face[j],Bxi,x1Flux[j]);
 
+    for (i=is; i<=ie+1; i++) {
 #ifdef USE_ENTROPY_FIX
       entropy_flux(Ul[i],          Ur[i],
 		   Wl_x1Face[j][i],Wr_x1Face[j][i],
-		   Bx,             &x1FluxS[j][i]);
+		   Bxi[i],         &x1FluxS[j][i]);
 #endif
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
@@ -754,13 +761,16 @@ void integrate_2d_vl(DomainS *pD)
 #endif
       Ul[i] = Prim1D_to_Cons1D(&Wl_x2Face[j][i],&Bx);
       Ur[i] = Prim1D_to_Cons1D(&Wr_x2Face[j][i],&Bx);
+      Bxi[i] = Bx;
+    }
 
-      fluxes(Ul[i],Ur[i],Wl_x2Face[j][i],Wr_x2Face[j][i],Bx,&x2Flux[j][i]);
+    fluxes_pencil(is-1,ie+1,Ul,Ur,Wl_x2Face[j],Wr_x2Face[j],Bxi,x2Flux[j]);
 
+    for (i=is-1; i<=ie+1; i++) {
 #ifdef USE_ENTROPY_FIX
       entropy_flux(Ul[i],          Ur[i],
 		   Wl_x2Face[j][i],Wr_x2Face[j][i],
-		   Bx,             &x2FluxS[j][i]);
+		   Bxi[i],         &x2FluxS[j][i]);
 #endif
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
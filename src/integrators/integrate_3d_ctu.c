@@ -10,6 +10,9 @@
  *   -  B1i, B2i, B3i  -- interface magnetic field
  *   Also adds gravitational source terms, self-gravity, optically thin cooling,
  *   shearing box source terms, and the H-correction of Sanders et al.
+ *   With OpenMP, the outer loops over k (or k,j) of the sweeps are shared
+ *   among the threads, each with its own 1D scratch vectors.  The SMR steps
+ *   stay serial.
  *   - For adb hydro, requires (9*Cons1DS +  3*Real) = 48 3D arrays
  *   - For adb mhd, requires   (9*Cons1DS + 10*Real) = 73 3D arrays
  *   The H-correction of Sanders et al. adds another 3 arrays.  
@@ -65,10 +68,14 @@ Real ***emf1=NULL, ***emf2=NULL, ***emf3=NULL;
 static Real ***emf1_cc=NULL, ***emf2_cc=NULL, ***emf3_cc=NULL;
 #endif /* MHD */
 
-/* 1D scratch vectors used by lr_states and flux functions */
+/* 1D scratch vectors used by lr_states and flux functions, one set per
+ * OpenMP thread */
 static Real *Bxc=NULL, *Bxi=NULL;
 static Prim1DS *W=NULL, *Wl=NULL, *Wr=NULL;
 static Cons1DS *U1d=NULL;
+#ifdef OPENMP
+#pragma omp threadprivate(Bxc,Bxi,W,Wl,Wr,U1d)
+#endif
 
 /* density and Pressure at t^{n+1/2} needed by MHD, cooling, and gravity */
 static Real ***dhalf = NULL, ***phalf=NULL;
@@ -89,6 +96,72 @@ static ConsS **rFlxiib=NULL, **rFlxoib=NULL;
 static Real ***geom_src=NULL;
 #endif
 
+/* The scalar temporaries of integrate_3d_ctu() that are private to each
+ * OpenMP thread in its parallel loops.  Many are only declared in some
+ * configurations, so the lists are built here and expanded in the private
+ * and firstprivate clauses.  The firstprivate ones are set before the loops,
+ * and are only changed within them in cylindrical coordinates or with MHD. */
+#ifdef OPENMP
+#ifdef MHD
+#define MHD_PRIVATE ,MHD_src_By,MHD_src_Bz,mdb1,mdb2,mdb3,db1,db2,db3,l1,l2,l3, \
+  B1,B2,B3,V1,V2,V3,B1ch,B2ch,B3ch
+#else
+#define MHD_PRIVATE
+#endif
+#ifndef BAROTROPIC
+#define COOL_PRIVATE ,coolfl,coolfr,coolf,Eh
+#else
+#define COOL_PRIVATE
+#endif
+#ifdef H_CORRECTION
+#define HCORR_PRIVATE ,cfr,cfl,lambdar,lambdal
+#else
+#define HCORR_PRIVATE
+#endif
+#ifdef SELF_GRAVITY
+#define SG_PRIVATE ,gxl,gxr,gyl,gyr,gzl,gzr, \
+  flx_m1l,flx_m1r,flx_m2l,flx_m2r,flx_m3l,flx_m3r
+#else
+#define SG_PRIVATE
+#endif
+#ifdef SHEARING_BOX
+#define SB_PRIVATE ,M1n,dM2n,M1e,dM2e, \
+  flx1_dM2,frx1_dM2,flx2_dM2,frx2_dM2,flx3_dM2,frx3_dM2
+#else
+#define SB_PRIVATE
+#endif
+#ifdef CYLINDRICAL
+#ifndef ISOTHERMAL
+#define PAVG_PRIVATE ,Pavgh
+#else
+#define PAVG_PRIVATE
+#endif
+#ifdef FARGO
+#define FARGO_PRIVATE ,Om,qshear,Mrn,Mpn,Mre,Mpe,Mrav,Mpav
+#else
+#define FARGO_PRIVATE
+#endif
+#define CYL_PRIVATE ,rinv,geom_src_d,geom_src_Vx,geom_src_Vy,geom_src_P, \
+  geom_src_By,geom_src_Bz PAVG_PRIVATE FARGO_PRIVATE
+#else
+#define CYL_PRIVATE
+#endif
+#ifdef PARTICLES
+#define PAR_PRIVATE ,d1
+#else
+#define PAR_PRIVATE
+#endif
+#if (NSCALARS > 0)
+#define SCAL_PRIVATE ,n
+#else
+#define SCAL_PRIVATE
+#endif
+#define CTU_PRIVATE x1,x2,x3,phicl,phicr,phifc,phil,phir,phic,M1h,M2h,M3h, \
+  g,gl,gr MHD_PRIVATE COOL_PRIVATE HCORR_PRIVATE SG_PRIVATE SB_PRIVATE \
+  CYL_PRIVATE PAR_PRIVATE SCAL_PRIVATE
+#define CTU_FIRSTPRIVATE Bx,lsf,rsf,q2,dx2,dx2i,dtodx2
+#endif /* OPENMP */
+
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES: 
  *   integrate_emf1_corner() - the upwind CT method in GS05, for emf1
@@ -178,6 +251,9 @@ void integrate_3d_ctu(DomainS *pD)
     ath_error("[integrate_3d_ctu]:  OrbitalProfile() and ShearProfile() *must* be defined.\n");
 #endif
 
+/* Complete the boundary exchange started by bvals_mhd_start() */
+  bvals_mhd_finish(pD);
+
 /* With particles, one more ghost cell must be updated in predict step */
 #ifdef PARTICLES
   Real d1;
@@ -197,6 +273,9 @@ void integrate_3d_ctu(DomainS *pD)
 #endif
 
 /* Set etah=0 so first calls to flux functions do not use H-correction */
+#ifdef OPENMP
+#pragma omp parallel
+#endif
   etah = 0.0;
 
 /* Compute predictor feedback from particle drag */
@@ -212,6 +291,10 @@ void integrate_3d_ctu(DomainS *pD)
  * U1d = (d, M1, M2, M3, E, B2c, B3c, s[n])
  */
 
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
@@ -565,6 +648,10 @@ void integrate_3d_ctu(DomainS *pD)
  * U1d = (d, M2, M3, M1, E, B3c, B1c, s[n])
  */
 
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(j,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl; k<=ku; k++) {
     for (i=il; i<=iu; i++) {
 #ifdef CYLINDRICAL
@@ -768,6 +855,10 @@ void integrate_3d_ctu(DomainS *pD)
  * U1d = (d, M3, M1, M2, E, B1c, B2c, s[n])
  */
 
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(k,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl; j<=ju; j++) {
     for (i=il; i<=iu; i++) {
       for (k=ks-nghost; k<=ke+nghost; k++) {
@@ -963,6 +1054,9 @@ void integrate_3d_ctu(DomainS *pD)
 
 #ifdef MHD
 /* emf1 */
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -986,6 +1080,9 @@ void integrate_3d_ctu(DomainS *pD)
  * Update the interface magnetic fields using CT for a half time step.
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1014,6 +1111,9 @@ void integrate_3d_ctu(DomainS *pD)
                              q3*(emf1[k+1][ju][i  ]-emf1[k][ju][i]);
     }
   }
+#ifdef OPENMP
+#pragma omp parallel for private(i,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl+1; j<=ju-1; j++) {
     for (i=il+1; i<=iu-1; i++) {
 #ifdef CYLINDRICAL
@@ -1033,6 +1133,9 @@ void integrate_3d_ctu(DomainS *pD)
  * Since the fluxes come from an x2-sweep, (x,y,z) on RHS -> (z,x,y) on LHS 
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu; i++) {
@@ -1132,6 +1235,9 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu; i++) {
@@ -1227,6 +1333,9 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu; i++) {
@@ -1292,6 +1401,9 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu; i++) {
@@ -1347,6 +1459,9 @@ void integrate_3d_ctu(DomainS *pD)
  * Since the fluxes come from an x1-sweep, (x,y,z) on RHS -> (y,z,x) on LHS
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1439,6 +1554,9 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1530,6 +1648,9 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1617,6 +1738,9 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1673,6 +1797,9 @@ void integrate_3d_ctu(DomainS *pD)
 
 #ifdef SHEARING_BOX
   if (ShearingBoxPot != NULL){
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1720,6 +1847,9 @@ void integrate_3d_ctu(DomainS *pD)
     }
   }}
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1738,6 +1868,9 @@ void integrate_3d_ctu(DomainS *pD)
 #endif /* SHEARING_BOX */
 
 #if defined(CYLINDRICAL) && defined(FARGO)
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1759,6 +1892,9 @@ void integrate_3d_ctu(DomainS *pD)
  * states on x2-faces.  S_{M_R} = -(\rho v_\phi^2 - B_\phi^2)/R
  */
 #ifdef CYLINDRICAL
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1776,6 +1912,9 @@ void integrate_3d_ctu(DomainS *pD)
  * Since the fluxes come from an x1-sweep, (x,y,z) on RHS -> (z,x,y) on LHS 
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1869,6 +2008,9 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1960,6 +2102,9 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -2052,6 +2197,9 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -2109,6 +2257,9 @@ void integrate_3d_ctu(DomainS *pD)
 
 #ifdef SHEARING_BOX
   if (ShearingBoxPot != NULL){
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -2156,6 +2307,9 @@ void integrate_3d_ctu(DomainS *pD)
     }
   }}
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -2174,6 +2328,9 @@ void integrate_3d_ctu(DomainS *pD)
 #endif /* SHEARING_BOX */
 
 #if defined(CYLINDRICAL) && defined(FARGO)
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -2195,6 +2352,9 @@ void integrate_3d_ctu(DomainS *pD)
  * states on x3-faces.  S_{M_R} = -(\rho v_\phi^2 - B_\phi^2)/R
  */
 #ifdef CYLINDRICAL
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -2208,6 +2368,9 @@ void integrate_3d_ctu(DomainS *pD)
 /*--- Step 7e ------------------------------------------------------------------
  * Apply density floor
  */
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
   for (j=jl+1; j<=ju-1; j++) {
   for (i=il+1; i<=iu-1; i++) {
@@ -2248,6 +2411,9 @@ void integrate_3d_ctu(DomainS *pD)
 #endif
 #endif
   {
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
     for (k=kl+1; k<=ku-1; k++) {
       for (j=jl+1; j<=ju-1; j++) {
 	for (i=il+1; i<=iu-1; i++) {
@@ -2281,6 +2447,9 @@ void integrate_3d_ctu(DomainS *pD)
 #endif /* PARTICLES */
 #endif /* MHD */
   {
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -2451,6 +2620,9 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef H_CORRECTION
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+2; i++) {
@@ -2466,6 +2638,9 @@ void integrate_3d_ctu(DomainS *pD)
     }
   }
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+2; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -2481,6 +2656,9 @@ void integrate_3d_ctu(DomainS *pD)
     }
   }
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks-1; k<=ke+2; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -2501,6 +2679,9 @@ void integrate_3d_ctu(DomainS *pD)
  * Compute 3D x1-fluxes from corrected L/R states.
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is; i<=ie+1; i++) {
@@ -2532,6 +2713,9 @@ void integrate_3d_ctu(DomainS *pD)
  * Compute 3D x2-fluxes from corrected L/R states.
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -2563,6 +2747,9 @@ void integrate_3d_ctu(DomainS *pD)
  * Compute 3D x3-fluxes from corrected L/R states.
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -2688,6 +2875,9 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -2718,6 +2908,9 @@ void integrate_3d_ctu(DomainS *pD)
         dtodx3*(emf1[k+1][je+1][i  ] - emf1[k][je+1][i]);
     }
   }
+#ifdef OPENMP
+#pragma omp parallel for private(i,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
@@ -2736,6 +2929,9 @@ void integrate_3d_ctu(DomainS *pD)
  * Add geometric source terms
  */
 #ifdef CYLINDRICAL
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -2876,6 +3072,9 @@ void integrate_3d_ctu(DomainS *pD)
 #ifdef SHEARING_BOX
   fact = om_dt/(2. + (2.-qshear)*om_dt*om_dt);
   qom = qshear*Omega_0;
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for(k=ks; k<=ke; k++) {
     for(j=js; j<=je; j++) {
       for(i=is; i<=ie; i++) {
@@ -2961,6 +3160,9 @@ void integrate_3d_ctu(DomainS *pD)
 #endif /* SHEARING_BOX */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
@@ -3015,6 +3217,9 @@ void integrate_3d_ctu(DomainS *pD)
 #ifdef SELF_GRAVITY
 /* Add fluxes and source terms due to (d/dx1) terms  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
@@ -3060,6 +3265,9 @@ void integrate_3d_ctu(DomainS *pD)
 
 /* Add fluxes and source terms due to (d/dx2) terms  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
@@ -3105,6 +3313,9 @@ void integrate_3d_ctu(DomainS *pD)
 
 /* Add fluxes and source terms due to (d/dx3) terms  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
@@ -3150,6 +3361,9 @@ void integrate_3d_ctu(DomainS *pD)
 
 /* Save mass fluxes in Grid structure for source term correction in main loop */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
       for (i=is; i<=ie+1; i++) {
@@ -3167,6 +3381,9 @@ void integrate_3d_ctu(DomainS *pD)
 
 #ifndef BAROTROPIC
   if (CoolingFunc != NULL){
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
     for (k=ks; k<=ke; k++){
       for (j=js; j<=je; j++){
         for (i=is; i<=ie; i++){
@@ -3183,6 +3400,9 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef FEEDBACK
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++)
     for (j=js; j<=je; j++)
       for (i=is; i<=ie; i++) {
@@ -3203,6 +3423,9 @@ void integrate_3d_ctu(DomainS *pD)
  * Update cell-centered variables in pG using 3D x1-Fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -3229,6 +3452,9 @@ void integrate_3d_ctu(DomainS *pD)
  * Update cell-centered variables in pG using 3D x2-Fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -3255,6 +3481,9 @@ void integrate_3d_ctu(DomainS *pD)
  * Update cell-centered variables in pG using 3D x3-Fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -3279,6 +3508,9 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,CTU_PRIVATE) firstprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -3598,7 +3830,7 @@ void integrate_3d_ctu(DomainS *pD)
 */
 void integrate_init_3d(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,ierr=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -3646,9 +3878,6 @@ void integrate_init_3d(MeshS *pM)
     goto on_error;
 #endif /* H_CORRECTION */
 
-  if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
-  if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
-
 #ifdef MHD
   if ((B1_x1Face = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
     == NULL) goto on_error;
@@ -3658,10 +3887,19 @@ void integrate_init_3d(MeshS *pM)
     == NULL) goto on_error;
 #endif /* MHD */
 
-  if ((U1d=(Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((W  =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wl =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wr =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
+/* Each OpenMP thread allocates its own (threadprivate) 1D scratch vectors */
+#ifdef OPENMP
+#pragma omp parallel reduction(+:ierr)
+#endif
+  {
+    if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) ierr++;
+    if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) ierr++;
+    if ((U1d=(Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) ierr++;
+    if ((W  =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) ierr++;
+    if ((Wl =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) ierr++;
+    if ((Wr =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) ierr++;
+  }
+  if (ierr > 0) goto on_error;
 
   if ((Ul_x1Face=(Cons1DS***)calloc_3d_array(size3,size2,size1,sizeof(Cons1DS)))
     == NULL) goto on_error;
@@ -3741,18 +3979,25 @@ void integrate_destruct_3d(void)
   if (eta3 != NULL) free_3d_array(eta3);
 #endif /* H_CORRECTION */
 
-  if (Bxc != NULL) free(Bxc);
-  if (Bxi != NULL) free(Bxi);
 #ifdef MHD
   if (B1_x1Face != NULL) free_3d_array(B1_x1Face);
   if (B2_x2Face != NULL) free_3d_array(B2_x2Face);
   if (B3_x3Face != NULL) free_3d_array(B3_x3Face);
 #endif /* MHD */
 
-  if (U1d      != NULL) free(U1d);
-  if (W        != NULL) free(W);
-  if (Wl       != NULL) free(Wl);
-  if (Wr       != NULL) free(Wr);
+#ifdef OPENMP
+#pragma omp parallel
+#endif
+  {
+    if (Bxc      != NULL) free(Bxc);
+    if (Bxi      != NULL) free(Bxi);
+    if (U1d      != NULL) free(U1d);
+    if (W        != NULL) free(W);
+    if (Wl       != NULL) free(Wl);
+    if (Wr       != NULL) free(Wr);
+    Bxc = NULL;  Bxi = NULL;
+    U1d = NULL;  W = NULL;  Wl = NULL;  Wr = NULL;
+  }
 
   if (Ul_x1Face != NULL) free_3d_array(Ul_x1Face);
   if (Ur_x1Face != NULL) free_3d_array(Ur_x1Face);
@@ -3802,6 +4047,9 @@ static void integrate_emf1_corner(const GridS *pG)
   int k, ks = pG->ks, ke = pG->ke;
   Real de1_l2, de1_r2, de1_l3, de1_r3;
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,de1_l2,de1_r2,de1_l3,de1_r3)
+#endif
   for (k=ks-1; k<=ke+2; k++) {
     for (j=js-1; j<=je+2; j++) {
       for (i=is-2; i<=ie+2; i++) {
@@ -3871,6 +4119,9 @@ static void integrate_emf2_corner(const GridS *pG)
   int k, ks = pG->ks, ke = pG->ke;
   Real de2_l1, de2_r1, de2_l3, de2_r3;
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,de2_l1,de2_r1,de2_l3,de2_r3)
+#endif
   for (k=ks-1; k<=ke+2; k++) {
     for (j=js-2; j<=je+2; j++) {
       for (i=is-1; i<=ie+2; i++) {
@@ -3941,6 +4192,9 @@ static void integrate_emf3_corner(const GridS *pG)
   Real de3_l1, de3_r1, de3_l2, de3_r2;
   Real rsf=1.0,lsf=1.0;
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,de3_l1,de3_r1,de3_l2,de3_r2) firstprivate(rsf,lsf)
+#endif
   for (k=ks-2; k<=ke+2; k++) {
     for (j=js-1; j<=je+2; j++) {
       for (i=is-1; i<=ie+2; i++) {
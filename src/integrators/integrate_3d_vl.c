@@ -10,6 +10,9 @@
  *    - B1i, B2i, B3i  -- interface magnetic field
  *   Also adds gravitational source terms, self-gravity, and the H-correction
  *   of Sanders et al.
+ *   With OpenMP, the outer loops over k (or k,j) of the sweeps are shared
+ *   among the threads, each with its own 1D scratch vectors.  The first-order
+ *   flux correction of single cells (FixCell) and the SMR steps stay serial.
  *   - For adb hydro, requires (9*Cons1DS + 3*Real + 1*ConsS) = 53 3D arrays
  *   - For adb mhd, requires   (9*Cons1DS + 9*Real + 1*ConsS) = 80 3D arrays
  *
@@ -64,10 +67,14 @@ static Real ***emf1=NULL, ***emf2=NULL, ***emf3=NULL;
 static Real ***emf1_cc=NULL, ***emf2_cc=NULL, ***emf3_cc=NULL;
 #endif /* MHD */
 
-/* 1D scratch vectors used by lr_states and flux functions */
+/* 1D scratch vectors used by lr_states and flux functions, one set per
+ * OpenMP thread */
 static Real *Bxc=NULL, *Bxi=NULL;
 static Prim1DS *W1d=NULL, *Wl=NULL, *Wr=NULL;
 static Cons1DS *U1d=NULL, *Ul=NULL, *Ur=NULL;
+#ifdef OPENMP
+#pragma omp threadprivate(Bxc,Bxi,W1d,Wl,Wr,U1d,Ul,Ur)
+#endif
 
 /* conserved variables at t^{n+1/2} computed in predict step */
 static ConsS ***Uhalf=NULL;
@@ -116,9 +123,7 @@ void integrate_3d_vl(DomainS *pD)
   int j, js = pG->js, je = pG->je;
   int k, ks = pG->ks, ke = pG->ke;
   Real x1,x2,x3,phicl,phicr,phifc,phil,phir,phic,Bx;
-#if (NSCALARS > 0)
   int n;
-#endif
 #ifdef SELF_GRAVITY
   Real gxl,gxr,gyl,gyr,gzl,gzr,flx_m1l,flx_m1r,flx_m2l,flx_m2r,flx_m3l,flx_m3r;
 #endif
@@ -160,9 +165,18 @@ void integrate_3d_vl(DomainS *pD)
     ath_error("[integrate_3d_vl]:  OrbitalProfile() and ShearProfile() *must* be defined.\n");
 #endif
 
+/* Complete the boundary exchange started by bvals_mhd_start() */
+  bvals_mhd_finish(pD);
+
 /* Set etah=0 so first calls to flux functions do not use H-correction */
+#ifdef OPENMP
+#pragma omp parallel
+#endif
   etah = 0.0;
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j)
+#endif
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
@@ -184,6 +198,9 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M1, M2, M3, E, B2c, B3c, s[n])
  */
 
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(i,n)
+#endif
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
@@ -242,6 +259,9 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M2, M3, M1, E, B3c, B1c, s[n])
  */
 
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(j,n)
+#endif
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
       for (j=js-nghost; j<=je+nghost; j++) {
@@ -300,6 +320,9 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M3, M1, M2, E, B1c, B2c, s[n])
  */
 
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(k,n)
+#endif
   for (j=js-nghost; j<=je+nghost; j++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
       for (k=ks-nghost; k<=ke+nghost; k++) {
@@ -358,6 +381,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,Whalf)
+#endif
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
@@ -376,6 +402,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update the interface magnetic fields using CT for a half time step.
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j) firstprivate(q2,lsf,rsf)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -404,6 +433,9 @@ void integrate_3d_vl(DomainS *pD)
                                q3*(emf1[k+1][ju+1][i  ]-emf1[k][ju+1][i]);
     }
   }
+#ifdef OPENMP
+#pragma omp parallel for private(i) firstprivate(q2,lsf,rsf)
+#endif
   for (j=jl; j<=ju; j++) {
     for (i=il; i<=iu; i++) {
 #ifdef CYLINDRICAL
@@ -420,6 +452,9 @@ void integrate_3d_vl(DomainS *pD)
  * face-centered fields.
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j) firstprivate(lsf,rsf)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -440,6 +475,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables to half-timestep using x1-fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,n) firstprivate(lsf,rsf)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -466,6 +504,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables to half-timestep using x2-fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,n) firstprivate(q2)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -492,6 +533,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables to half-timestep using x3-fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,n)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -516,6 +560,9 @@ void integrate_3d_vl(DomainS *pD)
  * With first-order flux correction, save predict fluxes and emf3
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j)
+#endif
   for (k=ks; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
       for (i=is; i<=ie+1; i++) {
@@ -619,6 +666,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,x1,x2,x3,phic,phir,phil,g) firstprivate(q2,lsf,rsf)
+#endif
     for (k=kl; k<=ku; k++) {
       for (j=jl; j<=ju; j++) {
         for (i=il; i<=iu; i++) {
@@ -667,6 +717,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,phic,phir,phil)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -710,6 +763,9 @@ void integrate_3d_vl(DomainS *pD)
 
 #ifdef SHEARING_BOX
   if (ShearingBoxPot != NULL){
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,x1,x2,x3,phic,phir,phil)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -743,6 +799,9 @@ void integrate_3d_vl(DomainS *pD)
     }
   }}
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -758,6 +817,9 @@ void integrate_3d_vl(DomainS *pD)
 #endif /* SHEARING_BOX */
 
 #if defined(CYLINDRICAL) && defined(FARGO)
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,Om,qshear)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -777,6 +839,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef CYLINDRICAL
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,Ekin,Emag,Ptot,B2sq)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -811,6 +876,9 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M1, M2, M3, E, B2c, B3c, s[n])
  */
 
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(i,n)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=il; i<=iu; i++) {
@@ -855,6 +923,9 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M2, M3, M1, E, B3c, B1c, s[n])
  */
 
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(j,n) firstprivate(dx2)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (i=is-1; i<=ie+1; i++) {
       for (j=jl; j<=ju; j++) {
@@ -902,6 +973,9 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M3, M1, M2, E, B1c, B2c, s[n])
  */
 
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(k,n)
+#endif
   for (j=js-1; j<=je+1; j++) {
     for (i=is-1; i<=ie+1; i++) {
       for (k=kl; k<=ku; k++) {
@@ -947,6 +1021,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef H_CORRECTION
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,Bx,cfr,cfl,lambdar,lambdal)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=iu; i++) {
@@ -962,6 +1039,9 @@ void integrate_3d_vl(DomainS *pD)
     }
   }
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,Bx,cfr,cfl,lambdar,lambdal)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=ju; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -977,6 +1057,9 @@ void integrate_3d_vl(DomainS *pD)
     }
   }
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,Bx,cfr,cfl,lambdar,lambdal)
+#endif
   for (k=ks-1; k<=ku; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -997,6 +1080,13 @@ void integrate_3d_vl(DomainS *pD)
  * Compute second-order fluxes in x1-direction
  */
 
+#ifdef OPENMP
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#pragma omp parallel for collapse(2) private(i,Bx) reduction(+:NaNFlux)
+#else
+#pragma omp parallel for collapse(2) private(i,Bx)
+#endif
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is; i<=ie+1; i++) {
@@ -1047,6 +1137,13 @@ void integrate_3d_vl(DomainS *pD)
  * Compute second-order fluxes in x2-direction
  */
 
+#ifdef OPENMP
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#pragma omp parallel for collapse(2) private(i,Bx) reduction(+:NaNFlux)
+#else
+#pragma omp parallel for collapse(2) private(i,Bx)
+#endif
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -1097,6 +1194,13 @@ void integrate_3d_vl(DomainS *pD)
  * Compute second-order fluxes in x3-direction
  */
 
+#ifdef OPENMP
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#pragma omp parallel for collapse(2) private(i,Bx) reduction(+:NaNFlux)
+#else
+#pragma omp parallel for collapse(2) private(i,Bx)
+#endif
+#endif
   for (k=ks; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -1157,6 +1261,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,Whalf)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -1266,6 +1373,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP
+#pragma omp parallel for private(i,j) firstprivate(lsf,rsf,dtodx2)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -1296,6 +1406,9 @@ void integrate_3d_vl(DomainS *pD)
         dtodx3*(emf1[k+1][je+1][i  ] - emf1[k][je+1][i]);
     }
   }
+#ifdef OPENMP
+#pragma omp parallel for private(i) firstprivate(lsf,rsf,dtodx2)
+#endif
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
@@ -1312,6 +1425,9 @@ void integrate_3d_vl(DomainS *pD)
  * Set cell centered magnetic fields to average of updated face centered fields.
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j) firstprivate(lsf,rsf)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -1339,6 +1455,10 @@ void integrate_3d_vl(DomainS *pD)
 #ifdef SHEARING_BOX
   fact = om_dt/(2. + (2.-qshear)*om_dt*om_dt);
   qom = qshear*Omega_0;
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,x1,x2,x3,M1n,dM2n,M1e,dM2e,phic,phir,phil, \
+  frx1_dM2,flx1_dM2,frx2_dM2,flx2_dM2,frx3_dM2,flx3_dM2)
+#endif
   for(k=ks; k<=ke; k++) {
     for(j=js; j<=je; j++) {
       for(i=is; i<=ie; i++) {
@@ -1420,6 +1540,10 @@ void integrate_3d_vl(DomainS *pD)
 
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,x1,x2,x3,phic,phir,phil,g) \
+  firstprivate(lsf,rsf,dtodx2)
+#endif
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
@@ -1471,6 +1595,10 @@ void integrate_3d_vl(DomainS *pD)
 #ifdef SELF_GRAVITY
 /* Add fluxes and source terms due to (d/dx1) terms  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,phic,phir,phil,gxl,gxr,gyl,gyr,gzl,gzr, \
+  flx_m1l,flx_m1r,flx_m2l,flx_m2r,flx_m3l,flx_m3r)
+#endif
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
@@ -1516,6 +1644,10 @@ void integrate_3d_vl(DomainS *pD)
 
 /* Add fluxes and source terms due to (d/dx2) terms  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,phic,phir,phil,gxl,gxr,gyl,gyr,gzl,gzr, \
+  flx_m1l,flx_m1r,flx_m2l,flx_m2r,flx_m3l,flx_m3r)
+#endif
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
@@ -1561,6 +1693,10 @@ void integrate_3d_vl(DomainS *pD)
 
 /* Add fluxes and source terms due to (d/dx3) terms  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,phic,phir,phil,gxl,gxr,gyl,gyr,gzl,gzr, \
+  flx_m1l,flx_m1r,flx_m2l,flx_m2r,flx_m3l,flx_m3r)
+#endif
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
@@ -1606,6 +1742,9 @@ void integrate_3d_vl(DomainS *pD)
 
 /* Save mass fluxes in Grid structure for source term correction in main loop */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j)
+#endif
   for (k=ks; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
       for (i=is; i<=ie+1; i++) {
@@ -1623,6 +1762,13 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef CYLINDRICAL
+#ifdef OPENMP
+#ifdef FARGO
+#pragma omp parallel for private(i,j,Ekin,Emag,Ptot,B2sq,Om,qshear)
+#else
+#pragma omp parallel for private(i,j,Ekin,Emag,Ptot,B2sq)
+#endif
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -1664,6 +1810,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables in pG using 3D x1-Fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,n) firstprivate(lsf,rsf)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -1690,6 +1839,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables in pG using 3D x2-Fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,n) firstprivate(dtodx2)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -1716,6 +1868,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables in pG using 3D x3-Fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,n)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -2083,7 +2238,7 @@ void integrate_3d_vl(DomainS *pD)
  *  \brief Allocate temporary integration arrays */
 void integrate_init_3d(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,ierr=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -2143,9 +2298,6 @@ void integrate_init_3d(MeshS *pM)
   if ((Wr_x3Face=(Prim1DS***)calloc_3d_array(size3,size2,size1,sizeof(Prim1DS)))
     == NULL) goto on_error;
 
-  if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
-  if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
-
 #ifdef MHD
   if ((B1_x1Face = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))
     == NULL) goto on_error;
@@ -2155,12 +2307,21 @@ void integrate_init_3d(MeshS *pM)
     == NULL) goto on_error;
 #endif /* MHD */
 
-  if ((U1d = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((Ul  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((Ur  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((W1d = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wl  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wr  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
+/* Each OpenMP thread allocates its own (threadprivate) 1D scratch vectors */
+#ifdef OPENMP
+#pragma omp parallel reduction(+:ierr)
+#endif
+  {
+    if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) ierr++;
+    if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) ierr++;
+    if ((U1d = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) ierr++;
+    if ((Ul  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) ierr++;
+    if ((Ur  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) ierr++;
+    if ((W1d = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) ierr++;
+    if ((Wl  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) ierr++;
+    if ((Wr  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) ierr++;
+  }
+  if (ierr > 0) goto on_error;
 
   if ((x1Flux = (Cons1DS***)calloc_3d_array(size3,size2,size1, sizeof(Cons1DS)))
     == NULL) goto on_error;
@@ -2232,20 +2393,28 @@ void integrate_destruct_3d(void)
   if (Wl_x3Face != NULL) free_3d_array(Wl_x3Face);
   if (Wr_x3Face != NULL) free_3d_array(Wr_x3Face);
 
-  if (Bxc != NULL) free(Bxc);
-  if (Bxi != NULL) free(Bxi);
 #ifdef MHD
   if (B1_x1Face != NULL) free_3d_array(B1_x1Face);
   if (B2_x2Face != NULL) free_3d_array(B2_x2Face);
   if (B3_x3Face != NULL) free_3d_array(B3_x3Face);
 #endif /* MHD */
 
-  if (U1d != NULL) free(U1d);
-  if (Ul  != NULL) free(Ul);
-  if (Ur  != NULL) free(Ur);
-  if (W1d != NULL) free(W1d);
-  if (Wl  != NULL) free(Wl);
-  if (Wr  != NULL) free(Wr);
+#ifdef OPENMP
+#pragma omp parallel
+#endif
+  {
+    if (Bxc != NULL) free(Bxc);
+    if (Bxi != NULL) free(Bxi);
+    if (U1d != NULL) free(U1d);
+    if (Ul  != NULL) free(Ul);
+    if (Ur  != NULL) free(Ur);
+    if (W1d != NULL) free(W1d);
+    if (Wl  != NULL) free(Wl);
+    if (Wr  != NULL) free(Wr);
+    Bxc = NULL;  Bxi = NULL;
+    U1d = NULL;  Ul = NULL;  Ur = NULL;
+    W1d = NULL;  Wl = NULL;  Wr = NULL;
+  }
 
   if (x1Flux  != NULL) free_3d_array(x1Flux);
   if (x2Flux  != NULL) free_3d_array(x2Flux);
@@ -2300,6 +2469,9 @@ static void integrate_emf1_corner(const GridS *pG)
   jl = pG->js-(nghost-1);   ju = pG->je+(nghost-1);
   kl = pG->ks-(nghost-1);   ku = pG->ke+(nghost-1);
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,de1_l2,de1_r2,de1_l3,de1_r3)
+#endif
   for (k=kl; k<=ku+1; k++) {
     for (j=jl; j<=ju+1; j++) {
       for (i=il; i<=iu; i++) {
@@ -2373,6 +2545,9 @@ static void integrate_emf2_corner(const GridS *pG)
   jl = pG->js-(nghost-1);   ju = pG->je+(nghost-1);
   kl = pG->ks-(nghost-1);   ku = pG->ke+(nghost-1);
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,de2_l1,de2_r1,de2_l3,de2_r3)
+#endif
   for (k=kl; k<=ku+1; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu+1; i++) {
@@ -2447,6 +2622,9 @@ static void integrate_emf3_corner(const GridS *pG)
   jl = pG->js-(nghost-1);   ju = pG->je+(nghost-1);
   kl = pG->ks-(nghost-1);   ku = pG->ke+(nghost-1);
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,de3_l1,de3_r1,de3_l2,de3_r2)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju+1; j++) {
       for (i=il; i<=iu+1; i++) {
@@ -10,6 +10,28 @@
  *    - B1i, B2i, B3i  -- interface magnetic field
  *   Also adds gravitational source terms, self-gravity, and the H-correction
  *   of Sanders et al.
+ *   The fluxes are computed one pencil of interfaces at a time with
+ *   fluxes_pencil(), along x1 for the second-order fluxes, and the
+ *   primitives are recovered one x1 row at a time with Cons_to_Prim_pencil()
+ *   and check_Prim_pencil(), from those of the previous (half) step with
+ *   <time>/warm_start = 1.  With the first-order flux correction, the
+ *   primitives at t^{n+1} of its final check are kept for the next step, in
+ *   which only the cells whose U has changed since are inverted again.
+ *   With OpenMP, the outer loops over k (or k,j) of the sweeps are shared
+ *   among the threads, each with its own 1D scratch vectors.  The first-order
+ *   flux correction of single cells (FixCell) and the SMR steps stay serial.
+ *   The active cells are inverted before the split-phase boundary exchange
+ *   started by bvals_mhd_start() at the end of the previous step is
+ *   completed, so that the inversion overlaps the messages in flight.
+ *   With <time>/tile > 0, integrate_3d_vl_tiled() sweeps the grid in tiles
+ *   of tile*tile cells in x2 and x3 (with full x1 pencils): the interface
+ *   states, fluxes and emfs then only span one tile and its ghost zones, and
+ *   only Uhalf, Whalf and the half-step interface fields span the grid.
+ *   With <time>/lean = 1, the L/R states at t^{n+1/2} are computed one
+ *   pencil at a time just before their fluxes, and the cell-centered emfs
+ *   when they are integrated to the corners, so that neither is stored
+ *   (9 fewer 3D arrays for mhd).  The memory allocated by integrate_init_3d()
+ *   is reported at startup.
  *   - For adb hydro, requires (9*Cons1DS + 3*Real + 1*ConsS) = 53 3D arrays
  *   - For adb mhd, requires   (9*Cons1DS + 9*Real + 1*ConsS) = 80 3D arrays
  *
@@ -23,6 +45,7 @@
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - integrate_3d_vl()
+ * - integrate_3d_vl_tiled()
  * - integrate_destruct_3d()
  * - integrate_init_3d() */
 /*============================================================================*/
@@ -73,10 +96,21 @@ static Real ***emf1=NULL, ***emf2=NULL, ***emf3=NULL;
 static Real ***emf1_cc=NULL, ***emf2_cc=NULL, ***emf3_cc=NULL;
 #endif /* MHD */
 
-/* 1D scratch vectors used by lr_states and flux functions */
+/* 1D scratch vectors used by lr_states and flux functions, one set per
+ * OpenMP thread */
 static Real *Bxc=NULL, *Bxi=NULL;
 static Prim1DS *W1d=NULL, *Wl=NULL, *Wr=NULL;
 static Cons1DS *U1d=NULL, *Ul=NULL, *Ur=NULL;
+#ifdef OPENMP
+#pragma omp threadprivate(Bxc,Bxi,W1d,Wl,Wr,U1d,Ul,Ur)
+#endif
+
+/* the passive scalar index n is only declared (and private) with scalars */
+#if (NSCALARS > 0)
+#define SCAL_PRIVATE ,n
+#else
+#define SCAL_PRIVATE
+#endif
 
 /* primitive variables at t^{n} computed in predict step */
 static PrimS ***W=NULL;
@@ -85,6 +119,51 @@ static PrimS ***W=NULL;
 static ConsS ***Uhalf=NULL;
 static PrimS ***Whalf=NULL;
 
+/* With <time>/tile > 0, the arrays above only span one tile, and Uhalf, Whalf
+ * and B?_x?Face are tables of rows (views) in the grid arrays *_grid, or in
+ * the tile arrays *_tile outside the tile in the predict step.  U_view and
+ * B?i_view are views of pG->U and pG->B?i. */
+static int tile=0, tsize2=0, tsize3=0;
+
+/* With <time>/warm_start = 1, the inversions at t^{n} and t^{n+1/2} start
+ * from Whalf of the previous step and from W respectively */
+static int warm_start=0;
+
+/* With the first-order flux correction (and without SMR, where the arrays are
+ * shared by the Grids of all levels), Step 15b inverts U at t^{n+1}, and the
+ * result is kept in W for the next step, with the U it belongs to in Uhalf.
+ * Step 0 then only inverts the ghost cells and the cells whose U has changed
+ * since (boundary conditions, operator-split source terms, userwork).  Wkept
+ * is 1 once Step 15b has run. */
+#if defined(FIRST_ORDER_FLUX_CORRECTION) && defined(MHD) && !defined(STATIC_MESH_REFINEMENT)
+#define KEEP_PRIM
+static int Wkept=0;
+#endif
+static ConsS ***Uhalf_grid=NULL, ***Uhalf_tile=NULL, ***U_view=NULL;
+static PrimS ***Whalf_grid=NULL, ***Whalf_tile=NULL;
+#ifdef MHD
+static Real ***B1_x1Face_grid=NULL,***B2_x2Face_grid=NULL,***B3_x3Face_grid=NULL;
+static Real ***B1_x1Face_tile=NULL,***B2_x2Face_tile=NULL,***B3_x3Face_tile=NULL;
+static Real ***B1i_view=NULL, ***B2i_view=NULL, ***B3i_view=NULL;
+#endif /* MHD */
+
+/* With <time>/lean = 1, the L/R states at t^{n+1/2} are computed pencil by
+ * pencil just before the fluxes (lean_pencil()), and the cell-centered emfs
+ * are computed in integrate_emf?_corner() from the primitives Wcc (W or
+ * Whalf), so that neither is stored for the whole grid.  nbytes is the memory
+ * of the 3D arrays allocated by integrate_init_3d(). */
+static int lean=0;
+static double nbytes=0.0;
+#ifdef MHD
+static PrimS ***Wcc=NULL;
+#define EMF1_CC(k,j,i) (lean ? (Wcc[k][j][i].B2c*Wcc[k][j][i].V3 - \
+  Wcc[k][j][i].B3c*Wcc[k][j][i].V2) : emf1_cc[k][j][i])
+#define EMF2_CC(k,j,i) (lean ? (Wcc[k][j][i].B3c*Wcc[k][j][i].V1 - \
+  Wcc[k][j][i].B1c*Wcc[k][j][i].V3) : emf2_cc[k][j][i])
+#define EMF3_CC(k,j,i) (lean ? (Wcc[k][j][i].B1c*Wcc[k][j][i].V2 - \
+  Wcc[k][j][i].B2c*Wcc[k][j][i].V1) : emf3_cc[k][j][i])
+#endif /* MHD */
+
 /* variables needed for H-correction of Sanders et al (1998) */
 extern Real etah;
 #ifdef H_CORRECTION
@@ -98,6 +177,13 @@ static Real ***eta1=NULL, ***eta2=NULL, ***eta3=NULL;
  *   integrate_emf2_corner() - upwind CT method of GS (2005) for emf2 
  *   integrate_emf3_corner() - upwind CT method of GS (2005) for emf3
  *   FixCell() - apply first-order correction to one cell
+ *   vl_predict() - predict step to t^{n+1/2} (Steps 1-7)
+ *   vl_correct() - correct step to t^{n+1} (Steps 8-16)
+ *   lean_fluxes() - Steps 8-11 one pencil at a time, with <time>/lean = 1
+ *   lean_pencil() - L/R states and fluxes of one pencil of interfaces
+ *   tile_grid()  - sets up the Grid and the views of one tile
+ *   tile_view()  - points the rows of a view to a grid or tile array
+ *   alloc_3d()   - calloc_3d_array() adding the size to nbytes
  *============================================================================*/
 #ifdef MHD
 static void integrate_emf1_corner(const GridS *pG);
@@ -107,6 +193,16 @@ static void integrate_emf3_corner(const GridS *pG);
 #ifdef FIRST_ORDER_FLUX_CORRECTION
 static void FixCell(GridS *pG, Int3Vect);
 #endif
+static void vl_predict(GridS *pG, DomainS *pD);
+static void vl_correct(GridS *pG, int ox2, int ox3);
+static void lean_fluxes(GridS *pG, int il, int iu, int jl, int ju,
+                        int kl, int ku);
+static int lean_pencil(GridS *pG, const int dir, int k, int j, int i,
+                       const int nl, const int nu);
+static void tile_grid(GridS *pG, GridS *pT, int tk, int tj, int predict);
+static void tile_view(void ***v, void ***a, void ***t, int ko, int jo,
+                      int kl, int ku, int jl, int ju);
+static void *alloc_3d(int nt, int nr, int nc, size_t size);
 
 /*=========================== PUBLIC FUNCTIONS ===============================*/
 /*----------------------------------------------------------------------------*/
@@ -116,34 +212,103 @@ static void FixCell(GridS *pG, Int3Vect);
 void integrate_3d_vl(DomainS *pD)
 {
   GridS *pG=(pD->Grid);
-  Real dtodx1=pG->dt/pG->dx1, dtodx2=pG->dt/pG->dx2, dtodx3=pG->dt/pG->dx3;
-  Real q1 = 0.5*dtodx1, q2 = 0.5*dtodx2, q3 = 0.5*dtodx3;
-  Real dt = pG->dt, hdt = 0.5*pG->dt;
+
+#ifdef PARTICLES
+  /* give particles access to half-step quantities */
+  pG->Uhalf = Uhalf;
+  pG->Whalf = Whalf;
+#endif /* PARTICLES */
+
+  vl_predict(pG, pD);
+
+/*=== STEP 7.5: Integrate the particles ======================================*/
+/* With back-reaction, their charge, current and energy density are first
+ * deposited at their half-step position, and the source terms of the
+ * back-reaction are added to pG->U for a full timestep */
+
+#ifdef PARTICLES
+  cr_deposit(pD);
+  Integrate_Particles(pD);
+  cr_source_terms(pD, pG->dt);
+#endif /* PARTICLES */
+
+  vl_correct(pG, 1, 1);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void integrate_3d_vl_tiled(DomainS *pD)
+ *  \brief integrate_3d_vl() in tiles of <time>/tile cells in x2 and x3.
+ *
+ *   The predict step is done tile by tile, each tile with its ghost zones.
+ *   Uhalf, Whalf and B?_x?Face are written to the grid arrays only in the
+ *   tile itself (and in the ghost zones of the Grid for the tiles at its
+ *   edges), so each value is that of the untiled integrator.  The correct
+ *   step then reads them in the ghost zones of the tile from the grid
+ *   arrays.  It is done from the last tile down, so that the interface
+ *   fields at the outer x2 and x3 edges of a tile are updated (by the next
+ *   tile) before the cell-centred fields are set from them in Step 12d.
+ */
+void integrate_3d_vl_tiled(DomainS *pD)
+{
+  GridS *pG=(pD->Grid), tG;
+  int tj, ntj = (pG->Nx[1] + tile - 1)/tile;
+  int tk, ntk = (pG->Nx[2] + tile - 1)/tile;
+
+  bvals_mhd_finish(pD);
+
+  for (tk=0; tk<ntk; tk++) {
+    for (tj=0; tj<ntj; tj++) {
+      tile_grid(pG, &tG, tk, tj, 1);
+      vl_predict(&tG, NULL);
+    }
+  }
+
+/*=== STEP 7.5: Integrate the particles ======================================*/
+
+#ifdef PARTICLES
+  pG->Uhalf = Uhalf_grid;
+  pG->Whalf = Whalf_grid;
+  cr_deposit(pD);
+  Integrate_Particles(pD);
+  cr_source_terms(pD, pG->dt);
+#endif /* PARTICLES */
+
+  for (tk=ntk-1; tk>=0; tk--) {
+    for (tj=ntj-1; tj>=0; tj--) {
+      tile_grid(pG, &tG, tk, tj, 0);
+      vl_correct(&tG, (tj == ntj-1), (tk == ntk-1));
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void vl_predict(GridS *pG, DomainS *pD)
+ *  \brief Predict step of the 3D van Leer integrator: first-order update of
+ *   the cells and ghost cells to Uhalf, Whalf at t^{n+1/2}.  The boundary
+ *   exchange of Domain pD (if not NULL) is completed in Step 0 */
+static void vl_predict(GridS *pG, DomainS *pD)
+{
+  Real q1 = 0.5*pG->dt/pG->dx1, q2 = 0.5*pG->dt/pG->dx2;
+  Real q3 = 0.5*pG->dt/pG->dx3;
   int i, is = pG->is, ie = pG->ie;
   int j, js = pG->js, je = pG->je;
   int k, ks = pG->ks, ke = pG->ke;
-  int cart_x1 = 1, cart_x2 = 2, cart_x3 = 3;
-  Real x1,x2,x3,phicl,phicr,phifc,phil,phir,phic,Bx;
+  Real x1,x2,x3,phil,phir,phic;
 #if (NSCALARS > 0)
   int n;
 #endif
-#ifdef SELF_GRAVITY
-  Real gxl,gxr,gyl,gyr,gzl,gzr,flx_m1l,flx_m1r,flx_m2l,flx_m2r,flx_m3l,flx_m3r;
-#endif
-#ifdef H_CORRECTION
-  Real cfr,cfl,lambdar,lambdal;
-#endif
-#ifdef STATIC_MESH_REFINEMENT
-  int ncg,npg,dim;
-  int ii,ics,ice,jj,jcs,jce,kk,kcs,kce,ips,ipe,jps,jpe,kps,kpe;
+#ifdef KEEP_PRIM
+  int i0;
 #endif
 #ifdef FIRST_ORDER_FLUX_CORRECTION
   int flag_cell=0,negd=0,negP=0,superl=0,NaNFlux=0;
-  int entropy,final,fail;
+  int entropy;
   Real Vsq;
-  ConsS Ucheck;
   PrimS Wcheck;
-  Int3Vect BadCell;
 #endif
 
   /* With particles, one more ghost cell must be updated in predict step */
@@ -156,20 +321,64 @@ void integrate_3d_vl(DomainS *pD)
   int jl=js-(nghost-1), ju=je+(nghost-1);
   int kl=ks-(nghost-1), ku=ke+(nghost-1);
   #endif // PARTICLES
-  #ifdef PARTICLES
-  // give particles access to half-step quantities
-  pG->Uhalf = Uhalf;
-  pG->Whalf = Whalf;
-  #endif //PARTICLES
 
 /* Set etah=0 so first calls to flux functions do not use H-correction */
+#ifdef OPENMP
+#pragma omp parallel
+#endif
   etah = 0.0;
 
+/*=== STEP 0: Compute the primitives at t^{n} ================================*/
+/* The active cells are inverted first, while the ghost zones of a pending
+ * split-phase boundary exchange (bvals_mhd_start()) may still be in flight,
+ * and the ghost cells once the exchange is completed */
+
+#if defined(OPENMP) && defined(KEEP_PRIM)
+#pragma omp parallel for collapse(2) private(i,i0)
+#elif defined(OPENMP)
+#pragma omp parallel for collapse(2)
+#endif
+  for (k=ks; k<=ke; k++) {
+    for (j=js; j<=je; j++) {
+#ifdef KEEP_PRIM
+      if (Wkept) {
+        i = is;
+        while (i <= ie) {
+          if (memcmp(&(Uhalf[k][j][i]),&(pG->U[k][j][i]),sizeof(ConsS)) == 0){
+            i++;
+            continue;
+          }
+          i0 = i;
+          while (i <= ie &&
+            memcmp(&(Uhalf[k][j][i]),&(pG->U[k][j][i]),sizeof(ConsS)) != 0)
+            i++;
+          Cons_to_Prim_pencil(i0, i-1, pG->U[k][j], W[k][j],
+                              (warm_start ? Whalf[k][j] : NULL));
+        }
+      } else
+#endif /* KEEP_PRIM */
+      Cons_to_Prim_pencil(is, ie, pG->U[k][j], W[k][j],
+                          (warm_start ? Whalf[k][j] : NULL));
+    }
+  }
+
+  if (pD != NULL) bvals_mhd_finish(pD);
+
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(i)
+#endif
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
+      if (k >= ks && k <= ke && j >= js && j <= je) {
+        Cons_to_Prim_pencil(is-nghost, is-1, pG->U[k][j], W[k][j],
+                            (warm_start ? Whalf[k][j] : NULL));
+        Cons_to_Prim_pencil(ie+1, ie+nghost, pG->U[k][j], W[k][j],
+                            (warm_start ? Whalf[k][j] : NULL));
+      } else
+        Cons_to_Prim_pencil(is-nghost, ie+nghost, pG->U[k][j], W[k][j],
+                            (warm_start ? Whalf[k][j] : NULL));
       for (i=is-nghost; i<=ie+nghost; i++) {
         Uhalf[k][j][i] = pG->U[k][j][i];
-        W[k][j][i] = Cons_to_Prim(&(pG->U[k][j][i]));
         #ifdef USE_ENTROPY_FIX
         S[k][j][i] = W[k][j][i].P * pow(W[k][j][i].d,1.0-Gamma);
         S[k][j][i]*= pG->U[k][j][i].d / W[k][j][i].d;
@@ -192,6 +401,9 @@ void integrate_3d_vl(DomainS *pD)
  * W1d = (d, V1, V2, V3, P, B2c, B3c, s[n])
  */
 
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(i SCAL_PRIVATE)
+#endif
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
@@ -231,12 +443,12 @@ void integrate_3d_vl(DomainS *pD)
 /*--- Step 1d ------------------------------------------------------------------
  * Compute flux in x1-direction */
 
-      for (i=il; i<=ie+nghost; i++) {
-        fluxes(Ul[i],Ur[i],Wl[i],Wr[i],Bxi[i],&x1Flux[k][j][i]);
+      fluxes_pencil(il,ie+nghost,Ul,Ur,Wl,Wr,Bxi,x1Flux[k][j]);
 #ifdef USE_ENTROPY_FIX
+      for (i=il; i<=ie+nghost; i++) {
 	entropy_flux(Ul[i],Ur[i],Wl[i],Wr[i],Bxi[i],&x1FluxS[k][j][i]);
-#endif
       }
+#endif
     }
   }
 
@@ -248,6 +460,9 @@ void integrate_3d_vl(DomainS *pD)
  * W1d = (d, V2, V3, V1, P, B3c, B1c, s[n])
  */
 
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(j SCAL_PRIVATE)
+#endif
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
       for (j=js-nghost; j<=je+nghost; j++) {
@@ -287,8 +502,9 @@ void integrate_3d_vl(DomainS *pD)
 /*--- Step 2d ------------------------------------------------------------------
  * Compute flux in x2-direction */
 
+      fluxes_pencil(jl,je+nghost,Ul,Ur,Wl,Wr,Bxi,U1d);
       for (j=jl; j<=je+nghost; j++) {
-        fluxes(Ul[j],Ur[j],Wl[j],Wr[j],Bxi[j],&x2Flux[k][j][i]);
+        x2Flux[k][j][i] = U1d[j];
 #ifdef USE_ENTROPY_FIX
 	entropy_flux(Ul[j],Ur[j],Wl[j],Wr[j],Bxi[j],&x2FluxS[k][j][i]);
 #endif
@@ -305,6 +521,9 @@ void integrate_3d_vl(DomainS *pD)
  * W1d = (d, V3, V1, V2, P, B1c, B2c, s[n])
  */
 
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(k SCAL_PRIVATE)
+#endif
   for (j=js-nghost; j<=je+nghost; j++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
       for (k=ks-nghost; k<=ke+nghost; k++) {
@@ -344,8 +563,9 @@ void integrate_3d_vl(DomainS *pD)
 /*--- Step 3d ------------------------------------------------------------------
  * Compute flux in x1-direction */
 
+      fluxes_pencil(kl,ke+nghost,Ul,Ur,Wl,Wr,Bxi,U1d);
       for (k=kl; k<=ke+nghost; k++) {
-        fluxes(Ul[k],Ur[k],Wl[k],Wr[k],Bxi[k],&x3Flux[k][j][i]);
+        x3Flux[k][j][i] = U1d[k];
 #ifdef USE_ENTROPY_FIX
 	entropy_flux(Ul[k],Ur[k],Wl[k],Wr[k],Bxi[k],&x3FluxS[k][j][i]);
 #endif
@@ -361,15 +581,22 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef MHD
-  for (k=ks-nghost; k<=ke+nghost; k++) {
-    for (j=js-nghost; j<=je+nghost; j++) {
-      for (i=is-nghost; i<=ie+nghost; i++) {
-        emf1_cc[k][j][i] = (W[k][j][i].B2c*W[k][j][i].V3 - 
-			    W[k][j][i].B3c*W[k][j][i].V2);
-        emf2_cc[k][j][i] = (W[k][j][i].B3c*W[k][j][i].V1 -
-			    W[k][j][i].B1c*W[k][j][i].V3);
-        emf3_cc[k][j][i] = (W[k][j][i].B1c*W[k][j][i].V2 -
-			    W[k][j][i].B2c*W[k][j][i].V1);
+  if (lean) {
+    Wcc = W;
+  } else {
+#ifdef OPENMP
+#pragma omp parallel for private(i,j)
+#endif
+    for (k=ks-nghost; k<=ke+nghost; k++) {
+      for (j=js-nghost; j<=je+nghost; j++) {
+        for (i=is-nghost; i<=ie+nghost; i++) {
+          emf1_cc[k][j][i] = (W[k][j][i].B2c*W[k][j][i].V3 - 
+			      W[k][j][i].B3c*W[k][j][i].V2);
+          emf2_cc[k][j][i] = (W[k][j][i].B3c*W[k][j][i].V1 -
+			      W[k][j][i].B1c*W[k][j][i].V3);
+          emf3_cc[k][j][i] = (W[k][j][i].B1c*W[k][j][i].V2 -
+			      W[k][j][i].B2c*W[k][j][i].V1);
+        }
       }
     }
   }
@@ -381,6 +608,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update the interface magnetic fields using CT for a half time step.
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -399,6 +629,9 @@ void integrate_3d_vl(DomainS *pD)
                                q3*(emf1[k+1][ju+1][i  ]-emf1[k][ju+1][i]);
     }
   }
+#ifdef OPENMP
+#pragma omp parallel for private(i)
+#endif
   for (j=jl; j<=ju; j++) {
     for (i=il; i<=iu; i++) {
       B3_x3Face[ku+1][j][i] += q2*(emf1[ku+1][j+1][i  ]-emf1[ku+1][j][i]) -
@@ -411,6 +644,9 @@ void integrate_3d_vl(DomainS *pD)
  * face-centered fields.
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -428,6 +664,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables to half-timestep using x1-fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j SCAL_PRIVATE)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -454,6 +693,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables to half-timestep using x2-fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j SCAL_PRIVATE)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -480,6 +722,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables to half-timestep using x3-fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j SCAL_PRIVATE)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -508,6 +753,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
   NaNFlux = 0;
+#ifdef OPENMP
+#pragma omp parallel for private(i,j) reduction(+:NaNFlux)
+#endif
   for (k=ks; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
       for (i=is; i<=ie+1; i++) {
@@ -586,6 +834,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,x1,x2,x3,phic,phir,phil)
+#endif
     for (k=kl; k<=ku; k++) {
       for (j=jl; j<=ju; j++) {
         for (i=il; i<=iu; i++) {
@@ -633,25 +884,29 @@ void integrate_3d_vl(DomainS *pD)
   negd = 0;
   negP = 0;
   superl = 0;
+  entropy = 0;
   flag_cell = 0;
+#endif
+#ifdef OPENMP
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#pragma omp parallel for collapse(2) private(i,Vsq,Wcheck) firstprivate(flag_cell) \
+  reduction(+:negd,negP,superl,entropy)
+#else
+#pragma omp parallel for collapse(2) private(i)
+#endif
 #endif
   for (k=ks-nghost; k<=ke+nghost; k++) {
-    for (i=is-nghost; i<=ie+nghost; i++) {
-      for (j=js-nghost; j<=je+nghost; j++) {
-	Whalf[k][j][i] = check_Prim(&(Uhalf[k][j][i]));
+    for (j=js-nghost; j<=je+nghost; j++) {
+      check_Prim_pencil(is-nghost, ie+nghost, Uhalf[k][j], Whalf[k][j],
+                        (warm_start ? W[k][j] : NULL));
 #ifdef FIRST_ORDER_FLUX_CORRECTION
+      for (i=is-nghost; i<=ie+nghost; i++) {
 	if (Whalf[k][j][i].d < 0.0) {
 	  flag_cell = 1;
-	  BadCell.i = i;
-	  BadCell.j = j;
-	  BadCell.k = ks;
 	  negd++;
 	}
 	if (Whalf[k][j][i].P < 0.0) {
 	  flag_cell = 1;
-	  BadCell.i = i;
-	  BadCell.j = j;
-	  BadCell.k = ks;
 	  negP++;
 	}
 	Vsq = SQR(Whalf[k][j][i].V1) +
@@ -659,9 +914,6 @@ void integrate_3d_vl(DomainS *pD)
 	      SQR(Whalf[k][j][i].V3);
 	if (Vsq > 1.0) {
 	  flag_cell = 1;
-	  BadCell.i = i;
-	  BadCell.j = j;
-	  BadCell.k = ks;
 	  superl++;
 	}
 	if (flag_cell != 0) {
@@ -688,8 +940,8 @@ void integrate_3d_vl(DomainS *pD)
 	}
 #endif /* USE_ENTROPY_FIX */
 	}
-#endif
       }
+#endif
     }
   }
 
@@ -703,12 +955,65 @@ void integrate_3d_vl(DomainS *pD)
   }
 #endif 
 
+  return;
+}
 
-/*=== STEP 7.5: Integrate the particles ======================================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static void vl_correct(GridS *pG, int ox2, int ox3)
+ *  \brief Correct step of the 3D van Leer integrator: second-order update of
+ *   pG->U and pG->B?i with the fluxes from Whalf.  The interface fields at
+ *   the outer x2 (x3) edge, pG->B2i[][je+1][] (pG->B3i[ke+1][][]), are only
+ *   updated if ox2 (ox3) is set; otherwise they belong to the next tile. */
+static void vl_correct(GridS *pG, int ox2, int ox3)
+{
+  Real dtodx1=pG->dt/pG->dx1, dtodx2=pG->dt/pG->dx2, dtodx3=pG->dt/pG->dx3;
+  int i, is = pG->is, ie = pG->ie;
+  int j, js = pG->js, je = pG->je;
+  int k, ks = pG->ks, ke = pG->ke;
+  int cart_x1 = 1, cart_x2 = 2, cart_x3 = 3;
+  Real x1,x2,x3,phil,phir,phic,Bx;
+#if (NSCALARS > 0)
+  int n;
+#endif
+#ifdef SELF_GRAVITY
+  Real gxl,gxr,gyl,gyr,gzl,gzr,flx_m1l,flx_m1r,flx_m2l,flx_m2r,flx_m3l,flx_m3r;
+#endif
+#ifdef H_CORRECTION
+  Real cfr,cfl,lambdar,lambdal;
+#endif
+#ifdef STATIC_MESH_REFINEMENT
+  int ncg,npg,dim;
+  int ii,ics,ice,jj,jcs,jce,kk,kcs,kce,ips,ipe,jps,jpe,kps,kpe;
+#endif
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+  int flag_cell=0,negd=0,negP=0,superl=0,NaNFlux=0;
+  int entropy,final,fail;
+  Real Vsq;
+#ifdef KEEP_PRIM
+  int keep;
+#endif
+  ConsS Ucheck;
+  PrimS Wcheck;
+  Int3Vect BadCell;
+#endif
 
+
+  /* With particles, one more ghost cell must be updated in predict step */
   #ifdef PARTICLES
-    Integrate_Particles(pD);
-  #endif
+  int il=is-nghost, iu=ie+nghost;
+  int jl=js-nghost, ju=je+nghost;
+  int kl=ks-nghost, ku=ke+nghost;
+  #else
+  int il=is-(nghost-1), iu=ie+(nghost-1);
+  int jl=js-(nghost-1), ju=je+(nghost-1);
+  int kl=ks-(nghost-1), ku=ke+(nghost-1);
+  #endif // PARTICLES
+
+/* With <time>/lean = 1, Steps 8-11 are done by lean_fluxes(), without the
+ * 3D arrays of L/R states */
+  if (lean) {
+    lean_fluxes(pG,il,iu,jl,ju,kl,ku);
+  } else {
 
 /*=== STEP 8: Compute second-order L/R x1-interface states ===================*/
 
@@ -717,6 +1022,13 @@ void integrate_3d_vl(DomainS *pD)
  * W1d = (d, V1, V2, V3, P, B2c, B3c, s[n])
  */
 
+#ifdef OPENMP
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#pragma omp parallel for collapse(2) private(i,Vsq SCAL_PRIVATE)
+#else
+#pragma omp parallel for collapse(2) private(i SCAL_PRIVATE)
+#endif
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=il; i<=iu; i++) {
@@ -772,6 +1084,13 @@ void integrate_3d_vl(DomainS *pD)
  * W1d = (d, V2, V3, V1, P, B3c, B1c, s[n])
  */
 
+#ifdef OPENMP
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#pragma omp parallel for collapse(2) private(j,Vsq SCAL_PRIVATE)
+#else
+#pragma omp parallel for collapse(2) private(j SCAL_PRIVATE)
+#endif
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (i=is-1; i<=ie+1; i++) {
       for (j=jl; j<=ju; j++) {
@@ -827,6 +1146,13 @@ void integrate_3d_vl(DomainS *pD)
  * W1d = (d, V3, V1, V2, P, B1c, B2c, s[n])
  */
 
+#ifdef OPENMP
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#pragma omp parallel for collapse(2) private(k,Vsq SCAL_PRIVATE)
+#else
+#pragma omp parallel for collapse(2) private(k SCAL_PRIVATE)
+#endif
+#endif
   for (j=js-1; j<=je+1; j++) {
     for (i=is-1; i<=ie+1; i++) {
       for (k=kl; k<=ku; k++) {
@@ -934,6 +1260,13 @@ void integrate_3d_vl(DomainS *pD)
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
   NaNFlux = 0.0;
+#endif
+#ifdef OPENMP
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#pragma omp parallel for collapse(2) private(i,Bx) reduction(+:NaNFlux)
+#else
+#pragma omp parallel for collapse(2) private(i,Bx)
+#endif
 #endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
@@ -955,13 +1288,17 @@ void integrate_3d_vl(DomainS *pD)
 #endif
         Ul[i] = Prim1D_to_Cons1D(&Wl_x1Face[k][j][i],&Bx);
         Ur[i] = Prim1D_to_Cons1D(&Wr_x1Face[k][j][i],&Bx);
+        Bxi[i] = Bx;
+      }
+
+      fluxes_pencil(is,ie+1,Ul,Ur,Wl_x1Face[k][j],Wr_x1Face[k][j],Bxi,
+                    x1Flux[k][j]);
 
-        fluxes(Ul[i],Ur[i],Wl_x1Face[k][j][i],Wr_x1Face[k][j][i],Bx,
-               &x1Flux[k][j][i]);
+      for (i=is; i<=ie+1; i++) {
 #ifdef USE_ENTROPY_FIX
 	entropy_flux(Ul[i],             Ur[i],
 		     Wl_x1Face[k][j][i],Wr_x1Face[k][j][i],
-		     Bx,                &x1FluxS[k][j][i]);
+		     Bxi[i],            &x1FluxS[k][j][i]);
 #endif
 
 
@@ -1003,6 +1340,13 @@ void integrate_3d_vl(DomainS *pD)
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
   NaNFlux = 0.0;
+#endif
+#ifdef OPENMP
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#pragma omp parallel for collapse(2) private(i,Bx) reduction(+:NaNFlux)
+#else
+#pragma omp parallel for collapse(2) private(i,Bx)
+#endif
 #endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
@@ -1024,14 +1368,17 @@ void integrate_3d_vl(DomainS *pD)
 #endif
         Ul[i] = Prim1D_to_Cons1D(&Wl_x2Face[k][j][i],&Bx);
         Ur[i] = Prim1D_to_Cons1D(&Wr_x2Face[k][j][i],&Bx);
+        Bxi[i] = Bx;
+      }
 
-        fluxes(Ul[i],Ur[i],Wl_x2Face[k][j][i],Wr_x2Face[k][j][i],Bx,
-               &x2Flux[k][j][i]);
+      fluxes_pencil(is-1,ie+1,Ul,Ur,Wl_x2Face[k][j],Wr_x2Face[k][j],Bxi,
+                    x2Flux[k][j]);
 
+      for (i=is-1; i<=ie+1; i++) {
 #ifdef USE_ENTROPY_FIX
 	entropy_flux(Ul[i],          Ur[i],
 		     Wl_x2Face[k][j][i],Wr_x2Face[k][j][i],
-		     Bx,                &x2FluxS[k][j][i]);
+		     Bxi[i],            &x2FluxS[k][j][i]);
 #endif
 
 
@@ -1073,6 +1420,13 @@ void integrate_3d_vl(DomainS *pD)
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
   NaNFlux = 0.0;
+#endif
+#ifdef OPENMP
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#pragma omp parallel for collapse(2) private(i,Bx) reduction(+:NaNFlux)
+#else
+#pragma omp parallel for collapse(2) private(i,Bx)
+#endif
 #endif
   for (k=ks; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
@@ -1094,14 +1448,17 @@ void integrate_3d_vl(DomainS *pD)
 #endif
         Ul[i] = Prim1D_to_Cons1D(&Wl_x3Face[k][j][i],&Bx);
         Ur[i] = Prim1D_to_Cons1D(&Wr_x3Face[k][j][i],&Bx);
+        Bxi[i] = Bx;
+      }
 
-        fluxes(Ul[i],Ur[i],Wl_x3Face[k][j][i],Wr_x3Face[k][j][i],Bx,
-               &x3Flux[k][j][i]);
+      fluxes_pencil(is-1,ie+1,Ul,Ur,Wl_x3Face[k][j],Wr_x3Face[k][j],Bxi,
+                    x3Flux[k][j]);
 
+      for (i=is-1; i<=ie+1; i++) {
 #ifdef USE_ENTROPY_FIX
 	entropy_flux(Ul[i],          Ur[i],
 		     Wl_x3Face[k][j][i],Wr_x3Face[k][j][i],
-		     Bx,                &x3FluxS[k][j][i]);
+		     Bxi[i],            &x3FluxS[k][j][i]);
 #endif
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
@@ -1135,6 +1492,7 @@ void integrate_3d_vl(DomainS *pD)
     NaNFlux=0;
   }
 #endif
+  } /* lean */
 
 /*=== STEP 12: Update face-centered B for a full timestep ====================*/
         
@@ -1143,15 +1501,22 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef MHD
-  for (k=ks-1; k<=ke+1; k++) {
-    for (j=js-1; j<=je+1; j++) {
-      for (i=is-1; i<=ie+1; i++) {
-        emf1_cc[k][j][i] = (Whalf[k][j][i].B2c*Whalf[k][j][i].V3 - 
-			    Whalf[k][j][i].B3c*Whalf[k][j][i].V2);
-        emf2_cc[k][j][i] = (Whalf[k][j][i].B3c*Whalf[k][j][i].V1 -
-			    Whalf[k][j][i].B1c*Whalf[k][j][i].V3);
-        emf3_cc[k][j][i] = (Whalf[k][j][i].B1c*Whalf[k][j][i].V2 -
-			    Whalf[k][j][i].B2c*Whalf[k][j][i].V1);
+  if (lean) {
+    Wcc = Whalf;
+  } else {
+#ifdef OPENMP
+#pragma omp parallel for private(i,j)
+#endif
+    for (k=ks-1; k<=ke+1; k++) {
+      for (j=js-1; j<=je+1; j++) {
+        for (i=is-1; i<=ie+1; i++) {
+          emf1_cc[k][j][i] = (Whalf[k][j][i].B2c*Whalf[k][j][i].V3 - 
+			      Whalf[k][j][i].B3c*Whalf[k][j][i].V2);
+          emf2_cc[k][j][i] = (Whalf[k][j][i].B3c*Whalf[k][j][i].V1 -
+			      Whalf[k][j][i].B1c*Whalf[k][j][i].V3);
+          emf3_cc[k][j][i] = (Whalf[k][j][i].B1c*Whalf[k][j][i].V2 -
+			      Whalf[k][j][i].B2c*Whalf[k][j][i].V1);
+        }
       }
     }
   }
@@ -1170,6 +1535,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update the interface magnetic fields using CT for a full time step.
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -1184,17 +1552,24 @@ void integrate_3d_vl(DomainS *pD)
         dtodx3*(emf2[k+1][j  ][ie+1] - emf2[k][j][ie+1]) -
         dtodx2*(emf3[k  ][j+1][ie+1] - emf3[k][j][ie+1]);
     }
-    for (i=is; i<=ie; i++) {
-      pG->B2i[k][je+1][i] +=
-        dtodx1*(emf3[k  ][je+1][i+1] - emf3[k][je+1][i]) -
-        dtodx3*(emf1[k+1][je+1][i  ] - emf1[k][je+1][i]);
+    if (ox2) {
+      for (i=is; i<=ie; i++) {
+        pG->B2i[k][je+1][i] +=
+          dtodx1*(emf3[k  ][je+1][i+1] - emf3[k][je+1][i]) -
+          dtodx3*(emf1[k+1][je+1][i  ] - emf1[k][je+1][i]);
+      }
     }
   }
-  for (j=js; j<=je; j++) {
-    for (i=is; i<=ie; i++) {
-      pG->B3i[ke+1][j][i] += 
-        dtodx2*(emf1[ke+1][j+1][i  ] - emf1[ke+1][j][i]) -
-        dtodx1*(emf2[ke+1][j  ][i+1] - emf2[ke+1][j][i]);
+  if (ox3) {
+#ifdef OPENMP
+#pragma omp parallel for private(i)
+#endif
+    for (j=js; j<=je; j++) {
+      for (i=is; i<=ie; i++) {
+        pG->B3i[ke+1][j][i] +=
+          dtodx2*(emf1[ke+1][j+1][i  ] - emf1[ke+1][j][i]) -
+          dtodx1*(emf2[ke+1][j  ][i+1] - emf2[ke+1][j][i]);
+      }
     }
   }
 
@@ -1202,6 +1577,9 @@ void integrate_3d_vl(DomainS *pD)
  * Set cell centered magnetic fields to average of updated face centered fields.
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -1223,6 +1601,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,x1,x2,x3,phic,phir,phil)
+#endif
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
@@ -1263,6 +1644,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables in pG using 3D x1-Fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j SCAL_PRIVATE)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -1289,6 +1673,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables in pG using 3D x2-Fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j SCAL_PRIVATE)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -1315,6 +1702,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables in pG using 3D x3-Fluxes
  */
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j SCAL_PRIVATE)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -1400,10 +1790,20 @@ void integrate_3d_vl(DomainS *pD)
   entropy = 0;
   final = 0;
   fail = 0;
+#if defined(OPENMP) && defined(KEEP_PRIM)
+#pragma omp parallel for private(i,j,Vsq,Wcheck,Ucheck,flag_cell,keep) \
+  reduction(+:negd,negP,superl,entropy,final,fail)
+#elif defined(OPENMP)
+#pragma omp parallel for private(i,j,Vsq,Wcheck,Ucheck,flag_cell) \
+  reduction(+:negd,negP,superl,entropy,final,fail)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 	flag_cell = 0;
+#ifdef KEEP_PRIM
+	keep = 1;
+#endif
         Wcheck = check_Prim(&(pG->U[k][j][i]));
         if (Wcheck.d < 0.0) {
           flag_cell = 1;
@@ -1432,6 +1832,9 @@ void integrate_3d_vl(DomainS *pD)
 	    pG->U[k][j][i].M3 = Ucheck.M3;
 	    pG->U[k][j][i].E = Ucheck.E;
 	    flag_cell = 0;
+#ifdef KEEP_PRIM
+	    keep = 0;
+#endif
 	  }
 	}
 #endif /* USE_ENTROPY_FIX */
@@ -1450,9 +1853,25 @@ void integrate_3d_vl(DomainS *pD)
 	    fail++;
 	  }
 	}
+#ifdef KEEP_PRIM
+/* Wcheck = check_Prim(U) is what Cons_to_Prim() returns for U when it is
+ * above the floors of the latter (and v^2 is safely below 1).  Otherwise
+ * Uhalf is set to differ from U, so that Step 0 inverts U again. */
+	if (keep && Wcheck.d >= SR_DENSITY_FLOOR &&
+	    Wcheck.P >= SR_PRESSURE_FLOOR &&
+	    Vsq < 1.0 - 1.0e-10) {
+	  W[k][j][i] = Wcheck;
+	  Uhalf[k][j][i] = pG->U[k][j][i];
+	} else {
+	  Uhalf[k][j][i].d = -pG->U[k][j][i].d;
+	}
+#endif /* KEEP_PRIM */
       }
     }
   }
+#ifdef KEEP_PRIM
+  Wkept = 1;
+#endif
 
   if (negd > 0 || negP > 0 || superl > 0) {
     printf("[Step15b]: %i cells had d<0; %i cells had P<0;\n",negd,negP);
@@ -1775,7 +2194,8 @@ void integrate_3d_vl(DomainS *pD)
  *  \brief Allocate temporary integration arrays */
 void integrate_init_3d(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,ierr=0;
+  int gsize2=0,gsize3=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -1799,111 +2219,200 @@ void integrate_init_3d(MeshS *pM)
   size3 = size3 + 2*nghost + 1;
   nmax = MAX((MAX(size1,size2)),size3);
 
+/* With <time>/tile > 0, the arrays only span one tile (and its ghost zones)
+ * in x2 and x3, but for those of the half-step values on the grid */
+  warm_start = par_geti_def("time","warm_start",0);
+#ifdef KEEP_PRIM
+  Wkept = 0;
+#endif
+  tile = par_geti_def("time","tile",0);
+  lean = par_geti_def("time","lean",0);
+  nbytes = 0.0;
+#ifdef H_CORRECTION
+  if (lean != 0)
+    ath_error("[integrate_init]: <time>/lean=%d is not supported with the H-correction\n",lean);
+#endif
+  if (tile > 0) {
+#if defined(FIRST_ORDER_FLUX_CORRECTION) || defined(H_CORRECTION)
+    ath_error("[integrate_init]: <time>/tile=%d is not supported with first-order flux correction or the H-correction\n",tile);
+#endif
+#ifdef STATIC_MESH_REFINEMENT
+    ath_error("[integrate_init]: <time>/tile=%d is not supported with SMR\n",
+              tile);
+#endif
+    gsize2 = size2;
+    gsize3 = size3;
+    size2 = MIN(tile, size2 - (2*nghost + 1)) + 2*nghost + 1;
+    size3 = MIN(tile, size3 - (2*nghost + 1)) + 2*nghost + 1;
+    tsize2 = size2;
+    tsize3 = size3;
+  }
+
 #ifdef MHD
-  if ((emf1 = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
+  if ((emf1 = (Real***)alloc_3d(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
-  if ((emf2 = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
+  if ((emf2 = (Real***)alloc_3d(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
-  if ((emf3 = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
+  if ((emf3 = (Real***)alloc_3d(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
 
-  if ((emf1_cc=(Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
-    goto on_error;
-  if ((emf2_cc=(Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
-    goto on_error;
-  if ((emf3_cc=(Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
-    goto on_error;
+/* With <time>/lean = 1, the cell-centered emfs and the L/R states are not
+ * stored */
+  if (lean == 0) {
+    if ((emf1_cc=(Real***)alloc_3d(size3,size2,size1,sizeof(Real)))==NULL)
+      goto on_error;
+    if ((emf2_cc=(Real***)alloc_3d(size3,size2,size1,sizeof(Real)))==NULL)
+      goto on_error;
+    if ((emf3_cc=(Real***)alloc_3d(size3,size2,size1,sizeof(Real)))==NULL)
+      goto on_error;
+  }
 #endif /* MHD */
 #ifdef H_CORRECTION
-  if ((eta1 = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
+  if ((eta1 = (Real***)alloc_3d(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
-  if ((eta2 = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
+  if ((eta2 = (Real***)alloc_3d(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
-  if ((eta3 = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))==NULL)
+  if ((eta3 = (Real***)alloc_3d(size3,size2,size1,sizeof(Real)))==NULL)
     goto on_error;
 #endif /* H_CORRECTION */
-  if ((Wl_x1Face=(Prim1DS***)calloc_3d_array(size3,size2,size1,sizeof(Prim1DS)))
-    == NULL) goto on_error;
-  if ((Wr_x1Face=(Prim1DS***)calloc_3d_array(size3,size2,size1,sizeof(Prim1DS)))
-    == NULL) goto on_error;
-  if ((Wl_x2Face=(Prim1DS***)calloc_3d_array(size3,size2,size1,sizeof(Prim1DS)))
-    == NULL) goto on_error;
-  if ((Wr_x2Face=(Prim1DS***)calloc_3d_array(size3,size2,size1,sizeof(Prim1DS)))
-    == NULL) goto on_error;
-  if ((Wl_x3Face=(Prim1DS***)calloc_3d_array(size3,size2,size1,sizeof(Prim1DS)))
-    == NULL) goto on_error;
-  if ((Wr_x3Face=(Prim1DS***)calloc_3d_array(size3,size2,size1,sizeof(Prim1DS)))
-    == NULL) goto on_error;
-
-  if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
-  if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
+  if (lean == 0) {
+    if ((Wl_x1Face=(Prim1DS***)alloc_3d(size3,size2,size1,sizeof(Prim1DS)))
+      == NULL) goto on_error;
+    if ((Wr_x1Face=(Prim1DS***)alloc_3d(size3,size2,size1,sizeof(Prim1DS)))
+      == NULL) goto on_error;
+    if ((Wl_x2Face=(Prim1DS***)alloc_3d(size3,size2,size1,sizeof(Prim1DS)))
+      == NULL) goto on_error;
+    if ((Wr_x2Face=(Prim1DS***)alloc_3d(size3,size2,size1,sizeof(Prim1DS)))
+      == NULL) goto on_error;
+    if ((Wl_x3Face=(Prim1DS***)alloc_3d(size3,size2,size1,sizeof(Prim1DS)))
+      == NULL) goto on_error;
+    if ((Wr_x3Face=(Prim1DS***)alloc_3d(size3,size2,size1,sizeof(Prim1DS)))
+      == NULL) goto on_error;
+  }
 
 #ifdef MHD
-  if ((B1_x1Face = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))
+  if ((B1_x1Face = (Real***)alloc_3d(size3,size2,size1,sizeof(Real)))
     == NULL) goto on_error;
-  if ((B2_x2Face = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))
+  if ((B2_x2Face = (Real***)alloc_3d(size3,size2,size1,sizeof(Real)))
     == NULL) goto on_error;
-  if ((B3_x3Face = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))
+  if ((B3_x3Face = (Real***)alloc_3d(size3,size2,size1,sizeof(Real)))
     == NULL) goto on_error;
 #endif /* MHD */
 
-  if ((U1d = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((Ul  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((Ur  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((W1d = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wl  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wr  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
+/* Each OpenMP thread allocates its own (threadprivate) 1D scratch vectors */
+#ifdef OPENMP
+#pragma omp parallel reduction(+:ierr)
+#endif
+  {
+    if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) ierr++;
+    if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) ierr++;
+    if ((U1d = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) ierr++;
+    if ((Ul  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) ierr++;
+    if ((Ur  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) ierr++;
+    if ((W1d = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) ierr++;
+    if ((Wl  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) ierr++;
+    if ((Wr  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) ierr++;
+  }
+  if (ierr > 0) goto on_error;
 
-  if ((x1Flux = (Cons1DS***)calloc_3d_array(size3,size2,size1, sizeof(Cons1DS)))
+  if ((x1Flux = (Cons1DS***)alloc_3d(size3,size2,size1, sizeof(Cons1DS)))
     == NULL) goto on_error;
-  if ((x2Flux = (Cons1DS***)calloc_3d_array(size3,size2,size1, sizeof(Cons1DS)))
+  if ((x2Flux = (Cons1DS***)alloc_3d(size3,size2,size1, sizeof(Cons1DS)))
     == NULL) goto on_error;
-  if ((x3Flux = (Cons1DS***)calloc_3d_array(size3,size2,size1, sizeof(Cons1DS)))
+  if ((x3Flux = (Cons1DS***)alloc_3d(size3,size2,size1, sizeof(Cons1DS)))
     == NULL) goto on_error;
 #ifdef FIRST_ORDER_FLUX_CORRECTION
-  if ((x1FluxP =(Cons1DS***)calloc_3d_array(size3,size2,size1, sizeof(Cons1DS)))
+  if ((x1FluxP =(Cons1DS***)alloc_3d(size3,size2,size1, sizeof(Cons1DS)))
     == NULL) goto on_error;
-  if ((x2FluxP =(Cons1DS***)calloc_3d_array(size3,size2,size1, sizeof(Cons1DS)))
+  if ((x2FluxP =(Cons1DS***)alloc_3d(size3,size2,size1, sizeof(Cons1DS)))
     == NULL) goto on_error;
-  if ((x3FluxP =(Cons1DS***)calloc_3d_array(size3,size2,size1, sizeof(Cons1DS)))
+  if ((x3FluxP =(Cons1DS***)alloc_3d(size3,size2,size1, sizeof(Cons1DS)))
     == NULL) goto on_error;
 #ifdef MHD
-  if ((emf1P = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((emf1P = (Real***)alloc_3d(size3,size2,size1, sizeof(Real)))
     == NULL) goto on_error;
-  if ((emf2P = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((emf2P = (Real***)alloc_3d(size3,size2,size1, sizeof(Real)))
     == NULL) goto on_error;
-  if ((emf3P = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((emf3P = (Real***)alloc_3d(size3,size2,size1, sizeof(Real)))
     == NULL) goto on_error;
 #endif
 #endif /* FIRST_ORDER_FLUX_CORRECTION */
 #ifdef USE_ENTROPY_FIX
-  if ((S = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((S = (Real***)alloc_3d(size3,size2,size1, sizeof(Real)))
       == NULL) goto on_error;
-  if ((Shalf = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((Shalf = (Real***)alloc_3d(size3,size2,size1, sizeof(Real)))
       == NULL) goto on_error;
-  if ((x1FluxS = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((x1FluxS = (Real***)alloc_3d(size3,size2,size1, sizeof(Real)))
       == NULL) goto on_error;
-  if ((x2FluxS = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((x2FluxS = (Real***)alloc_3d(size3,size2,size1, sizeof(Real)))
       == NULL) goto on_error;
-  if ((x3FluxS = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((x3FluxS = (Real***)alloc_3d(size3,size2,size1, sizeof(Real)))
       == NULL) goto on_error;
 #ifdef FIRST_ORDER_FLUX_CORRECTION
-  if ((x1FluxSP = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((x1FluxSP = (Real***)alloc_3d(size3,size2,size1, sizeof(Real)))
       == NULL) goto on_error;
-  if ((x2FluxSP = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((x2FluxSP = (Real***)alloc_3d(size3,size2,size1, sizeof(Real)))
       == NULL) goto on_error;
-  if ((x3FluxSP = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
+  if ((x3FluxSP = (Real***)alloc_3d(size3,size2,size1, sizeof(Real)))
       == NULL) goto on_error;
 #endif
 #endif
 
-  if ((Uhalf = (ConsS***)calloc_3d_array(size3,size2,size1,sizeof(ConsS)))
+  if ((Uhalf = (ConsS***)alloc_3d(size3,size2,size1,sizeof(ConsS)))
     == NULL) goto on_error;
-  if ((Whalf = (PrimS***)calloc_3d_array(size3,size2,size1,sizeof(PrimS)))
+  if ((Whalf = (PrimS***)alloc_3d(size3,size2,size1,sizeof(PrimS)))
     == NULL) goto on_error;
-  if ((W     = (PrimS***)calloc_3d_array(size3,size2,size1,sizeof(PrimS)))
+  if ((W     = (PrimS***)alloc_3d(size3,size2,size1,sizeof(PrimS)))
     == NULL) goto on_error;
 
+/* With tiles, the half-step arrays above are the tile arrays, and Uhalf etc.
+ * become views (set by tile_grid()) */
+  if (tile > 0) {
+    Uhalf_tile = Uhalf;
+    Whalf_tile = Whalf;
+    if ((Uhalf_grid = (ConsS***)alloc_3d(gsize3,gsize2,size1,
+      sizeof(ConsS))) == NULL) goto on_error;
+    if ((Whalf_grid = (PrimS***)alloc_3d(gsize3,gsize2,size1,
+      sizeof(PrimS))) == NULL) goto on_error;
+    if ((Uhalf = (ConsS***)calloc_2d_array(size3,size2,sizeof(ConsS*)))
+      == NULL) goto on_error;
+    if ((Whalf = (PrimS***)calloc_2d_array(size3,size2,sizeof(PrimS*)))
+      == NULL) goto on_error;
+    if ((U_view = (ConsS***)calloc_2d_array(size3,size2,sizeof(ConsS*)))
+      == NULL) goto on_error;
+#ifdef MHD
+    B1_x1Face_tile = B1_x1Face;
+    B2_x2Face_tile = B2_x2Face;
+    B3_x3Face_tile = B3_x3Face;
+    if ((B1_x1Face_grid = (Real***)alloc_3d(gsize3,gsize2,size1,
+      sizeof(Real))) == NULL) goto on_error;
+    if ((B2_x2Face_grid = (Real***)alloc_3d(gsize3,gsize2,size1,
+      sizeof(Real))) == NULL) goto on_error;
+    if ((B3_x3Face_grid = (Real***)alloc_3d(gsize3,gsize2,size1,
+      sizeof(Real))) == NULL) goto on_error;
+    if ((B1_x1Face = (Real***)calloc_2d_array(size3,size2,sizeof(Real*)))
+      == NULL) goto on_error;
+    if ((B2_x2Face = (Real***)calloc_2d_array(size3,size2,sizeof(Real*)))
+      == NULL) goto on_error;
+    if ((B3_x3Face = (Real***)calloc_2d_array(size3,size2,sizeof(Real*)))
+      == NULL) goto on_error;
+    if ((B1i_view = (Real***)calloc_2d_array(size3,size2,sizeof(Real*)))
+      == NULL) goto on_error;
+    if ((B2i_view = (Real***)calloc_2d_array(size3,size2,sizeof(Real*)))
+      == NULL) goto on_error;
+    if ((B3i_view = (Real***)calloc_2d_array(size3,size2,sizeof(Real*)))
+      == NULL) goto on_error;
+#endif /* MHD */
+  }
+
+/* Report the memory of the 3D arrays, also relative to that of U */
+  ath_pout(0,"[integrate_init]: %.4g MB allocated for the integrator",
+           nbytes/1048576.0);
+  ath_pout(0," (%.1f times U)%s\n",
+           nbytes/((double)(tile > 0 ? gsize3*gsize2 : size3*size2)*size1*
+                   sizeof(ConsS)),
+           (lean ? " with <time>/lean = 1" : ""));
+
   return;
 
   on_error:
@@ -1916,6 +2425,44 @@ void integrate_init_3d(MeshS *pM)
  *  \brief Free temporary integration arrays */
 void integrate_destruct_3d(void)
 {
+/* With tiles, free the views and the grid arrays; the tile arrays are freed
+ * below */
+  if (tile > 0) {
+    if (Uhalf_grid != NULL) free_3d_array(Uhalf_grid);
+    if (Whalf_grid != NULL) free_3d_array(Whalf_grid);
+    if (Uhalf_tile != NULL) {
+      if (Uhalf  != NULL) free_2d_array(Uhalf);
+      Uhalf = Uhalf_tile;
+    }
+    if (Whalf_tile != NULL) {
+      if (Whalf  != NULL) free_2d_array(Whalf);
+      Whalf = Whalf_tile;
+    }
+    if (U_view != NULL) free_2d_array(U_view);
+    Uhalf_grid = NULL;  Whalf_grid = NULL;
+    Uhalf_tile = NULL;  Whalf_tile = NULL;  U_view = NULL;
+#ifdef MHD
+    if (B1_x1Face_grid != NULL) free_3d_array(B1_x1Face_grid);
+    if (B2_x2Face_grid != NULL) free_3d_array(B2_x2Face_grid);
+    if (B3_x3Face_grid != NULL) free_3d_array(B3_x3Face_grid);
+    if (B1_x1Face_tile != NULL) {
+      if (B1_x1Face != NULL) free_2d_array(B1_x1Face);
+      if (B2_x2Face != NULL) free_2d_array(B2_x2Face);
+      if (B3_x3Face != NULL) free_2d_array(B3_x3Face);
+      B1_x1Face = B1_x1Face_tile;
+      B2_x2Face = B2_x2Face_tile;
+      B3_x3Face = B3_x3Face_tile;
+    }
+    if (B1i_view != NULL) free_2d_array(B1i_view);
+    if (B2i_view != NULL) free_2d_array(B2i_view);
+    if (B3i_view != NULL) free_2d_array(B3i_view);
+    B1_x1Face_grid = NULL;  B2_x2Face_grid = NULL;  B3_x3Face_grid = NULL;
+    B1_x1Face_tile = NULL;  B2_x2Face_tile = NULL;  B3_x3Face_tile = NULL;
+    B1i_view = NULL;  B2i_view = NULL;  B3i_view = NULL;
+#endif /* MHD */
+    tile = 0;
+  }
+
 #ifdef MHD
   if (emf1 != NULL) free_3d_array(emf1);
   if (emf2 != NULL) free_3d_array(emf2);
@@ -1936,20 +2483,28 @@ void integrate_destruct_3d(void)
   if (Wl_x3Face != NULL) free_3d_array(Wl_x3Face);
   if (Wr_x3Face != NULL) free_3d_array(Wr_x3Face);
 
-  if (Bxc != NULL) free(Bxc);
-  if (Bxi != NULL) free(Bxi);
 #ifdef MHD
   if (B1_x1Face != NULL) free_3d_array(B1_x1Face);
   if (B2_x2Face != NULL) free_3d_array(B2_x2Face);
   if (B3_x3Face != NULL) free_3d_array(B3_x3Face);
 #endif /* MHD */
 
-  if (U1d != NULL) free(U1d);
-  if (Ul  != NULL) free(Ul);
-  if (Ur  != NULL) free(Ur);
-  if (W1d != NULL) free(W1d);
-  if (Wl  != NULL) free(Wl);
-  if (Wr  != NULL) free(Wr);
+#ifdef OPENMP
+#pragma omp parallel
+#endif
+  {
+    if (Bxc != NULL) free(Bxc);
+    if (Bxi != NULL) free(Bxi);
+    if (U1d != NULL) free(U1d);
+    if (Ul  != NULL) free(Ul);
+    if (Ur  != NULL) free(Ur);
+    if (W1d != NULL) free(W1d);
+    if (Wl  != NULL) free(Wl);
+    if (Wr  != NULL) free(Wr);
+    Bxc = NULL;  Bxi = NULL;
+    U1d = NULL;  Ul = NULL;  Ur = NULL;
+    W1d = NULL;  Wl = NULL;  Wr = NULL;
+  }
 
   if (x1Flux  != NULL) free_3d_array(x1Flux);
   if (x2Flux  != NULL) free_3d_array(x2Flux);
@@ -2012,45 +2567,48 @@ static void integrate_emf1_corner(const GridS *pG)
   jl = pG->js-(nghost-1);   ju = pG->je+(nghost-1);
   kl = pG->ks-(nghost-1);   ku = pG->ke+(nghost-1);
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,de1_l2,de1_r2,de1_l3,de1_r3)
+#endif
   for (k=kl; k<=ku+1; k++) {
     for (j=jl; j<=ju+1; j++) {
       for (i=il; i<=iu; i++) {
 /* NOTE: The x2-Flux of By is -E1. */
 /*       The x3-Flux of Bz is +E1. */
 	if (x2Flux[k-1][j][i].d > 0.0)
-	  de1_l3 = x3Flux[k][j-1][i].Bz - emf1_cc[k-1][j-1][i];
+	  de1_l3 = x3Flux[k][j-1][i].Bz - EMF1_CC(k-1,j-1,i);
 	else if (x2Flux[k-1][j][i].d < 0.0)
-	  de1_l3 = x3Flux[k][j][i].Bz - emf1_cc[k-1][j][i];
+	  de1_l3 = x3Flux[k][j][i].Bz - EMF1_CC(k-1,j,i);
 	else {
-	  de1_l3 = 0.5*(x3Flux[k][j-1][i].Bz - emf1_cc[k-1][j-1][i] +
-			x3Flux[k][j  ][i].Bz - emf1_cc[k-1][j  ][i] );
+	  de1_l3 = 0.5*(x3Flux[k][j-1][i].Bz - EMF1_CC(k-1,j-1,i) +
+			x3Flux[k][j  ][i].Bz - EMF1_CC(k-1,j  ,i) );
 	}
 
 	if (x2Flux[k][j][i].d > 0.0)
-	  de1_r3 = x3Flux[k][j-1][i].Bz - emf1_cc[k][j-1][i];
+	  de1_r3 = x3Flux[k][j-1][i].Bz - EMF1_CC(k,j-1,i);
 	else if (x2Flux[k][j][i].d < 0.0)
-	  de1_r3 = x3Flux[k][j][i].Bz - emf1_cc[k][j][i];
+	  de1_r3 = x3Flux[k][j][i].Bz - EMF1_CC(k,j,i);
 	else {
-	  de1_r3 = 0.5*(x3Flux[k][j-1][i].Bz - emf1_cc[k][j-1][i] +
-			x3Flux[k][j  ][i].Bz - emf1_cc[k][j  ][i] );
+	  de1_r3 = 0.5*(x3Flux[k][j-1][i].Bz - EMF1_CC(k,j-1,i) +
+			x3Flux[k][j  ][i].Bz - EMF1_CC(k,j  ,i) );
 	}
 
 	if (x3Flux[k][j-1][i].d > 0.0)
-	  de1_l2 = -x2Flux[k-1][j][i].By - emf1_cc[k-1][j-1][i];
+	  de1_l2 = -x2Flux[k-1][j][i].By - EMF1_CC(k-1,j-1,i);
 	else if (x3Flux[k][j-1][i].d < 0.0)
-	  de1_l2 = -x2Flux[k][j][i].By - emf1_cc[k][j-1][i];
+	  de1_l2 = -x2Flux[k][j][i].By - EMF1_CC(k,j-1,i);
 	else {
-	  de1_l2 = 0.5*(-x2Flux[k-1][j][i].By - emf1_cc[k-1][j-1][i]
-			-x2Flux[k  ][j][i].By - emf1_cc[k  ][j-1][i] );
+	  de1_l2 = 0.5*(-x2Flux[k-1][j][i].By - EMF1_CC(k-1,j-1,i)
+			-x2Flux[k  ][j][i].By - EMF1_CC(k  ,j-1,i) );
 	}
 
 	if (x3Flux[k][j][i].d > 0.0)
-	  de1_r2 = -x2Flux[k-1][j][i].By - emf1_cc[k-1][j][i];
+	  de1_r2 = -x2Flux[k-1][j][i].By - EMF1_CC(k-1,j,i);
 	else if (x3Flux[k][j][i].d < 0.0)
-	  de1_r2 = -x2Flux[k][j][i].By - emf1_cc[k][j][i];
+	  de1_r2 = -x2Flux[k][j][i].By - EMF1_CC(k,j,i);
 	else {
-	  de1_r2 = 0.5*(-x2Flux[k-1][j][i].By - emf1_cc[k-1][j][i]
-			-x2Flux[k  ][j][i].By - emf1_cc[k  ][j][i] );
+	  de1_r2 = 0.5*(-x2Flux[k-1][j][i].By - EMF1_CC(k-1,j,i)
+			-x2Flux[k  ][j][i].By - EMF1_CC(k  ,j,i) );
 	}
 
         emf1[k][j][i] = 0.25*(  x3Flux[k][j][i].Bz + x3Flux[k][j-1][i].Bz
@@ -2086,45 +2644,48 @@ static void integrate_emf2_corner(const GridS *pG)
   jl = pG->js-(nghost-1);   ju = pG->je+(nghost-1);
   kl = pG->ks-(nghost-1);   ku = pG->ke+(nghost-1);
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,de2_l1,de2_r1,de2_l3,de2_r3)
+#endif
   for (k=kl; k<=ku+1; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu+1; i++) {
 /* NOTE: The x1-Flux of Bz is +E2. */
 /*       The x3-Flux of By is -E2. */
 	if (x1Flux[k-1][j][i].d > 0.0)
-	  de2_l3 = -x3Flux[k][j][i-1].By - emf2_cc[k-1][j][i-1];
+	  de2_l3 = -x3Flux[k][j][i-1].By - EMF2_CC(k-1,j,i-1);
 	else if (x1Flux[k-1][j][i].d < 0.0)
-	  de2_l3 = -x3Flux[k][j][i].By - emf2_cc[k-1][j][i];
+	  de2_l3 = -x3Flux[k][j][i].By - EMF2_CC(k-1,j,i);
 	else {
-	  de2_l3 = 0.5*(-x3Flux[k][j][i-1].By - emf2_cc[k-1][j][i-1] 
-			-x3Flux[k][j][i  ].By - emf2_cc[k-1][j][i  ] );
+	  de2_l3 = 0.5*(-x3Flux[k][j][i-1].By - EMF2_CC(k-1,j,i-1) 
+			-x3Flux[k][j][i  ].By - EMF2_CC(k-1,j,i  ) );
 	}
 
 	if (x1Flux[k][j][i].d > 0.0)
-	  de2_r3 = -x3Flux[k][j][i-1].By - emf2_cc[k][j][i-1];
+	  de2_r3 = -x3Flux[k][j][i-1].By - EMF2_CC(k,j,i-1);
 	else if (x1Flux[k][j][i].d < 0.0)
-	  de2_r3 = -x3Flux[k][j][i].By - emf2_cc[k][j][i];
+	  de2_r3 = -x3Flux[k][j][i].By - EMF2_CC(k,j,i);
 	else {
-	  de2_r3 = 0.5*(-x3Flux[k][j][i-1].By - emf2_cc[k][j][i-1] 
-			-x3Flux[k][j][i  ].By - emf2_cc[k][j][i  ] );
+	  de2_r3 = 0.5*(-x3Flux[k][j][i-1].By - EMF2_CC(k,j,i-1) 
+			-x3Flux[k][j][i  ].By - EMF2_CC(k,j,i  ) );
 	}
 
 	if (x3Flux[k][j][i-1].d > 0.0)
-	  de2_l1 = x1Flux[k-1][j][i].Bz - emf2_cc[k-1][j][i-1];
+	  de2_l1 = x1Flux[k-1][j][i].Bz - EMF2_CC(k-1,j,i-1);
 	else if (x3Flux[k][j][i-1].d < 0.0)
-	  de2_l1 = x1Flux[k][j][i].Bz - emf2_cc[k][j][i-1];
+	  de2_l1 = x1Flux[k][j][i].Bz - EMF2_CC(k,j,i-1);
 	else {
-	  de2_l1 = 0.5*(x1Flux[k-1][j][i].Bz - emf2_cc[k-1][j][i-1] +
-			x1Flux[k  ][j][i].Bz - emf2_cc[k  ][j][i-1] );
+	  de2_l1 = 0.5*(x1Flux[k-1][j][i].Bz - EMF2_CC(k-1,j,i-1) +
+			x1Flux[k  ][j][i].Bz - EMF2_CC(k  ,j,i-1) );
 	}
 
 	if (x3Flux[k][j][i].d > 0.0)
-	  de2_r1 = x1Flux[k-1][j][i].Bz - emf2_cc[k-1][j][i];
+	  de2_r1 = x1Flux[k-1][j][i].Bz - EMF2_CC(k-1,j,i);
 	else if (x3Flux[k][j][i].d < 0.0)
-	  de2_r1 = x1Flux[k][j][i].Bz - emf2_cc[k][j][i];
+	  de2_r1 = x1Flux[k][j][i].Bz - EMF2_CC(k,j,i);
 	else {
-	  de2_r1 = 0.5*(x1Flux[k-1][j][i].Bz - emf2_cc[k-1][j][i] +
-			x1Flux[k  ][j][i].Bz - emf2_cc[k  ][j][i] );
+	  de2_r1 = 0.5*(x1Flux[k-1][j][i].Bz - EMF2_CC(k-1,j,i) +
+			x1Flux[k  ][j][i].Bz - EMF2_CC(k  ,j,i) );
 	}
 
 	emf2[k][j][i] = 0.25*(  x1Flux[k][j][i].Bz + x1Flux[k-1][j][i  ].Bz
@@ -2160,45 +2721,48 @@ static void integrate_emf3_corner(const GridS *pG)
   jl = pG->js-(nghost-1);   ju = pG->je+(nghost-1);
   kl = pG->ks-(nghost-1);   ku = pG->ke+(nghost-1);
 
+#ifdef OPENMP
+#pragma omp parallel for private(i,j,de3_l1,de3_r1,de3_l2,de3_r2)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju+1; j++) {
       for (i=il; i<=iu+1; i++) {
 /* NOTE: The x1-Flux of By is -E3. */
 /*       The x2-Flux of Bx is +E3. */
 	if (x1Flux[k][j-1][i].d > 0.0)
-	  de3_l2 = x2Flux[k][j][i-1].Bz - emf3_cc[k][j-1][i-1];
+	  de3_l2 = x2Flux[k][j][i-1].Bz - EMF3_CC(k,j-1,i-1);
 	else if (x1Flux[k][j-1][i].d < 0.0)
-	  de3_l2 = x2Flux[k][j][i].Bz - emf3_cc[k][j-1][i];
+	  de3_l2 = x2Flux[k][j][i].Bz - EMF3_CC(k,j-1,i);
 	else {
-	  de3_l2 = 0.5*(x2Flux[k][j][i-1].Bz - emf3_cc[k][j-1][i-1] + 
-			x2Flux[k][j][i  ].Bz - emf3_cc[k][j-1][i  ] );
+	  de3_l2 = 0.5*(x2Flux[k][j][i-1].Bz - EMF3_CC(k,j-1,i-1) + 
+			x2Flux[k][j][i  ].Bz - EMF3_CC(k,j-1,i  ) );
 	}
 
 	if (x1Flux[k][j][i].d > 0.0)
-	  de3_r2 = x2Flux[k][j][i-1].Bz - emf3_cc[k][j][i-1];
+	  de3_r2 = x2Flux[k][j][i-1].Bz - EMF3_CC(k,j,i-1);
 	else if (x1Flux[k][j][i].d < 0.0)
-	  de3_r2 = x2Flux[k][j][i].Bz - emf3_cc[k][j][i];
+	  de3_r2 = x2Flux[k][j][i].Bz - EMF3_CC(k,j,i);
 	else {
-	  de3_r2 = 0.5*(x2Flux[k][j][i-1].Bz - emf3_cc[k][j][i-1] + 
-			x2Flux[k][j][i  ].Bz - emf3_cc[k][j][i  ] );
+	  de3_r2 = 0.5*(x2Flux[k][j][i-1].Bz - EMF3_CC(k,j,i-1) + 
+			x2Flux[k][j][i  ].Bz - EMF3_CC(k,j,i  ) );
 	}
 
 	if (x2Flux[k][j][i-1].d > 0.0)
-	  de3_l1 = -x1Flux[k][j-1][i].By - emf3_cc[k][j-1][i-1];
+	  de3_l1 = -x1Flux[k][j-1][i].By - EMF3_CC(k,j-1,i-1);
 	else if (x2Flux[k][j][i-1].d < 0.0)
-	  de3_l1 = -x1Flux[k][j][i].By - emf3_cc[k][j][i-1];
+	  de3_l1 = -x1Flux[k][j][i].By - EMF3_CC(k,j,i-1);
 	else {
-	  de3_l1 = 0.5*(-x1Flux[k][j-1][i].By - emf3_cc[k][j-1][i-1]
-			-x1Flux[k][j  ][i].By - emf3_cc[k][j  ][i-1] );
+	  de3_l1 = 0.5*(-x1Flux[k][j-1][i].By - EMF3_CC(k,j-1,i-1)
+			-x1Flux[k][j  ][i].By - EMF3_CC(k,j  ,i-1) );
 	}
 
 	if (x2Flux[k][j][i].d > 0.0)
-	  de3_r1 = -x1Flux[k][j-1][i].By - emf3_cc[k][j-1][i];
+	  de3_r1 = -x1Flux[k][j-1][i].By - EMF3_CC(k,j-1,i);
 	else if (x2Flux[k][j][i].d < 0.0)
-	  de3_r1 = -x1Flux[k][j][i].By - emf3_cc[k][j][i];
+	  de3_r1 = -x1Flux[k][j][i].By - EMF3_CC(k,j,i);
 	else {
-	  de3_r1 = 0.5*(-x1Flux[k][j-1][i].By - emf3_cc[k][j-1][i]
-			-x1Flux[k][j  ][i].By - emf3_cc[k][j  ][i] );
+	  de3_r1 = 0.5*(-x1Flux[k][j-1][i].By - EMF3_CC(k,j-1,i)
+			-x1Flux[k][j  ][i].By - EMF3_CC(k,j  ,i) );
 	}
 
 	emf3[k][j][i] = 0.25*(  x2Flux[k][j  ][i-1].Bz + x2Flux[k][j][i].Bz
@@ -2457,6 +3021,334 @@ static void FixCell(GridS *pG, Int3Vect ix)
 }
 #endif /* FIRST_ORDER_FLUX_CORRECTION */
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static void lean_fluxes(GridS *pG, int il, int iu, int jl, int ju,
+ *                              int kl, int ku)
+ *  \brief Steps 8-11 with <time>/lean = 1: the second-order fluxes in the
+ *   x1-, x2- and x3-directions are computed by lean_pencil() one pencil at a
+ *   time, along x1, x2 and x3 respectively, over the same interfaces as in
+ *   Steps 11b-d. */
+static void lean_fluxes(GridS *pG, int il, int iu, int jl, int ju,
+                        int kl, int ku)
+{
+  int i, is = pG->is, ie = pG->ie;
+  int j, js = pG->js, je = pG->je;
+  int k, ks = pG->ks, ke = pG->ke;
+  int NaNFlux=0;
+
+/* x1-fluxes, pencils along x1 */
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(j) reduction(+:NaNFlux)
+#endif
+  for (k=ks-1; k<=ke+1; k++) {
+    for (j=js-1; j<=je+1; j++) {
+      NaNFlux += lean_pencil(pG,1,k,j,is,il,iu);
+    }
+  }
+  if (NaNFlux != 0) {
+    printf("[Step11b] %i second-order fluxes replaced\n",NaNFlux);
+    NaNFlux=0;
+  }
+
+/* x2-fluxes, pencils along x2 */
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(i) reduction(+:NaNFlux)
+#endif
+  for (k=ks-1; k<=ke+1; k++) {
+    for (i=is-1; i<=ie+1; i++) {
+      NaNFlux += lean_pencil(pG,2,k,js,i,jl,ju);
+    }
+  }
+  if (NaNFlux != 0) {
+    printf("[Step11c] %i second-order fluxes replaced\n",NaNFlux);
+    NaNFlux=0;
+  }
+
+/* x3-fluxes, pencils along x3 */
+#ifdef OPENMP
+#pragma omp parallel for collapse(2) private(i) reduction(+:NaNFlux)
+#endif
+  for (j=js-1; j<=je+1; j++) {
+    for (i=is-1; i<=ie+1; i++) {
+      NaNFlux += lean_pencil(pG,3,ks,j,i,kl,ku);
+    }
+  }
+  if (NaNFlux != 0) {
+    printf("[Step11d] %i second-order fluxes replaced\n",NaNFlux);
+    NaNFlux=0;
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int lean_pencil(GridS *pG, const int dir, int k, int j, int i,
+ *                             const int nl, const int nu)
+ *  \brief L/R states at t^{n+1/2} and second-order fluxes of the pencil of
+ *   dir-interfaces through cell (k,j,i), as in Steps 8-11 but kept in the 1D
+ *   scratch vectors: W1d is loaded from Whalf over nl..nu along dir, and the
+ *   fluxes are computed into U1d, then stored in x?Flux.  Returns the number
+ *   of fluxes replaced by the predictor fluxes (with FOFC).
+ */
+static int lean_pencil(GridS *pG, const int dir, int k, int j, int i,
+                       const int nl, const int nu)
+{
+  int n, ns, ne, *pn, nnan=0;
+#if (NSCALARS > 0)
+  int m;
+#endif
+  Real dx;
+  PrimS *pW;
+  Cons1DS ***Flux;
+#ifdef MHD
+  Real ***B_Face;
+#endif
+#ifdef USE_ENTROPY_FIX
+  Real ***FluxS;
+#endif
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+  Real Vsq;
+  Cons1DS ***FluxP;
+#ifdef USE_ENTROPY_FIX
+  Real ***FluxSP;
+#endif
+#endif
+
+  switch (dir) {
+  case 1:
+    pn = &i;  ns = pG->is;  ne = pG->ie;  dx = pG->dx1;
+    Flux = x1Flux;
+#ifdef MHD
+    B_Face = B1_x1Face;
+#endif
+#ifdef USE_ENTROPY_FIX
+    FluxS = x1FluxS;
+#endif
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+    FluxP = x1FluxP;
+#ifdef USE_ENTROPY_FIX
+    FluxSP = x1FluxSP;
+#endif
+#endif
+    break;
+  case 2:
+    pn = &j;  ns = pG->js;  ne = pG->je;  dx = pG->dx2;
+    Flux = x2Flux;
+#ifdef MHD
+    B_Face = B2_x2Face;
+#endif
+#ifdef USE_ENTROPY_FIX
+    FluxS = x2FluxS;
+#endif
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+    FluxP = x2FluxP;
+#ifdef USE_ENTROPY_FIX
+    FluxSP = x2FluxSP;
+#endif
+#endif
+    break;
+  default:
+    pn = &k;  ns = pG->ks;  ne = pG->ke;  dx = pG->dx3;
+    Flux = x3Flux;
+#ifdef MHD
+    B_Face = B3_x3Face;
+#endif
+#ifdef USE_ENTROPY_FIX
+    FluxS = x3FluxS;
+#endif
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+    FluxP = x3FluxP;
+#ifdef USE_ENTROPY_FIX
+    FluxSP = x3FluxSP;
+#endif
+#endif
+    break;
+  }
+
+/* Load 1D vector of primitive variables, rotated as in Steps 8a-10a */
+  for (n=nl; n<=nu; n++) {
+    *pn = n;
+    pW = &(Whalf[k][j][i]);
+    W1d[n].d = pW->d;
+#ifndef BAROTROPIC
+    W1d[n].P = pW->P;
+#endif /* BAROTROPIC */
+    if (dir == 1) {
+      W1d[n].Vx = pW->V1;  W1d[n].Vy = pW->V2;  W1d[n].Vz = pW->V3;
+#ifdef MHD
+      W1d[n].By = pW->B2c;  W1d[n].Bz = pW->B3c;  Bxc[n] = pW->B1c;
+#endif /* MHD */
+    } else if (dir == 2) {
+      W1d[n].Vx = pW->V2;  W1d[n].Vy = pW->V3;  W1d[n].Vz = pW->V1;
+#ifdef MHD
+      W1d[n].By = pW->B3c;  W1d[n].Bz = pW->B1c;  Bxc[n] = pW->B2c;
+#endif /* MHD */
+    } else {
+      W1d[n].Vx = pW->V3;  W1d[n].Vy = pW->V1;  W1d[n].Vz = pW->V2;
+#ifdef MHD
+      W1d[n].By = pW->B1c;  W1d[n].Bz = pW->B2c;  Bxc[n] = pW->B3c;
+#endif /* MHD */
+    }
+#if (NSCALARS > 0)
+    for (m=0; m<NSCALARS; m++) W1d[n].r[m] = pW->r[m];
+#endif
+  }
+
+/* Compute L and R states, as in Steps 8b-10b */
+  lr_states(pG,W1d,Bxc,pG->dt,dx,ns,ne,Wl,Wr,dir);
+
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+  for (n=nl; n<=nu; n++) {
+    Vsq = SQR(Wl[n].Vx) + SQR(Wl[n].Vy) + SQR(Wl[n].Vz);
+    if (Vsq > 1.0){
+      Wl[n] = W1d[n];
+      Wr[n] = W1d[n];
+    }
+    Vsq = SQR(Wr[n].Vx) + SQR(Wr[n].Vy) + SQR(Wr[n].Vz);
+    if (Vsq > 1.0){
+      Wl[n] = W1d[n];
+      Wr[n] = W1d[n];
+    }
+  }
+#endif
+
+/* Compute the fluxes, as in Steps 11b-d */
+  for (n=ns; n<=ne+1; n++) {
+    *pn = n;
+#ifdef MHD
+    Bxi[n] = B_Face[k][j][i];
+#else
+    Bxi[n] = 0.0;
+#endif
+    Ul[n] = Prim1D_to_Cons1D(&(Wl[n]),&(Bxi[n]));
+    Ur[n] = Prim1D_to_Cons1D(&(Wr[n]),&(Bxi[n]));
+  }
+
+  fluxes_pencil(ns,ne+1,Ul,Ur,Wl,Wr,Bxi,U1d);
+
+  for (n=ns; n<=ne+1; n++) {
+    *pn = n;
+    Flux[k][j][i] = U1d[n];
+#ifdef USE_ENTROPY_FIX
+    entropy_flux(Ul[n],Ur[n],Wl[n],Wr[n],Bxi[n],&(FluxS[k][j][i]));
+#endif
+
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+/* revert to predictor flux if this flux NaN'ed */
+    if ((U1d[n].d  != U1d[n].d)  ||
+#ifndef BAROTROPIC
+        (U1d[n].E  != U1d[n].E)  ||
+#endif
+#ifdef MHD
+        (U1d[n].By != U1d[n].By) ||
+        (U1d[n].Bz != U1d[n].Bz) ||
+#endif
+        (U1d[n].Mx != U1d[n].Mx) ||
+        (U1d[n].My != U1d[n].My) ||
+        (U1d[n].Mz != U1d[n].Mz)) {
+      Flux[k][j][i] = FluxP[k][j][i];
+#ifdef USE_ENTROPY_FIX
+      FluxS[k][j][i] = FluxSP[k][j][i];
+#endif
+      nnan++;
+    }
+#endif
+  }
+
+  return nnan;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void tile_grid(GridS *pG, GridS *pT, int tk, int tj,
+ *                            int predict)
+ *  \brief Sets up *pT as the Grid of tile tk,tj of pG, with tile*tile cells
+ *   in x2,x3 and the same ghost zones, and the views into the arrays of pG
+ *   and the grid arrays.  In the predict step (predict=1), the rows outside
+ *   the tile are in the tile arrays, but in the ghost zones of pG. */
+static void tile_grid(GridS *pG, GridS *pT, int tk, int tj, int predict)
+{
+  int ks = pG->ks + tk*tile, ke = MIN(ks + tile - 1, pG->ke);
+  int js = pG->js + tj*tile, je = MIN(js + tile - 1, pG->je);
+  int ko = ks - nghost, jo = js - nghost;
+  int n3 = pG->Nx[2] + 2*nghost, n2 = pG->Nx[1] + 2*nghost;
+  int kl = 0, ku = n3, jl = 0, ju = n2;
+
+  *pT = *pG;
+  pT->ks = nghost;  pT->ke = nghost + ke - ks;  pT->Nx[2] = ke - ks + 1;
+  pT->js = nghost;  pT->je = nghost + je - js;  pT->Nx[1] = je - js + 1;
+  pT->MinX[1] = pG->MinX[1] + (js - pG->js)*pG->dx2;
+  pT->MinX[2] = pG->MinX[2] + (ks - pG->ks)*pG->dx3;
+
+/* pG->U and pG->B?i have no row at n3 (n2) for the faces, unlike the grid
+ * arrays */
+  tile_view((void***)U_view,(void***)pG->U,NULL,ko,jo,0,n3-1,0,n2-1);
+  pT->U = U_view;
+#ifdef MHD
+  tile_view((void***)B1i_view,(void***)pG->B1i,NULL,ko,jo,0,n3-1,0,n2-1);
+  tile_view((void***)B2i_view,(void***)pG->B2i,NULL,ko,jo,0,n3-1,0,n2-1);
+  tile_view((void***)B3i_view,(void***)pG->B3i,NULL,ko,jo,0,n3-1,0,n2-1);
+  pT->B1i = B1i_view;
+  pT->B2i = B2i_view;
+  pT->B3i = B3i_view;
+#endif /* MHD */
+
+  if (predict) {
+    if (ks > pG->ks) kl = ks;
+    if (ke < pG->ke) ku = ke;
+    if (js > pG->js) jl = js;
+    if (je < pG->je) ju = je;
+  }
+  tile_view((void***)Uhalf, (void***)Uhalf_grid,
+            (predict ? (void***)Uhalf_tile : NULL), ko,jo,kl,ku,jl,ju);
+  tile_view((void***)Whalf, (void***)Whalf_grid,
+            (predict ? (void***)Whalf_tile : NULL), ko,jo,kl,ku,jl,ju);
+#ifdef MHD
+  tile_view((void***)B1_x1Face, (void***)B1_x1Face_grid,
+            (predict ? (void***)B1_x1Face_tile : NULL), ko,jo,kl,ku,jl,ju);
+  tile_view((void***)B2_x2Face, (void***)B2_x2Face_grid,
+            (predict ? (void***)B2_x2Face_tile : NULL), ko,jo,kl,ku,jl,ju);
+  tile_view((void***)B3_x3Face, (void***)B3_x3Face_grid,
+            (predict ? (void***)B3_x3Face_tile : NULL), ko,jo,kl,ku,jl,ju);
+#endif /* MHD */
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void tile_view(void ***v, void ***a, void ***t, int ko, int jo,
+ *                            int kl, int ku, int jl, int ju)
+ *  \brief Points the rows v[k][j] of a view to the rows a[k+ko][j+jo] of a
+ *   grid array for kl<=k+ko<=ku and jl<=j+jo<=ju, and to the rows t[k][j] of
+ *   a tile array (or to NULL) elsewhere. */
+static void tile_view(void ***v, void ***a, void ***t, int ko, int jo,
+                      int kl, int ku, int jl, int ju)
+{
+  int j,k;
+
+  for (k=0; k<tsize3; k++) {
+    for (j=0; j<tsize2; j++) {
+      if (k+ko >= kl && k+ko <= ku && j+jo >= jl && j+jo <= ju)
+        v[k][j] = a[k+ko][j+jo];
+      else
+        v[k][j] = (t != NULL) ? t[k][j] : NULL;
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void *alloc_3d(int nt, int nr, int nc, size_t size)
+ *  \brief calloc_3d_array(), adding the size of the array to nbytes */
+static void *alloc_3d(int nt, int nr, int nc, size_t size)
+{
+  void *array = calloc_3d_array(nt,nr,nc,size);
+
+  if (array != NULL) nbytes += (double)nt*nr*nc*size;
+
+  return array;
+}
+
 #endif /* VL_INTEGRATOR */
 
 #endif /* SPECIAL_RELATIVITY */
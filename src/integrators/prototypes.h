@@ -33,5 +33,6 @@ void integrate_destruct_3d(void);
 void integrate_init_3d(MeshS *pM);
 void integrate_3d_ctu(DomainS *pD);
 void integrate_3d_vl(DomainS *pD);
+void integrate_3d_vl_tiled(DomainS *pD);
 
 #endif /* INTEGRATORS_PROTOTYPES_H */
@@ -117,10 +117,23 @@ int main(int argc, char *argv[])
 
 #ifdef MPI_PARALLEL
   char *pc, *suffix, new_name[MAXLEN];
-  int len, h, m, s, err, use_wtlim=0;
+  int len, h, m, s, err, use_wtlim=0, gres=0;
   double wtend;
+#if defined(ASYNC_IO) || defined(OPENMP)
+  int provided;
+#endif
+
+#if defined(ASYNC_IO) || defined(OPENMP)
+/* Only the main thread makes MPI calls, the background writer and the OpenMP
+ * threads do not */
+  if(MPI_SUCCESS != MPI_Init_thread(&argc,&argv,MPI_THREAD_FUNNELED,&provided))
+    ath_error("[main]: Error on calling MPI_Init_thread\n");
+  if(provided < MPI_THREAD_FUNNELED)
+    ath_error("[main]: MPI_THREAD_FUNNELED is not supported by MPI\n");
+#else
   if(MPI_SUCCESS != MPI_Init(&argc, &argv))
     ath_error("[main]: Error on calling MPI_Init\n");
+#endif
 #endif /* MPI_PARALLEL */
 
 /*----------------------------------------------------------------------------*/
@@ -259,10 +272,19 @@ int main(int argc, char *argv[])
 	ath_error("[main]: Bad Restart filename: %s\n",new_name);
     }while(*pc != '.');
 
+/* A single-file restart written with MPI-IO is read by all processors, so
+ * then the children keep the name */
+
+    if(myID_Comm_world == 0) gres = restart_file_is_mpiio(res_file);
+    if(MPI_SUCCESS != MPI_Bcast(&gres, 1, MPI_INT, 0, MPI_COMM_WORLD))
+      ath_error("[main]: Error on calling MPI_Bcast\n");
+
 /* Only children add myID_Comm_world to the filename */
 
     if(myID_Comm_world == 0) {
       strcpy(new_name, res_file);
+    } else if(gres) {
+      res_file = new_name;
     } else {       
       suffix = ath_strdup(pc);
       sprintf(pc,"-id%d%s",myID_Comm_world,suffix);
@@ -374,6 +396,9 @@ int main(int argc, char *argv[])
         if (Mesh.Domain[nl][nd].Grid != NULL) problem(&(Mesh.Domain[nl][nd]));
       }
     }
+#ifdef PARTICLES
+    particle_set_origin(&Mesh);
+#endif
   }
 
 /* restrict initial solution so grid hierarchy is consistent */
@@ -601,13 +626,17 @@ int main(int argc, char *argv[])
 
 /*--- Step 9h. ---------------------------------------------------------------*/
 /* Boundary values must be set after time is updated for t-dependent BCs.
- * With SMR, ghost zones at internal fine/coarse boundaries set by Prolongate */
+ * With SMR, ghost zones at internal fine/coarse boundaries set by Prolongate
+ * New particles are injected first, so that the particle BCs apply to them.
+ * The exchange is only started here where possible, and completed by the
+ * integrator (or by the outputs) with bvals_mhd_finish() */
 
     for (nl=0; nl<(Mesh.NLevels); nl++){ 
       for (nd=0; nd<(Mesh.DomainsPerLevel[nl]); nd++){  
         if (Mesh.Domain[nl][nd].Grid != NULL){
-          bvals_mhd(&(Mesh.Domain[nl][nd]));
+          bvals_mhd_start(&(Mesh.Domain[nl][nd]));
 #ifdef PARTICLES
+          inject_particles(&(Mesh.Domain[nl][nd]));
           bvals_particle(&(Mesh.Domain[nl][nd]));
 #endif
         }
@@ -648,6 +677,16 @@ int main(int argc, char *argv[])
 /*--- Step 10. ---------------------------------------------------------------*/
 /* Finish up by computing zc/sec, dumping data, and deallocate memory */
 
+/* Complete a boundary exchange still pending after the last step */
+
+  for (nl=0; nl<(Mesh.NLevels); nl++){
+    for (nd=0; nd<(Mesh.DomainsPerLevel[nl]); nd++){
+      if (Mesh.Domain[nl][nd].Grid != NULL){
+        bvals_mhd_finish(&(Mesh.Domain[nl][nd]));
+      }
+    }
+  }
+
 /* Print diagnostic message as to why run terminated */
 
   if (Mesh.nstep == nlim)
@@ -719,11 +758,16 @@ int main(int argc, char *argv[])
 
   data_output(&Mesh, 1);
 
+/* Wait for the outputs still being written in the background */
+
+  ath_async_wait();
+
 /* Free all memory */
 
   lr_states_destruct();
   integrate_destruct();
   data_output_destruct();
+  bvals_mhd_destruct();
 #ifdef PARTICLES
   particle_destruct(&Mesh);
   bvals_particle_destruct(&Mesh);
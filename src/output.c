@@ -16,7 +16,7 @@
  *
  * OPTIONS available in an <outputN> block are:
  * - out       = cons,prim,d,M1,M2,M3,E,B1c,B2c,B3c,ME,V1,V2,V3,P,S,cs2,G
- * - out_fmt   = bin,hst,tab,rst,vtk,pdf,pgm,ppm
+ * - out_fmt   = bin,hst,tab,rst,vtk,pdf,pgm,ppm (+ phst,pdif,pspec,ptrk,lis w/ particles)
  * - dat_fmt   = format string used to write tabular output (e.g. %12.5e)
  * - dt        = problem time between outputs
  * - time      = time of next output (useful for restarts)
@@ -48,6 +48,7 @@
  * - <ouput3>
  * - out_fmt = rst
  * - out_dt  = 1.0
+ * - single_file = 1   (optional, MPI only: one file, see restart_mpiio.c)
  *
  * CONTROL of output proceeds as follows:
  *  -init_output(): called by main(), parses the first maxout output blocks.
@@ -270,6 +271,18 @@ Now use the default one.\n");
         new_out.out_fun = dump_particle_history;
         goto add_it; /* by default do not bin particles */
       }
+      else if (strcmp(fmt,"pdif")==0){
+        new_out.out_fun = dump_particle_diffusion;
+        goto add_it; /* by default do not bin particles */
+      }
+      else if (strcmp(fmt,"pspec")==0){
+        new_out.out_fun = dump_particle_spectrum;
+        goto add_it; /* by default do not bin particles */
+      }
+      else if (strcmp(fmt,"ptrk")==0){
+        new_out.out_fun = dump_particle_track;
+        goto add_it; /* by default do not bin particles */
+      }
 #endif
       else if (strcmp(fmt,"tab")==0){
 	new_out.out_fun = dump_tab_cons;
@@ -280,6 +293,11 @@ Now use the default one.\n");
       }
       else if (strcmp(fmt,"rst")==0){
 	new_out.res_fun = dump_restart;
+#ifdef MPI_PARALLEL
+        /* one file for all processors, readable with any decomposition */
+        if (par_geti_def(block,"single_file",0) == 1)
+          new_out.res_fun = dump_restart_mpiio;
+#endif
         rst_flag = 1;
         rst_out = new_out;
 	ath_pout(0,"Added out%d\n",outn);
@@ -295,6 +313,11 @@ Now use the default one.\n");
 #ifdef PARTICLES
       else if (strcmp(fmt,"lis")==0){ /* dump particle list */
 	new_out.out_fun = dump_particle_binary; 
+#ifdef MPI_PARALLEL
+        /* one file for all processors, written with MPI-IO */
+        if (par_geti_def(block,"single_file",0) == 1)
+          new_out.out_fun = dump_particle_mpiio;
+#endif
 	goto add_it; /* by default do not bin particles */
       }
 #endif
@@ -482,9 +505,10 @@ void data_output(MeshS *pM, const int flag)
 #ifdef PARTICLES
   DomainS *pD = &(pM->Domain[0][0]);
   GridS *pG = pD->Grid;
-  PropFun_t mypar_prop = NULL;
+  PropFun_t parsel[MAXOUT_DEFAULT];
+  int nparsel = 0;
 #endif
-  int n;
+  int n,nl,nd,ndump=0;
   int dump_flag[MAXOUT_DEFAULT+1];
   char block[80];
 
@@ -497,6 +521,20 @@ void data_output(MeshS *pM, const int flag)
       OutArray[n].t += OutArray[n].dt;
       dump_flag[n] = 1;
     }
+    ndump += dump_flag[n];
+  }
+  if (rst_flag && (flag != 0 || pM->time >= rst_out.t)) ndump++;
+
+/* The outputs may read the ghost zones, so complete a pending boundary
+ * exchange (see bvals_mhd_start()) first */
+
+  if (ndump > 0) {
+    for (nl=0; nl<(pM->NLevels); nl++){
+      for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+        if (pM->Domain[nl][nd].Grid != NULL)
+          bvals_mhd_finish(&(pM->Domain[nl][nd]));
+      }
+    }
   }
 
 /* Now check for restart dump, and make restart if dump_flag != 0 */
@@ -536,6 +574,15 @@ void data_output(MeshS *pM, const int flag)
     }
   }
 
+#ifdef PARTICLES
+/* Bin the particles for all the binned particle outputs in one pass */
+
+  for (n=0; n<out_count; n++)
+    if ((dump_flag[n] != 0) && (OutArray[n].out_pargrid == 1))
+      parsel[nparsel++] = OutArray[n].par_prop;
+  particle_moments(pD, nparsel, parsel);
+#endif
+
 /* Loop over all elements in output array, if dump_flag != 0, make output */
 
   for (n=0; n<out_count; n++) {
@@ -543,10 +590,7 @@ void data_output(MeshS *pM, const int flag)
 
 #ifdef PARTICLES
       if (OutArray[n].out_pargrid == 1)      /* binned particles are output */
-        if (OutArray[n].par_prop != mypar_prop) {
-          particle_to_grid(pD, OutArray[n].par_prop);
-          mypar_prop = OutArray[n].par_prop;
-        }
+        particle_moments_select(OutArray[n].par_prop);
 #endif
       (*OutArray[n].out_fun)(pM,&(OutArray[n]));
 
@@ -0,0 +1,292 @@
+#include "../copyright.h"
+/*============================================================================*/
+/*! \file backreaction_particle.c
+ *  \brief Deposition of the cosmic-ray charge, current and energy density for
+ *   the back-reaction of the particles on the gas.
+ *
+ * PURPOSE: Deposition of the cosmic-ray (charged particle) charge density,
+ *   current density and kinetic energy density onto the grid, and the source
+ *   terms of their back-reaction on the gas.  The back-reaction is optional:
+ *   it is switched on by enrolling a source term function with
+ *   cr_source_enroll() in the problem generator, or by <particle>/backreaction
+ *   = 1, which enrolls the Lorentz force cr_source_lorentz().
+ *
+ *   cr_deposit() is called by the integrator just before the particles are
+ *   pushed.  The particles are deposited at their half-step position
+ *   x + 0.5*dt*v, with the same weights getweight() as those with which the
+ *   Boris pusher interpolates the fields there, in one tiled pass (see
+ *   deposit_particle.c), so the deposition mirrors the gather: 5 quantities
+ *   per cell of the stencil against the 6 interpolated.  Only the grid
+ *   particles are deposited; the deposit in the ghost zones is added to the
+ *   neighbouring grids by exchange_moments().  The quantities (enum CRDep in
+ *   athena.h) are per unit volume:
+ *     crd_q = sum q,  crd_J1..3 = sum q*v,  crd_E = sum (gamma-1)*m
+ *   where the particle mass m is grproperty[].m with FEEDBACK, and
+ *   <particle>/cr_mass (default 1) otherwise, and q = grproperty[].alpha*m.
+ *
+ *   cr_source_terms() then calls the enrolled function after the particles
+ *   are pushed (before the corrector step of the integrator), with the
+ *   deposited arrays and the time step:
+ *
+ *     void fun(GridS *pG, Real ****crd, Real dt)
+ *
+ *   which adds the source terms for dt to pG->U in the active zones, e.g.
+ *   from the fields at t^{n+1/2} in pG->Whalf.
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - cr_source_enroll()  - enrolls the source term function
+ * - cr_deposit()        - deposits the particles at the half step
+ * - cr_source_terms()   - adds the source terms to the gas
+ * - cr_source_lorentz() - the Lorentz force of the particles on the gas
+ * - cr_destruct()       - frees the deposited arrays
+ *
+ * PRIVATE FUNCTION PROTOTYPES:
+ * - cr_init()       - reads the parameters and allocates the arrays
+ * - property_grid() - selects the grid particles
+ * - deposit_cr()    - deposits one particle                                 */
+/*============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../defs.h"
+#include "../athena.h"
+#include "../prototypes.h"
+#include "prototypes.h"
+#include "particle.h"
+#include "../globals.h"
+
+#ifdef PARTICLES         /* endif at the end of the file */
+
+static CRSrcFun_t CRSrcFun = NULL;  /* enrolled source term function */
+static int crinit = 0;              /* 1 once cr_init() is called */
+static Real ****crd = NULL;         /* deposited quantities [NCRDEP][k][j][i] */
+static Real crmass = 1.0;           /* particle mass without FEEDBACK */
+static Real dvol1 = 1.0;            /* one over the cell volume */
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   cr_init()       - reads the parameters and allocates the arrays
+ *   property_grid() - selects the grid particles
+ *   deposit_cr()    - deposits one particle
+ *============================================================================*/
+static void cr_init(GridS *pG);
+static int  property_grid(const GrainS *gr, const GrainAux *grsub);
+static void deposit_cr(GridS *pG, const GrainS *gr, Real weight[3][3][3],
+                       int is, int js, int ks);
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void cr_source_enroll(CRSrcFun_t fun)
+ *  \brief Enrolls the source term function of the back-reaction */
+void cr_source_enroll(CRSrcFun_t fun)
+{
+  CRSrcFun = fun;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void cr_deposit(DomainS *pD)
+ *  \brief Deposits the charge, current and energy density of the grid
+ *   particles at their half-step position.  Does nothing without
+ *   back-reaction.
+ */
+void cr_deposit(DomainS *pD)
+{
+  GridS *pG = pD->Grid;
+  int i,j,k,n;
+
+  if (crinit == 0) cr_init(pG);
+  if (CRSrcFun == NULL) return;
+
+  for (n=0; n<NCRDEP; n++) {
+#ifdef OPENMP
+#pragma omp parallel for private(i,j)
+#endif
+    for (k=klp; k<=kup; k++)
+      for (j=jlp; j<=jup; j++)
+        for (i=ilp; i<=iup; i++)
+          crd[n][k][j][i] = 0.0;
+  }
+
+  deposit_particles(pG, property_grid, deposit_cr, 0.5*pG->dt);
+
+  /* deposit ghost zone values into the boundary zones */
+  exchange_moments(pD, crd, 0, NCRDEP, -1);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void cr_source_terms(DomainS *pD, Real dt)
+ *  \brief Calls the enrolled source term function for time step dt */
+void cr_source_terms(DomainS *pD, Real dt)
+{
+  if (CRSrcFun == NULL) return;
+
+  (*CRSrcFun)(pD->Grid, crd, dt);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void cr_source_lorentz(GridS *pG, Real ****crd, Real dt)
+ *  \brief Lorentz force of the particles on the gas, opposite to the force of
+ *   the fields at t^{n+1/2} on the particles, E = -v x B:
+ *    S_{M} = -(q E + J x B);   S_{E} = -J.E
+ */
+void cr_source_lorentz(GridS *pG, Real ****crd, Real dt)
+{
+#ifdef MHD
+  int i,j,k;
+  Real E1,E2,E3,F1,F2,F3;
+  PrimS *W;
+
+  if (pG->Whalf == NULL)
+    ath_error("[cr_source_lorentz]: No half-step fields\n");
+
+  for (k=pG->ks; k<=pG->ke; k++) {
+    for (j=pG->js; j<=pG->je; j++) {
+      for (i=pG->is; i<=pG->ie; i++) {
+        W = &(pG->Whalf[k][j][i]);
+        E1 = W->B2c*W->V3 - W->B3c*W->V2;
+        E2 = W->B3c*W->V1 - W->B1c*W->V3;
+        E3 = W->B1c*W->V2 - W->B2c*W->V1;
+
+        F1 = crd[crd_q][k][j][i]*E1 + crd[crd_J2][k][j][i]*W->B3c
+                                    - crd[crd_J3][k][j][i]*W->B2c;
+        F2 = crd[crd_q][k][j][i]*E2 + crd[crd_J3][k][j][i]*W->B1c
+                                    - crd[crd_J1][k][j][i]*W->B3c;
+        F3 = crd[crd_q][k][j][i]*E3 + crd[crd_J1][k][j][i]*W->B2c
+                                    - crd[crd_J2][k][j][i]*W->B1c;
+
+        pG->U[k][j][i].M1 -= dt*F1;
+        pG->U[k][j][i].M2 -= dt*F2;
+        pG->U[k][j][i].M3 -= dt*F3;
+#ifndef BAROTROPIC
+        pG->U[k][j][i].E -= dt*(crd[crd_J1][k][j][i]*E1
+                              + crd[crd_J2][k][j][i]*E2
+                              + crd[crd_J3][k][j][i]*E3);
+#endif
+      }
+    }
+  }
+#else
+  ath_error("[cr_source_lorentz]: The Lorentz force requires MHD\n");
+#endif /* MHD */
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void cr_destruct(void)
+ *  \brief Frees the deposited arrays */
+void cr_destruct(void)
+{
+  int n;
+
+  if (crd != NULL) {
+    for (n=0; n<NCRDEP; n++)
+      if (crd[n] != NULL) free_3d_array(crd[n]);
+    free_1d_array(crd);
+  }
+  crd = NULL;
+  crinit = 0;
+
+  return;
+}
+
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*--------------------------------------------------------------------------- */
+/*! \fn static void cr_init(GridS *pG)
+ *  \brief Reads the parameters, and allocates the arrays if the back-reaction
+ *   is switched on */
+static void cr_init(GridS *pG)
+{
+  int n, N1T, N2T, N3T;
+
+  crinit = 1;
+
+  if ((CRSrcFun == NULL) && (par_geti_def("particle","backreaction",0) == 1))
+    CRSrcFun = cr_source_lorentz;
+  if (CRSrcFun == NULL) return;
+
+  crmass = par_getd_def("particle","cr_mass",1.0);
+
+  dvol1 = 1.0;
+  if (pG->Nx[0] > 1) dvol1 /= pG->dx1;
+  if (pG->Nx[1] > 1) dvol1 /= pG->dx2;
+  if (pG->Nx[2] > 1) dvol1 /= pG->dx3;
+
+  N1T = iup-ilp+1;
+  N2T = jup-jlp+1;
+  N3T = kup-klp+1;
+
+  if ((crd = (Real****)calloc_1d_array(NCRDEP, sizeof(Real***))) == NULL)
+    ath_error("[cr_init]: Error allocating memory\n");
+  for (n=0; n<NCRDEP; n++) {
+    crd[n] = (Real***)calloc_3d_array(N3T,N2T,N1T, sizeof(Real));
+    if (crd[n] == NULL)
+      ath_error("[cr_init]: Error allocating memory\n");
+  }
+
+  return;
+}
+
+/*--------------------------------------------------------------------------- */
+/*! \fn static int property_grid(const GrainS *gr, const GrainAux *grsub)
+ *  \brief Selects the grid particles (the ghost particles are deposited by
+ *   their own grid) */
+static int property_grid(const GrainS *gr, const GrainAux *grsub)
+{
+  return (gr->pos == 1);
+}
+
+/*--------------------------------------------------------------------------- */
+/*! \fn static void deposit_cr(GridS *pG, const GrainS *gr,
+ *                 Real weight[3][3][3], int is, int js, int ks)
+ *  \brief Adds the charge, current and energy density of one particle */
+static void deposit_cr(GridS *pG, const GrainS *gr, Real weight[3][3][3],
+                       int is, int js, int ks)
+{
+  int i,j,k, k1,k2, j1,j2, i1,i2;
+  int n0 = ncell-1;
+  Real w, m, q, qv1, qv2, qv3, e, vsq;
+
+  k1 = MAX(ks, klp);    k2 = MIN(ks+n0, kup);
+  j1 = MAX(js, jlp);    j2 = MIN(js+n0, jup);
+  i1 = MAX(is, ilp);    i2 = MIN(is+n0, iup);
+
+#ifdef FEEDBACK
+  m = grproperty[gr->property].m*dvol1;
+#else
+  m = crmass*dvol1;
+#endif
+  q = grproperty[gr->property].alpha*m;
+  qv1 = q*gr->v1;
+  qv2 = q*gr->v2;
+  qv3 = q*gr->v3;
+  vsq = SQR(gr->v1) + SQR(gr->v2) + SQR(gr->v3);
+#ifdef SPECIAL_RELATIVITY
+  e = (1.0/sqrt(MAX(1.0 - vsq, TINY_NUMBER)) - 1.0)*m;
+#else
+  e = 0.5*vsq*m;
+#endif
+
+  for (k=k1; k<=k2; k++) {
+    for (j=j1; j<=j2; j++) {
+      for (i=i1; i<=i2; i++) {
+        w = weight[k-ks][j-js][i-is];
+        crd[crd_q ][k][j][i] += w*q;
+        crd[crd_J1][k][j][i] += w*qv1;
+        crd[crd_J2][k][j][i] += w*qv2;
+        crd[crd_J3][k][j][i] += w*qv3;
+        crd[crd_E ][k][j][i] += w*e;
+      }
+    }
+  }
+
+  return;
+}
+
+#endif /* PARTICLES */
@@ -50,9 +50,9 @@
 
 /* particle structure size */
 #ifdef MPI_PARALLEL
-#define NVAR_P 10
+#define NVAR_P 13
 #else
-#define NVAR_P 9
+#define NVAR_P 12
 #endif
 
 /* send and receive buffer, size dynamically determined
@@ -922,7 +922,7 @@ void advect_particles(DomainS *pD)
   GridS *pG = pD->Grid;
   GrainS *gr;
   long p;
-  Real x1l, x1u;
+  Real x1l, x1u, x2old;
 #ifdef MPI_PARALLEL
   long cnt_recv, n;
   int ishl, ishu, i;
@@ -944,7 +944,9 @@ void advect_particles(DomainS *pD)
   /* shift the particles */
   for (p=0; p<pG->nparticle; p++) {
     gr = &(pG->particle[p]);
-    gr->x2 = x2min + fmod(gr->x2 + pG->parsub[p].shift - x2min + Lx2, Lx2);
+    x2old = gr->x2 + pG->parsub[p].shift;
+    gr->x2 = x2min + fmod(x2old - x2min + Lx2, Lx2);
+    gr->x2_0 += gr->x2 - x2old;  /* keep the displacement unwrapped */
   }
 
 #ifdef MPI_PARALLEL
@@ -2037,6 +2039,9 @@ static void packing_one_particle(GrainS *gr, long n, short pos)
 #ifdef MPI_PARALLEL
   *(pd++) = (double)(gr->init_id)+0.01;
 #endif
+  *(pd++) = gr->x1_0;
+  *(pd++) = gr->x2_0;
+  *(pd++) = gr->x3_0;
 
   return;
 }
@@ -2053,6 +2058,8 @@ static void packing_one_particle(GrainS *gr, long n, short pos)
  *   shift: amount of change.
  * Output:
  *   buf: buffer with shifted particles
+ * A shift in x1/x2/x3 is also applied to the initial coordinate (the last
+ * three packed values), so that x-x_0 remains the unwrapped displacement.
  */
 static void shift_packed_particle(double *buf, long n, int index, double shift)
 {
@@ -2066,6 +2073,9 @@ static void shift_packed_particle(double *buf, long n, int index, double shift)
   }
   *pd += shift;
 
+  if (index <= 3)
+    shift_packed_particle(buf, n, NVAR_P-3+index, shift);
+
   return;
 }
 
@@ -2107,6 +2117,9 @@ static void unpack_particle(GridS *pG, double *buf, long n)
 #ifdef MPI_PARALLEL
     gr->init_id = (int)(*(pd++));
 #endif
+    gr->x1_0 = *(pd++);
+    gr->x2_0 = *(pd++);
+    gr->x3_0 = *(pd++);
   }
 
   return;
@@ -2434,6 +2447,7 @@ static long packing_ix1_particle_shear(GridS *pG, int reg, long numpar)
   Real yshear, yshift;
   /* x2c: y-coordinate marking the demarcation of the two regions */
   Real x20, x2c;
+  Real x2old;		/* x2 before the shift, to update x2_0 */
   double *pd;
 
 /*---------------- Step.1 -----------------------*/
@@ -2462,7 +2476,9 @@ static long packing_ix1_particle_shear(GridS *pG, int reg, long numpar)
       if (((reg == 1) && (gr->x2 >= x2c)) || ((reg == 2) && (gr->x2 < x2c)))
       {         /* region I */                      /* region II */
         /* apply the shift */
+        x2old = gr->x2;
         gr->x2 = x2min + fmod(gr->x2 - x2min + yshift, Lx2);
+        gr->x2_0 += gr->x2 - x2old;
 
         /* pack the particle */
         packing_one_particle(gr, n, gr->pos);
@@ -2475,8 +2491,11 @@ static long packing_ix1_particle_shear(GridS *pG, int reg, long numpar)
         pG->particle[p] = pG->particle[pG->nparticle];
       }
 
-      if (reg == 0) /* non-mpi case, directly shift the particle positions */
+      if (reg == 0) { /* non-mpi case, directly shift the particle positions */
+        x2old = gr->x2;
         gr->x2 = x2min + fmod(gr->x2 - x2min + yshift, Lx2);
+        gr->x2_0 += gr->x2 - x2old;
+      }
     }
   }
 
@@ -2501,6 +2520,7 @@ static long packing_ox1_particle_shear(GridS *pG, int reg, long numpar)
   Real yshear, yshift;
   /* x2c: y-coordinate marking the demarcation of the two regions */
   Real x20, x2c;
+  Real x2old;		/* x2 before the shift, to update x2_0 */
   double *pd;
 
 /*---------------- Step.1 -----------------------*/
@@ -2530,7 +2550,9 @@ static long packing_ox1_particle_shear(GridS *pG, int reg, long numpar)
       {         /* region I */                      /* region II */
 
         /* apply the shift */
+        x2old = gr->x2;
         gr->x2 = x2min + fmod(gr->x2 - x2min + Lx2 - yshift, Lx2);
+        gr->x2_0 += gr->x2 - x2old;
 
         /* pack the particle */
         packing_one_particle(gr, n, gr->pos);
@@ -2542,8 +2564,11 @@ static long packing_ox1_particle_shear(GridS *pG, int reg, long numpar)
         p -= 1;
         pG->particle[p] = pG->particle[pG->nparticle];
       }
-      if (reg == 0) /* non-mpi case, directly shift the particle positions */
+      if (reg == 0) { /* non-mpi case, directly shift the particle positions */
+        x2old = gr->x2;
         gr->x2 = x2min + fmod(gr->x2 - x2min + Lx2 - yshift, Lx2);
+        gr->x2_0 += gr->x2 - x2old;
+      }
     }
   }
 
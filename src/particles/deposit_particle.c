@@ -0,0 +1,177 @@
+#include "../copyright.h"
+/*============================================================================*/
+/*! \file deposit_particle.c
+ *  \brief Threaded deposition of particle quantities onto the grid.
+ *
+ * PURPOSE: Threaded deposition of particle quantities onto the grid, without
+ *   atomic operations.  The grid (including the ghost zones ilp..iup etc.)
+ *   is divided into tiles of <particle>/deposit_tile cells in each direction
+ *   (default 8), and the selected particles are sorted by tile with a
+ *   counting sort.  The tiles are then given 8 colours by the parity of
+ *   their tile indices in x1,x2,x3.  A particle deposits at most one cell
+ *   beyond its own cell, so with tiles of at least 2 cells, two tiles of the
+ *   same colour never deposit into the same cell: the tiles of one colour are
+ *   processed in parallel (with OpenMP), one colour after the other.
+ *
+ *   Within a tile the particles keep their order in the particle array, so
+ *   the result does not depend on the number of threads.
+ *
+ *   The particles are deposited at their position drifted by drift*v, e.g.
+ *   drift = 0.5*dt for the half-step position at which the Boris pusher
+ *   interpolates the fields (drift = 0 for the current position).
+ *
+ *   The quantity to deposit is given by a function of type DepFun_t, which
+ *   adds the contribution of one particle with the weights of getweight().
+ *   Only the cells k,j,i with klp<=k<=kup, jlp<=j<=jup, ilp<=i<=iup may be
+ *   changed, and the weight of cell k,j,i is weight[k-ks][j-js][i-is].
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - deposit_particles() - deposits the selected particles onto the grid
+ * - deposit_destruct()  - frees the tile arrays
+ *                                                                            */
+/*============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../defs.h"
+#include "../athena.h"
+#include "../prototypes.h"
+#include "prototypes.h"
+#include "particle.h"
+#include "../globals.h"
+
+#ifdef PARTICLES         /* endif at the end of the file */
+
+static int ntw = 0;            /* tile width in cells */
+static long *ptile = NULL;     /* tile index of each particle, -1: not used */
+static long *porder = NULL;    /* particle indices sorted by tile */
+static long *tstart = NULL;    /* first entry of each tile in porder */
+static long npbuf = 0, ntbuf = 0;  /* sizes of the particle and tile arrays */
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void deposit_particles(GridS *pG, PropFun_t par_prop, DepFun_t dep,
+ *                              Real drift)
+ *  \brief Calls dep() for all the particles selected by par_prop, at their
+ *   position drifted by drift*v, in parallel over tiles of the same colour */
+void deposit_particles(GridS *pG, PropFun_t par_prop, DepFun_t dep, Real drift)
+{
+  int i,j,k,c,nt1,nt2,nt3;
+  long p,n,t,ntile;
+  Real a;
+  Real3Vect cell1, d;
+  GrainS *gr;
+
+  if (ntw == 0) {
+    ntw = par_geti_def("particle","deposit_tile",8);
+    if (ntw < 2)
+      ath_error("[deposit_particles]: deposit_tile must be >= 2, not %d\n",
+                ntw);
+  }
+
+  /* Get grid limit related quantities */
+  if (pG->Nx[0] > 1)  cell1.x1 = 1.0/pG->dx1;
+  else                cell1.x1 = 0.0;
+  if (pG->Nx[1] > 1)  cell1.x2 = 1.0/pG->dx2;
+  else                cell1.x2 = 0.0;
+  if (pG->Nx[2] > 1)  cell1.x3 = 1.0/pG->dx3;
+  else                cell1.x3 = 0.0;
+
+  /* drift in the dimensions that do not collapse */
+  d.x1 = (pG->Nx[0] > 1) ? drift : 0.0;
+  d.x2 = (pG->Nx[1] > 1) ? drift : 0.0;
+  d.x3 = (pG->Nx[2] > 1) ? drift : 0.0;
+
+  /* number of tiles in each direction */
+  nt1 = (iup - ilp + ntw)/ntw;
+  nt2 = (jup - jlp + ntw)/ntw;
+  nt3 = (kup - klp + ntw)/ntw;
+  ntile = (long)nt1*nt2*nt3;
+
+  if (pG->nparticle > npbuf) {
+    if (ptile != NULL) free_1d_array(ptile);
+    if (porder != NULL) free_1d_array(porder);
+    npbuf = pG->arrsize;
+    ptile  = (long*)calloc_1d_array(npbuf, sizeof(long));
+    porder = (long*)calloc_1d_array(npbuf, sizeof(long));
+  }
+  if (ntile+1 > ntbuf) {
+    if (tstart != NULL) free_1d_array(tstart);
+    ntbuf = ntile+1;
+    tstart = (long*)calloc_1d_array(ntbuf, sizeof(long));
+  }
+
+/* Sort the selected particles by tile (counting sort) */
+
+  for (t=0; t<=ntile; t++) tstart[t] = 0;
+
+  for (p=0; p<pG->nparticle; p++) {
+    gr = &(pG->particle[p]);
+    if ((*par_prop)(gr, &(pG->parsub[p]))) {/* 1: true; 0: false */
+      i = ilp;  j = jlp;  k = klp;
+      if (cell1.x1 > 0.0) celli(pG, gr->x1+d.x1*gr->v1, cell1.x1, &i, &a);
+      if (cell1.x2 > 0.0) cellj(pG, gr->x2+d.x2*gr->v2, cell1.x2, &j, &a);
+      if (cell1.x3 > 0.0) cellk(pG, gr->x3+d.x3*gr->v3, cell1.x3, &k, &a);
+      i = MIN(MAX((i-ilp)/ntw, 0), nt1-1);
+      j = MIN(MAX((j-jlp)/ntw, 0), nt2-1);
+      k = MIN(MAX((k-klp)/ntw, 0), nt3-1);
+      ptile[p] = ((long)k*nt2 + j)*nt1 + i;
+      tstart[ptile[p]+1] += 1;
+    }
+    else
+      ptile[p] = -1;
+  }
+
+  for (t=0; t<ntile; t++) tstart[t+1] += tstart[t];
+
+  for (p=0; p<pG->nparticle; p++)
+    if (ptile[p] >= 0) porder[tstart[ptile[p]]++] = p;
+
+  /* tstart[t] is now the end of tile t; shift it back to its start */
+  for (t=ntile; t>0; t--) tstart[t] = tstart[t-1];
+  tstart[0] = 0;
+
+/* Deposit colour by colour, the tiles of one colour in parallel */
+
+  for (c=0; c<8; c++) {
+    int c1 = c & 1, c2 = (c >> 1) & 1, c3 = (c >> 2) & 1;
+    long n1 = (nt1 - c1 + 1)/2, n2 = (nt2 - c2 + 1)/2, n3 = (nt3 - c3 + 1)/2;
+
+#ifdef OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (n=0; n<n1*n2*n3; n++) {
+      long tile, q;
+      int is, js, ks;
+      Real weight[3][3][3];
+      GrainS *grn;
+
+      tile = ((2*(n/(n1*n2)) + c3)*nt2 + (2*((n/n1)%n2) + c2))*nt1
+           + (2*(n%n1) + c1);
+      for (q=tstart[tile]; q<tstart[tile+1]; q++) {
+        grn = &(pG->particle[porder[q]]);
+        getweight(pG, grn->x1+d.x1*grn->v1, grn->x2+d.x2*grn->v2,
+                      grn->x3+d.x3*grn->v3, cell1, weight, &is, &js, &ks);
+        (*dep)(pG, grn, weight, is, js, ks);
+      }
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void deposit_destruct(void)
+ *  \brief Frees the tile arrays */
+void deposit_destruct(void)
+{
+  if (ptile != NULL) free_1d_array(ptile);
+  if (porder != NULL) free_1d_array(porder);
+  if (tstart != NULL) free_1d_array(tstart);
+  ptile = NULL;  porder = NULL;  tstart = NULL;
+  npbuf = 0;  ntbuf = 0;
+
+  return;
+}
+
+#endif /* PARTICLES */
@@ -0,0 +1,137 @@
+#include "../copyright.h"
+/*============================================================================*/
+/*! \file dump_particle_diffusion.c
+ *  \brief Functions to write in-situ particle displacement statistics, from
+ *   which running diffusion coefficients are obtained.
+ *
+ * PURPOSE: Functions to write in-situ particle displacement statistics.  The
+ *   displacement of every grid particle from its initial position,
+ *   dx = x - x_0, is unwrapped across periodic boundaries (x_0 is shifted
+ *   together with x by the particle boundary conditions).  The moments
+ *   <dx_i> and <dx_i dx_j> are accumulated on each processor by species
+ *   (particle property) and kinetic energy bin, summed on the root process
+ *   with a single MPI_Reduce and appended to <basename>.<id>.pdif.  The
+ *   running diffusion coefficients follow as
+ *     D_ij(t) = (<dx_i dx_j> - <dx_i><dx_j>) / (2 (t - t_0)),
+ *   see read_diffusion() in vis/particle/particles.py.  With a guide field
+ *   along x1, D_11 is the parallel and D_22, D_33 the perpendicular
+ *   coefficients.  This replaces the post-processing of full trajectories.
+ *
+ *   The energy binning and the file append are shared with the .pspec output
+ *   (dump_particle_spectrum.c): the kinetic
+ *   energy per unit mass (gamma-1 with special relativity, v^2/2 otherwise)
+ *   is binned in nekin logarithmic bins between ekin_min and ekin_max, and
+ *   particles outside of this range are counted in the first/last bin (use
+ *   nekin=1 for one bin per species).  The output is meant to be written at
+ *   the history cadence, i.e. with the same dt as the hst/phst outputs.
+ *
+ *   The options are read from the <outputN> block:
+ *   - nekin    = number of energy bins (default 16)
+ *   - ekin_min = lower edge of the energy bins (default 1e-4)
+ *   - ekin_max = upper edge of the energy bins (default 1e4)
+ *
+ *   File layout (native endianness):
+ *   - header, written with the first output (num=0):
+ *     int sizeof(Real), int npartypes, int nekin, int NDIFF_MOM,
+ *     Real ekin edges[nekin+1]
+ *   - one record per output:
+ *     Real time, Real mom[npartypes][nekin][NDIFF_MOM]
+ *     with mom = {N, <dx1>, <dx2>, <dx3>, <dx1dx1>, <dx1dx2>, <dx1dx3>,
+ *                 <dx2dx2>, <dx2dx3>, <dx3dx3>}  (moments are 0 for N=0)
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - dump_particle_diffusion() - accumulates and appends displacement moments*/
+/*============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../defs.h"
+#include "../athena.h"
+#include "../globals.h"
+#include "../prototypes.h"
+#include "prototypes.h"
+#include "particle.h"
+
+#ifdef PARTICLES /* endif at the end of the file */
+
+/* number of moments per species and energy bin (count, 3 first, 6 second) */
+#define NDIFF_MOM 10
+
+/*============================================================================*/
+/*----------------------------- Public Functions -----------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void dump_particle_diffusion(MeshS *pM, OutputS *pOut)
+ *  \brief Accumulates the unwrapped particle displacement moments by species
+ *   and energy and appends the globally summed moments to a binary file */
+void dump_particle_diffusion(MeshS *pM, OutputS *pOut)
+{
+  DomainS *pD = (DomainS*)&(pM->Domain[0][0]);
+  GridS   *pG = pD->Grid;
+  GrainS  *gr;
+  char block[80];
+  int n, nekin, nbin, ie;
+  long p;
+  Real lemin, dlekin, dx1, dx2, dx3;
+  Real *mom, *pm;
+
+/* Read the binning parameters from the <outputN> block */
+
+  sprintf(block,"output%d",pOut->n);
+  ekin_bins_init(block, 16, &nekin, &lemin, &dlekin);
+  nbin = npartypes*nekin;
+
+  mom = (Real*)calloc_1d_array(nbin*NDIFF_MOM, sizeof(Real));
+  if (mom == NULL)
+    ath_error("[dump_particle_diffusion]: Error allocating memory\n");
+
+/* Accumulate the sums of the displacements on this processor */
+
+  for (p=0; p<pG->nparticle; p++) {
+    gr = &(pG->particle[p]);
+    if (gr->pos != 1) continue; /* skip ghost particles */
+
+    ie = ekin_bin(gr, lemin, dlekin, nekin);
+
+    dx1 = gr->x1 - gr->x1_0;
+    dx2 = gr->x2 - gr->x2_0;
+    dx3 = gr->x3 - gr->x3_0;
+
+    pm = &(mom[(gr->property*nekin + ie)*NDIFF_MOM]);
+    pm[0] += 1.0;
+    pm[1] += dx1;
+    pm[2] += dx2;
+    pm[3] += dx3;
+    pm[4] += dx1*dx1;
+    pm[5] += dx1*dx2;
+    pm[6] += dx1*dx3;
+    pm[7] += dx2*dx2;
+    pm[8] += dx2*dx3;
+    pm[9] += dx3*dx3;
+  }
+
+/* Sum over all processors on the root process, convert the sums into
+ * averages and append the record */
+
+  mom = particle_hist_sum(mom, nbin*NDIFF_MOM);
+
+  if (myID_Comm_world == 0) {
+    for (n=0; n<nbin; n++) {
+      pm = &(mom[n*NDIFF_MOM]);
+      if (pm[0] > 0.0)
+        for (ie=1; ie<NDIFF_MOM; ie++) pm[ie] /= pm[0];
+    }
+  }
+
+  particle_hist_append(pM, pOut, "pdif", nekin, lemin, dlekin,
+                       NDIFF_MOM, NULL, nbin*NDIFF_MOM, mom);
+
+  free_1d_array(mom);
+
+  return;
+}
+
+#undef NDIFF_MOM
+
+#endif /* PARTICLES */
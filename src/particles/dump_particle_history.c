@@ -96,6 +96,7 @@ void dump_particle_history(MeshS *pM, OutputS *pOut)
   Real scal[NSCAL+MAX_USR_SCAL],**array,rho,dvol;
   char fmt[20], *fname;
   GrainS *gr;
+  PropFun_t allsel[1] = {property_all};
 
 #ifdef MPI_PARALLEL
   Real my_scal[NSCAL+MAX_USR_SCAL],*sendbuf,*recvbuf;
@@ -132,8 +133,8 @@ void dump_particle_history(MeshS *pM, OutputS *pOut)
   pD = (DomainS*)&(pM->Domain[0][0]);  /* set ptr to Domain */
   pG = pM->Domain[0][0].Grid;          /* set ptr to Grid */
 
-  /* bin particles to the grid */
-  particle_to_grid(pD,property_all);
+  /* bin particles to the grid (or reuse the binning of the grid outputs) */
+  particle_moments(pD, 1, allsel);
 
 /*--------------------- Compute scalar history variables ---------------------*/
 
@@ -0,0 +1,193 @@
+#include "../copyright.h"
+/*============================================================================*/
+/*! \file dump_particle_mpiio.c
+ *  \brief Function to write an unbinned particle snapshot of all processors
+ *   into a single file with collective MPI-IO.
+ *
+ * PURPOSE: Function to write an unbinned particle snapshot of all processors
+ *   into a single file <basename>.<num>.<id>.plis in the run directory,
+ *   instead of one .lis file per processor.  It is selected with
+ *   single_file = 1 in an <outputN> block with out_fmt = lis.  The particle
+ *   offset of each processor is computed with MPI_Exscan, and each quantity is
+ *   written as one contiguous column block for all particles with a single
+ *   collective MPI_File_write_at_all() per column.
+ *
+ *   The header carries the same metadata as the .lis files, the grid bounds
+ *   being those of the whole domain.  Only grid particles (pos=1) selected by
+ *   par_prop are written, so no particle is written twice.
+ *
+ *   File layout (native endianness):
+ *   - float bounds[12]  (domain bounds twice, as grid and domain bounds of
+ *                        the .lis header), int npartypes, float rad[npartypes],
+ *                        float time, float dt, long N
+ *   - float x1[N], x2[N], x3[N], v1[N], v2[N], v3[N], dpar[N],
+ *     int property[N], long my_id[N], int init_id[N]
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - dump_particle_mpiio() - writes the single-file particle snapshot         */
+/*============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include "../defs.h"
+#include "../athena.h"
+#include "../globals.h"
+#include "../prototypes.h"
+#include "prototypes.h"
+#include "particle.h"
+
+#if defined(PARTICLES) && defined(MPI_PARALLEL) /* endif at the end of file */
+
+/*============================================================================*/
+/*----------------------------- Public Functions -----------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void dump_particle_mpiio(MeshS *pM, OutputS *pOut)
+ *  \brief Dumps the unbinned particles of all processors into one file */
+void dump_particle_mpiio(MeshS *pM, OutputS *pOut)
+{
+  DomainS *pD = (DomainS*)&(pM->Domain[0][0]);
+  GridS   *pG = pD->Grid;
+  GrainS  *gr;
+  MPI_File fh;
+  MPI_Status stat;
+  MPI_Offset hsize, base;
+  char *fname, name[MAXLEN];
+  int i, err, *ibuf;
+  long p, n, nout, ntot, offset, *lbuf;
+  float *fbuf, *hdr;
+
+/* Construct the filename on the root process (the other processes have a
+ * different outfilename) and share it */
+
+  if (myID_Comm_world == 0) {
+    if((fname = ath_fname("../",pM->outfilename,NULL,NULL,num_digit,
+        pOut->num,pOut->id,"plis")) == NULL)
+      ath_error("[dump_particle_mpiio]: Error constructing filename\n");
+    strncpy(name, fname, MAXLEN-1);
+    name[MAXLEN-1] = '\0';
+    free(fname);
+  }
+  err = MPI_Bcast(name, MAXLEN, MPI_CHAR, 0, MPI_COMM_WORLD);
+  if (err) ath_error("[dump_particle_mpiio]: MPI_Bcast error = %d\n",err);
+
+/* Bin all the particles to the grid and get the local particle density, as
+ * in dump_particle_binary() */
+
+  particle_dpar(pD);
+
+  nout = 0;
+  for (p=0; p<pG->nparticle; p++) {
+    gr = &(pG->particle[p]);
+    if ((gr->pos == 1) && (*(pOut->par_prop))(gr, &(pG->parsub[p])))
+      nout += 1;
+  }
+
+/* Particle offset of this process and total number of particles */
+
+  offset = 0;
+  err = MPI_Exscan(&nout, &offset, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+  if (err) ath_error("[dump_particle_mpiio]: MPI_Exscan error = %d\n",err);
+  if (myID_Comm_world == 0) offset = 0; /* undefined on the first process */
+
+  err = MPI_Allreduce(&nout, &ntot, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+  if (err) ath_error("[dump_particle_mpiio]: MPI_Allreduce error = %d\n",err);
+
+/* Open (and truncate) the file */
+
+  err = MPI_File_open(MPI_COMM_WORLD, name, MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                      MPI_INFO_NULL, &fh);
+  if (err) ath_error("[dump_particle_mpiio]: Unable to open %s\n",name);
+  MPI_File_set_size(fh, 0);
+
+/* The root process writes the header */
+
+  hsize = 14*sizeof(float) + sizeof(int) + npartypes*sizeof(float)
+        + sizeof(long);
+
+  if (myID_Comm_world == 0) {
+    hdr = (float*)calloc_1d_array(MAX(npartypes,14), sizeof(float));
+    if (hdr == NULL)
+      ath_error("[dump_particle_mpiio]: Error allocating memory\n");
+
+    for (i=0; i<2; i++) {
+      hdr[6*i  ] = (float)(pM->RootMinX[0]);
+      hdr[6*i+1] = (float)(pM->RootMaxX[0]);
+      hdr[6*i+2] = (float)(pM->RootMinX[1]);
+      hdr[6*i+3] = (float)(pM->RootMaxX[1]);
+      hdr[6*i+4] = (float)(pM->RootMinX[2]);
+      hdr[6*i+5] = (float)(pM->RootMaxX[2]);
+    }
+    base = 0;
+    MPI_File_write_at(fh, base, hdr, 12, MPI_FLOAT, &stat);
+    base += 12*sizeof(float);
+    MPI_File_write_at(fh, base, &npartypes, 1, MPI_INT, &stat);
+    base += sizeof(int);
+    for (i=0; i<npartypes; i++)
+      hdr[i] = (float)(grproperty[i].rad);
+    MPI_File_write_at(fh, base, hdr, npartypes, MPI_FLOAT, &stat);
+    base += npartypes*sizeof(float);
+    hdr[0] = (float)pG->time;
+    hdr[1] = (float)pG->dt;
+    MPI_File_write_at(fh, base, hdr, 2, MPI_FLOAT, &stat);
+    base += 2*sizeof(float);
+    MPI_File_write_at(fh, base, &ntot, 1, MPI_LONG, &stat);
+
+    free_1d_array(hdr);
+  }
+
+/* Stage the columns of the selected particles */
+
+  fbuf = (float*)calloc_1d_array(7*MAX(nout,1), sizeof(float));
+  ibuf = (int*)calloc_1d_array(2*MAX(nout,1), sizeof(int));
+  lbuf = (long*)calloc_1d_array(MAX(nout,1), sizeof(long));
+  if ((fbuf == NULL) || (ibuf == NULL) || (lbuf == NULL))
+    ath_error("[dump_particle_mpiio]: Error allocating memory\n");
+
+  n = 0;
+  for (p=0; p<pG->nparticle; p++) {
+    gr = &(pG->particle[p]);
+    if ((gr->pos != 1) || !((*(pOut->par_prop))(gr, &(pG->parsub[p]))))
+      continue;
+    fbuf[       n] = (float)(gr->x1);
+    fbuf[  nout+n] = (float)(gr->x2);
+    fbuf[2*nout+n] = (float)(gr->x3);
+    fbuf[3*nout+n] = (float)(gr->v1);
+    fbuf[4*nout+n] = (float)(gr->v2);
+    fbuf[5*nout+n] = (float)(gr->v3);
+    fbuf[6*nout+n] = (float)(pG->parsub[p].dpar);
+    ibuf[       n] = gr->property;
+    ibuf[  nout+n] = gr->init_id;
+    lbuf[       n] = gr->my_id;
+    n++;
+  }
+
+/* Write one column block at a time, collectively */
+
+  base = hsize;
+  for (i=0; i<7; i++) {
+    MPI_File_write_at_all(fh, base + offset*sizeof(float), &(fbuf[i*nout]),
+                          (int)nout, MPI_FLOAT, &stat);
+    base += ntot*sizeof(float);
+  }
+  MPI_File_write_at_all(fh, base + offset*sizeof(int), ibuf, (int)nout,
+                        MPI_INT, &stat);
+  base += ntot*sizeof(int);
+  MPI_File_write_at_all(fh, base + offset*sizeof(long), lbuf, (int)nout,
+                        MPI_LONG, &stat);
+  base += ntot*sizeof(long);
+  MPI_File_write_at_all(fh, base + offset*sizeof(int), &(ibuf[nout]),
+                        (int)nout, MPI_INT, &stat);
+
+  MPI_File_close(&fh);
+
+  free_1d_array(fbuf);
+  free_1d_array(ibuf);
+  free_1d_array(lbuf);
+
+  return;
+}
+
+#endif /* PARTICLES && MPI_PARALLEL */
@@ -0,0 +1,332 @@
+#include "../copyright.h"
+/*============================================================================*/
+/*! \file dump_particle_spectrum.c
+ *  \brief Functions to write in-situ particle energy spectra and pitch-angle
+ *   distributions as a binary time series.
+ *
+ * PURPOSE: Functions to write in-situ particle energy spectra and pitch-angle
+ *   distributions.  Every grid particle is binned on its own processor by
+ *   species (particle property), kinetic energy and pitch angle cosine with
+ *   respect to the local magnetic field.  The histograms are summed on the root
+ *   process with a single MPI_Reduce and appended to <basename>.<id>.pspec.
+ *   This replaces the post-processing of full .lis dumps for spectra.
+ *
+ *   The kinetic energy per unit mass (c=1) is gamma-1 with special relativity
+ *   and v^2/2 otherwise (as in vis/particle/particles.py).  It is binned in
+ *   nekin logarithmic bins between ekin_min and ekin_max; particles outside of
+ *   this range are counted in the first/last bin.  The pitch angle cosine
+ *   mu = v.B/|v||B| is binned in nmu uniform bins in [-1,1]; without MHD (or
+ *   for B=0) mu is measured with respect to the x1 axis.
+ *
+ *   The options are read from the <outputN> block:
+ *   - nekin    = number of energy bins (default 64)
+ *   - ekin_min = lower edge of the energy bins (default 1e-4)
+ *   - ekin_max = upper edge of the energy bins (default 1e4)
+ *   - nmu      = number of pitch angle bins (default 32)
+ *
+ *   File layout (native endianness):
+ *   - header, written with the first output (num=0):
+ *     int sizeof(Real), int npartypes, int nekin, int nmu,
+ *     Real ekin edges[nekin+1], Real mu edges[nmu+1]
+ *   - one record per output:
+ *     Real time, Real counts[npartypes][nekin][nmu]
+ *
+ *   The energy binning, the reduction and the file append are shared with
+ *   the .pdif output (dump_particle_diffusion.c).
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - dump_particle_spectrum() - bins particles and appends the histograms
+ * - ekin_bins_init()         - reads and checks the energy binning parameters
+ * - ekin_bin()               - returns the energy bin of a particle
+ * - particle_hist_sum()      - sums a histogram on the root process
+ * - particle_hist_append()   - appends a histogram record to a binary file
+ *
+ * PRIVATE FUNCTION PROTOTYPES:
+ * - get_bfield()             - interpolates cell centered B to a particle   */
+/*============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../defs.h"
+#include "../athena.h"
+#include "../globals.h"
+#include "../prototypes.h"
+#include "prototypes.h"
+#include "particle.h"
+
+#ifdef PARTICLES /* endif at the end of the file */
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   get_bfield() - interpolates cell centered B to a particle
+ *============================================================================*/
+#ifdef MHD
+static void get_bfield(GridS *pG, GrainS *gr, Real3Vect cell1, Real B[3]);
+#endif
+
+/*============================================================================*/
+/*----------------------------- Public Functions -----------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void dump_particle_spectrum(MeshS *pM, OutputS *pOut)
+ *  \brief Bins grid particles by species, energy and pitch angle and appends
+ *   the globally summed histograms to a binary file */
+void dump_particle_spectrum(MeshS *pM, OutputS *pOut)
+{
+  DomainS *pD = (DomainS*)&(pM->Domain[0][0]);
+  GridS   *pG = pD->Grid;
+  GrainS  *gr;
+  char block[80];
+  int n, nekin, nmu, nbin, ie, im;
+  long p;
+  Real lemin, dlekin, vmag, mu;
+  Real *hist, *mu_edges;
+  Real3Vect cell1;
+#ifdef MHD
+  Real B[3], bmag;
+#endif
+
+/* Read the binning parameters from the <outputN> block */
+
+  sprintf(block,"output%d",pOut->n);
+  ekin_bins_init(block, 64, &nekin, &lemin, &dlekin);
+  nmu = par_geti_def(block,"nmu",32);
+
+  if (nmu < 1)
+    ath_error("[dump_particle_spectrum]: %s/nmu must be >= 1\n",block);
+
+  nbin = npartypes*nekin*nmu;
+
+  hist = (Real*)calloc_1d_array(nbin, sizeof(Real));
+  if (hist == NULL)
+    ath_error("[dump_particle_spectrum]: Error allocating memory\n");
+
+  if (pG->Nx[0] > 1)  cell1.x1 = 1.0/pG->dx1;  else cell1.x1 = 0.0;
+  if (pG->Nx[1] > 1)  cell1.x2 = 1.0/pG->dx2;  else cell1.x2 = 0.0;
+  if (pG->Nx[2] > 1)  cell1.x3 = 1.0/pG->dx3;  else cell1.x3 = 0.0;
+
+/* Bin the grid particles on this processor */
+
+  for (p=0; p<pG->nparticle; p++) {
+    gr = &(pG->particle[p]);
+    if (gr->pos != 1) continue; /* skip ghost particles */
+
+    ie   = ekin_bin(gr, lemin, dlekin, nekin);
+    vmag = sqrt(SQR(gr->v1) + SQR(gr->v2) + SQR(gr->v3));
+
+    mu = 0.0;
+    if (vmag > TINY_NUMBER) {
+      mu = gr->v1/vmag;
+#ifdef MHD
+      get_bfield(pG, gr, cell1, B);
+      bmag = sqrt(SQR(B[0]) + SQR(B[1]) + SQR(B[2]));
+      if (bmag > TINY_NUMBER)
+        mu = (gr->v1*B[0] + gr->v2*B[1] + gr->v3*B[2])/(vmag*bmag);
+#endif
+    }
+
+    im = (int)floor(0.5*(mu + 1.0)*nmu);
+    im = MIN(MAX(im, 0), nmu-1);
+
+    hist[(gr->property*nekin + ie)*nmu + im] += 1.0;
+  }
+
+/* Sum the histograms on the root process and append the record */
+
+  hist = particle_hist_sum(hist, nbin);
+
+  mu_edges = (Real*)calloc_1d_array(nmu+1, sizeof(Real));
+  if (mu_edges == NULL)
+    ath_error("[dump_particle_spectrum]: Error allocating memory\n");
+  for (n=0; n<=nmu; n++)
+    mu_edges[n] = -1.0 + 2.0*n/(Real)nmu;
+
+  particle_hist_append(pM, pOut, "pspec", nekin, lemin, dlekin,
+                       nmu, mu_edges, nbin, hist);
+
+  free_1d_array(mu_edges);
+  free_1d_array(hist);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void ekin_bins_init(char *block, int nekin_def, int *nekin,
+ *                          Real *lemin, Real *dlekin)
+ *  \brief Reads nekin, ekin_min and ekin_max from the <outputN> block and
+ *   returns the number, the lower edge (log10) and the width (log10) of the
+ *   logarithmic energy bins */
+void ekin_bins_init(char *block, int nekin_def, int *nekin,
+                    Real *lemin, Real *dlekin)
+{
+  Real ekin_min, ekin_max;
+
+  *nekin   = par_geti_def(block,"nekin",nekin_def);
+  ekin_min = par_getd_def(block,"ekin_min",1.0e-4);
+  ekin_max = par_getd_def(block,"ekin_max",1.0e4);
+
+  if (*nekin < 1)
+    ath_error("[ekin_bins_init]: %s/nekin must be >= 1\n",block);
+  if ((ekin_min <= 0.0) || (ekin_max <= ekin_min))
+    ath_error("[ekin_bins_init]: need 0 < %s/ekin_min < ekin_max\n",block);
+
+  *lemin  = log10(ekin_min);
+  *dlekin = (log10(ekin_max) - *lemin)/(Real)(*nekin);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn int ekin_bin(GrainS *gr, Real lemin, Real dlekin, int nekin)
+ *  \brief Returns the energy bin of a particle; particles outside of the
+ *   binned range are counted in the first/last bin */
+int ekin_bin(GrainS *gr, Real lemin, Real dlekin, int nekin)
+{
+  int ie;
+  Real vsq, ekin;
+
+  vsq = SQR(gr->v1) + SQR(gr->v2) + SQR(gr->v3);
+#ifdef SPECIAL_RELATIVITY
+  ekin = 1.0/sqrt(MAX(1.0 - vsq, TINY_NUMBER)) - 1.0;
+#else
+  ekin = 0.5*vsq;
+#endif
+
+  ie = (ekin > 0.0) ? (int)floor((log10(ekin) - lemin)/dlekin) : 0;
+
+  return MIN(MAX(ie, 0), nekin-1);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn Real *particle_hist_sum(Real *hist, int nbin)
+ *  \brief Sums the histograms of all processors on the root process with a
+ *   single MPI_Reduce.  The local array is freed and the summed array (only
+ *   meaningful on the root process) is returned */
+Real *particle_hist_sum(Real *hist, int nbin)
+{
+#ifdef MPI_PARALLEL
+  Real *sum;
+  int err;
+
+  sum = (Real*)calloc_1d_array(nbin, sizeof(Real));
+  if (sum == NULL)
+    ath_error("[particle_hist_sum]: Error allocating memory\n");
+
+  err = MPI_Reduce(hist, sum, nbin, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  if (err)
+    ath_error("[particle_hist_sum]: MPI_Reduce returned error %d\n",err);
+
+  free_1d_array(hist);
+
+  return sum;
+#else
+  return hist;
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void particle_hist_append(MeshS *pM, OutputS *pOut, char *ext,
+ *                                int nekin, Real lemin, Real dlekin,
+ *                                int nsub, Real *sub_edges, int nbin,
+ *                                Real *hist)
+ *  \brief Appends the record {time, hist[nbin]} to <basename>.<id>.<ext> on
+ *   the root process.  The first output (num=0) starts the file with the
+ *   header {int sizeof(Real), int npartypes, int nekin, int nsub,
+ *   Real ekin edges[nekin+1]}, followed by Real sub_edges[nsub+1] if
+ *   sub_edges is not NULL */
+void particle_hist_append(MeshS *pM, OutputS *pOut, char *ext,
+                          int nekin, Real lemin, Real dlekin,
+                          int nsub, Real *sub_edges, int nbin, Real *hist)
+{
+  FILE *fid;
+  char *fname;
+  int n, prec;
+  Real *edges;
+
+  if (myID_Comm_world != 0) return;
+
+#ifdef MPI_PARALLEL
+  fname = ath_fname("../",pM->outfilename,NULL,NULL,0,0,pOut->id,ext);
+#else
+  fname = ath_fname(NULL,pM->outfilename,NULL,NULL,0,0,pOut->id,ext);
+#endif
+  if (fname == NULL)
+    ath_error("[particle_hist_append]: Error constructing filename\n");
+
+  fid = fopen(fname, (pOut->num == 0) ? "wb" : "ab");
+  if (fid == NULL) {
+    ath_perr(-1,"[particle_hist_append]: Unable to open %s\n",fname);
+    free(fname);
+    return;
+  }
+
+  if (pOut->num == 0) {
+    prec = (int)sizeof(Real);
+    fwrite(&prec,      sizeof(int),1,fid);
+    fwrite(&npartypes, sizeof(int),1,fid);
+    fwrite(&nekin,     sizeof(int),1,fid);
+    fwrite(&nsub,      sizeof(int),1,fid);
+
+    edges = (Real*)calloc_1d_array(nekin+1, sizeof(Real));
+    if (edges == NULL)
+      ath_error("[particle_hist_append]: Error allocating memory\n");
+    for (n=0; n<=nekin; n++)
+      edges[n] = pow(10.0, lemin + n*dlekin);
+    fwrite(edges, sizeof(Real), nekin+1, fid);
+    free_1d_array(edges);
+
+    if (sub_edges != NULL)
+      fwrite(sub_edges, sizeof(Real), nsub+1, fid);
+  }
+
+  fwrite(&(pM->time), sizeof(Real), 1, fid);
+  fwrite(hist, sizeof(Real), nbin, fid);
+
+  fclose(fid);
+  free(fname);
+
+  return;
+}
+
+/*============================================================================*/
+/*----------------------------- Private Functions ----------------------------*/
+
+#ifdef MHD
+/*----------------------------------------------------------------------------*/
+/*! \fn static void get_bfield(GridS *pG, GrainS *gr, Real3Vect cell1,
+ *                             Real B[3])
+ *  \brief Interpolates the cell centered magnetic field to the particle
+ *   position with the particle interpolation scheme (getweight) */
+static void get_bfield(GridS *pG, GrainS *gr, Real3Vect cell1, Real B[3])
+{
+  int i,j,k, is,js,ks, i0,j0,k0, i1,j1,k1, i2,j2,k2;
+  int n0 = ncell-1;
+  Real weight[3][3][3];
+
+  getweight(pG, gr->x1, gr->x2, gr->x3, cell1, weight, &is, &js, &ks);
+
+  B[0] = 0.0;  B[1] = 0.0;  B[2] = 0.0;
+
+  k1 = MAX(ks, klp);    k2 = MIN(ks+n0, kup);
+  j1 = MAX(js, jlp);    j2 = MIN(js+n0, jup);
+  i1 = MAX(is, ilp);    i2 = MIN(is+n0, iup);
+
+  for (k=k1; k<=k2; k++) {
+    k0 = k-k1;
+    for (j=j1; j<=j2; j++) {
+      j0 = j-j1;
+      for (i=i1; i<=i2; i++) {
+        i0 = i-i1;
+        B[0] += weight[k0][j0][i0]*pG->U[k][j][i].B1c;
+        B[1] += weight[k0][j0][i0]*pG->U[k][j][i].B2c;
+        B[2] += weight[k0][j0][i0]*pG->U[k][j][i].B3c;
+      }
+    }
+  }
+
+  return;
+}
+#endif /* MHD */
+
+#endif /* PARTICLES */
@@ -0,0 +1,392 @@
+#include "../copyright.h"
+/*============================================================================*/
+/*! \file dump_particle_track.c
+ *  \brief Functions to write the trajectories of a selected subset of
+ *   particles (tracers).
+ *
+ * PURPOSE: Functions to write the trajectories of a selected subset of
+ *   particles.  Instead of dumping all particles with dump_particle_binary()
+ *   at high cadence, only the tracer particles on each processor are appended
+ *   to a per-processor trajectory file <basename>.<id>.trk, together with a
+ *   small index <basename>.<id>.tri that holds the file offset of each record.
+ *
+ *   A grid particle is a tracer if any of the following rules applies:
+ *   - its (my_id, init_id) pair is listed in track_file (one "my_id init_id"
+ *     pair per line; init_id is ignored without MPI).  The pairs are kept in
+ *     an open addressing hash table, so the lookup is O(1) per particle;
+ *   - my_id is a multiple of track_every (track_every > 0);
+ *   - its kinetic energy per unit mass (gamma-1 with special relativity,
+ *     v^2/2 otherwise) is >= track_ekin_min (track_ekin_min > 0).  This rule
+ *     is evaluated at every output, it is not sticky.
+ *
+ *   The options are read from the <outputN> block:
+ *   - track_file     = file with the my_id/init_id pairs (default none; a
+ *                      relative path is opened in the output directory of
+ *                      each process, so use an absolute path with MPI)
+ *   - track_every    = sample every N-th my_id (default 0 = off)
+ *   - track_ekin_min = energy threshold (default 0 = off)
+ *   - dstep          = write only every dstep-th time step (default 1); use
+ *                      dt=0 to check for output at every step
+ *
+ *   Several ptrk outputs may be given, each with its own selection rules
+ *   (kept per <outputN> block in a TrackS).
+ *
+ *   File layout (native endianness):
+ *   - .trk header, written when the file is empty: int sizeof(Real)
+ *   - one .trk record per output:
+ *     int nstep, Real time, long n, long my_id[n], int init_id[n],
+ *     int property[n], Real x1[n], x2[n], x3[n], v1[n], v2[n], v3[n]
+ *   - .tri header (the same); one entry per record:
+ *     int nstep, Real time, long offset (of the record in .trk), long n
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - dump_particle_track() - appends the tracer particles to the trajectory file
+ *
+ *   The files are truncated when an output block is first used with num=0
+ *   (i.e. not when continuing from a restart).
+ *
+ * PRIVATE FUNCTION PROTOTYPES:
+ * - track_get()           - returns the selection rules of an output block
+ * - track_init()          - reads the selection rules for an output block
+ * - track_open()          - opens a file for appending, writing its header
+ * - track_hash()          - hash function of a my_id/init_id pair
+ * - track_insert()        - inserts a pair into the hash table
+ * - track_lookup()        - tests whether a pair is in the hash table
+ * - track_select()        - tests whether a particle is a tracer              */
+/*============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../defs.h"
+#include "../athena.h"
+#include "../globals.h"
+#include "../prototypes.h"
+#include "prototypes.h"
+#include "particle.h"
+
+#ifdef PARTICLES /* endif at the end of the file */
+
+/*! \struct TrackKey
+ *  \brief Entry of the tracer hash table, my_id < 0 marks an empty slot */
+typedef struct TrackKey_s{
+  long my_id;
+  int init_id;
+}TrackKey;
+
+/*! \struct TrackS
+ *  \brief Selection rules and state of one track output */
+typedef struct TrackS_s{
+  int n;              /* the N of its <outputN> block */
+  int dstep;          /* write every dstep-th step */
+  long every;         /* select every N-th my_id (0 = off) */
+  Real ekin_min;      /* energy threshold (0 = off) */
+  TrackKey *tab;      /* hash table of the listed pairs */
+  long size;          /* number of slots (power of 2, 0 = no table) */
+  int last;           /* last written step, to avoid duplicates */
+}TrackS;
+
+static TrackS *tracks = NULL;   /* one per track output block */
+static int ntracks = 0;
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   track_get()    - returns the selection rules of an output block
+ *   track_init()   - reads the selection rules for an output block
+ *   track_open()   - opens a file for appending, writing its header
+ *   track_hash()   - hash function of a my_id/init_id pair
+ *   track_insert() - inserts a pair into the hash table
+ *   track_lookup() - tests whether a pair is in the hash table
+ *   track_select() - tests whether a particle is a tracer
+ *============================================================================*/
+static TrackS *track_get(MeshS *pM, OutputS *pOut);
+static void track_init(MeshS *pM, OutputS *pOut, TrackS *t);
+static FILE *track_open(MeshS *pM, OutputS *pOut, char *ext);
+static unsigned long track_hash(TrackS *t, long my_id, int init_id);
+static void track_insert(TrackS *t, long my_id, int init_id);
+static int track_lookup(TrackS *t, long my_id, int init_id);
+static int track_select(TrackS *t, GrainS *gr);
+
+/*============================================================================*/
+/*----------------------------- Public Functions -----------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void dump_particle_track(MeshS *pM, OutputS *pOut)
+ *  \brief Appends the tracer particles on this processor to the trajectory
+ *   file and its index */
+void dump_particle_track(MeshS *pM, OutputS *pOut)
+{
+  DomainS *pD = (DomainS*)&(pM->Domain[0][0]);
+  GridS   *pG = pD->Grid;
+  GrainS  *gr;
+  TrackS  *t = track_get(pM, pOut);
+  FILE *fid;
+  int *ibuf;
+  long p, n, nout, offset, *lbuf;
+  Real *buf;
+
+  if (((pM->nstep % t->dstep) != 0) || (pM->nstep == t->last)) return;
+  t->last = pM->nstep;
+
+/* Collect the tracers into column buffers */
+
+  nout = 0;
+  for (p=0; p<pG->nparticle; p++)
+    if (track_select(t, &(pG->particle[p]))) nout++;
+
+  lbuf = (long*)calloc_1d_array(MAX(nout,1), sizeof(long));
+  ibuf = (int*)calloc_1d_array(2*MAX(nout,1), sizeof(int));
+  buf  = (Real*)calloc_1d_array(6*MAX(nout,1), sizeof(Real));
+  if ((lbuf == NULL) || (ibuf == NULL) || (buf == NULL))
+    ath_error("[dump_particle_track]: Error allocating memory\n");
+
+  n = 0;
+  for (p=0; p<pG->nparticle; p++) {
+    gr = &(pG->particle[p]);
+    if (!track_select(t, gr)) continue;
+    lbuf[n] = gr->my_id;
+#ifdef MPI_PARALLEL
+    ibuf[n] = gr->init_id;
+#else
+    ibuf[n] = 0;
+#endif
+    ibuf[nout+n] = gr->property;
+    buf[       n] = gr->x1;
+    buf[  nout+n] = gr->x2;
+    buf[2*nout+n] = gr->x3;
+    buf[3*nout+n] = gr->v1;
+    buf[4*nout+n] = gr->v2;
+    buf[5*nout+n] = gr->v3;
+    n++;
+  }
+
+/* Append the record to the trajectory file */
+
+  fid = track_open(pM, pOut, "trk");
+  offset = ftell(fid);
+
+  fwrite(&(pM->nstep),sizeof(int),1,fid);
+  fwrite(&(pM->time),sizeof(Real),1,fid);
+  fwrite(&nout,sizeof(long),1,fid);
+  fwrite(lbuf,sizeof(long),nout,fid);
+  fwrite(ibuf,sizeof(int),2*nout,fid);
+  fwrite(buf,sizeof(Real),6*nout,fid);
+  fclose(fid);
+
+/* Append the record position to the index */
+
+  fid = track_open(pM, pOut, "tri");
+  fwrite(&(pM->nstep),sizeof(int),1,fid);
+  fwrite(&(pM->time),sizeof(Real),1,fid);
+  fwrite(&offset,sizeof(long),1,fid);
+  fwrite(&nout,sizeof(long),1,fid);
+  fclose(fid);
+
+  free_1d_array(lbuf);
+  free_1d_array(ibuf);
+  free_1d_array(buf);
+
+  return;
+}
+
+/*============================================================================*/
+/*----------------------------- Private Functions ----------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static TrackS *track_get(MeshS *pM, OutputS *pOut)
+ *  \brief Returns the selection rules of the output block of pOut, read by
+ *   track_init() when the block is first used */
+static TrackS *track_get(MeshS *pM, OutputS *pOut)
+{
+  int i;
+
+  for (i=0; i<ntracks; i++)
+    if (tracks[i].n == pOut->n) return &(tracks[i]);
+
+  tracks = (TrackS*)realloc(tracks, (ntracks+1)*sizeof(TrackS));
+  if (tracks == NULL)
+    ath_error("[dump_particle_track]: Error allocating memory\n");
+  track_init(pM, pOut, &(tracks[ntracks]));
+
+  return &(tracks[ntracks++]);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void track_init(MeshS *pM, OutputS *pOut, TrackS *t)
+ *  \brief Reads the selection rules from the <outputN> block, builds the
+ *   hash table of the listed my_id/init_id pairs, and truncates the files
+ *   of a new output (num=0) */
+static void track_init(MeshS *pM, OutputS *pOut, TrackS *t)
+{
+  FILE *fid;
+  char block[80], *fname, *ext[2] = {"trk", "tri"};
+  long my_id, nid;
+  int init_id, i;
+
+  sprintf(block,"output%d",pOut->n);
+  t->n        = pOut->n;
+  t->dstep    = MAX(par_geti_def(block,"dstep",1), 1);
+  t->every    = par_geti_def(block,"track_every",0);
+  t->ekin_min = par_getd_def(block,"track_ekin_min",0.0);
+  t->tab      = NULL;
+  t->size     = 0;
+  t->last     = -1;
+
+  if (pOut->num == 0) {
+    for (i=0; i<2; i++) {
+      if((fname = ath_fname(NULL,pM->outfilename,NULL,NULL,0,0,
+          pOut->id,ext[i])) == NULL)
+        ath_error("[dump_particle_track]: Error constructing filename\n");
+      if((fid = fopen(fname,"wb")) == NULL)
+        ath_error("[dump_particle_track]: Unable to open %s\n",fname);
+      fclose(fid);
+      free(fname);
+    }
+  }
+
+  fname = par_gets_def(block,"track_file","");
+  if (fname[0] != '\0') {
+    if ((fid = fopen(fname,"r")) == NULL)
+      ath_error("[dump_particle_track]: Unable to open %s\n",fname);
+
+    /* count the pairs and size the table for a load factor <= 1/2 */
+    nid = 0;
+    while (fscanf(fid,"%ld %d",&my_id,&init_id) == 2) nid++;
+    t->size = 1;
+    while (t->size < 2*nid) t->size <<= 1;
+
+    t->tab = (TrackKey*)calloc_1d_array(t->size, sizeof(TrackKey));
+    if (t->tab == NULL)
+      ath_error("[dump_particle_track]: Error allocating memory\n");
+    for (my_id=0; my_id<t->size; my_id++)
+      t->tab[my_id].my_id = -1;
+
+    rewind(fid);
+    while (fscanf(fid,"%ld %d",&my_id,&init_id) == 2)
+      track_insert(t, my_id, init_id);
+    fclose(fid);
+
+    ath_pout(0,"[dump_particle_track]: tracking %ld listed particles\n",nid);
+  }
+  free(fname);
+
+  if ((t->size == 0) && (t->every <= 0) && (t->ekin_min <= 0.0))
+    ath_perr(-1,"[dump_particle_track]: %s selects no particles\n",block);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static FILE *track_open(MeshS *pM, OutputS *pOut, char *ext)
+ *  \brief Opens the .trk or .tri file of pOut for appending, and writes the
+ *   header (int sizeof(Real)) if the file is empty */
+static FILE *track_open(MeshS *pM, OutputS *pOut, char *ext)
+{
+  FILE *fid;
+  char *fname;
+  int prec = (int)sizeof(Real);
+
+  if((fname = ath_fname(NULL,pM->outfilename,NULL,NULL,0,0,
+      pOut->id,ext)) == NULL)
+    ath_error("[dump_particle_track]: Error constructing filename\n");
+  if((fid = fopen(fname,"ab")) == NULL)
+    ath_error("[dump_particle_track]: Unable to open %s\n",fname);
+  free(fname);
+
+  fseek(fid,0,SEEK_END);
+  if (ftell(fid) == 0) fwrite(&prec,sizeof(int),1,fid);
+
+  return fid;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static unsigned long track_hash(TrackS *t, long my_id, int init_id)
+ *  \brief Hash function (64-bit multiplicative mixing) of a my_id/init_id
+ *   pair, reduced to the table size */
+static unsigned long track_hash(TrackS *t, long my_id, int init_id)
+{
+  unsigned long long h;
+
+#ifndef MPI_PARALLEL
+  init_id = 0;
+#endif
+  h = (unsigned long long)my_id*0x9E3779B97F4A7C15ULL
+    ^ (unsigned long long)init_id*0xC2B2AE3D27D4EB4FULL;
+  h ^= h >> 31;
+
+  return (unsigned long)(h & (unsigned long long)(t->size-1));
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void track_insert(TrackS *t, long my_id, int init_id)
+ *  \brief Inserts a pair into the hash table (linear probing) */
+static void track_insert(TrackS *t, long my_id, int init_id)
+{
+  unsigned long h = track_hash(t, my_id, init_id);
+
+#ifndef MPI_PARALLEL
+  init_id = 0;
+#endif
+  while (t->tab[h].my_id >= 0) {
+    if ((t->tab[h].my_id == my_id) && (t->tab[h].init_id == init_id))
+      return;
+    h = (h+1) & (t->size-1);
+  }
+  t->tab[h].my_id = my_id;
+  t->tab[h].init_id = init_id;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int track_lookup(TrackS *t, long my_id, int init_id)
+ *  \brief Returns 1 if the pair is in the hash table, 0 otherwise */
+static int track_lookup(TrackS *t, long my_id, int init_id)
+{
+  unsigned long h = track_hash(t, my_id, init_id);
+
+#ifndef MPI_PARALLEL
+  init_id = 0;
+#endif
+  while (t->tab[h].my_id >= 0) {
+    if ((t->tab[h].my_id == my_id) && (t->tab[h].init_id == init_id))
+      return 1;
+    h = (h+1) & (t->size-1);
+  }
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int track_select(TrackS *t, GrainS *gr)
+ *  \brief Returns 1 if the grid particle gr is a tracer of t, 0 otherwise */
+static int track_select(TrackS *t, GrainS *gr)
+{
+  Real vsq, ekin;
+  int init_id = 0;
+
+  if (gr->pos != 1) return 0; /* skip ghost particles */
+
+  if ((t->every > 0) && ((gr->my_id % t->every) == 0)) return 1;
+
+  if (t->size > 0) {
+#ifdef MPI_PARALLEL
+    init_id = gr->init_id;
+#endif
+    if (track_lookup(t, gr->my_id, init_id)) return 1;
+  }
+
+  if (t->ekin_min > 0.0) {
+    vsq = SQR(gr->v1) + SQR(gr->v2) + SQR(gr->v3);
+#ifdef SPECIAL_RELATIVITY
+    ekin = 1.0/sqrt(MAX(1.0 - vsq, TINY_NUMBER)) - 1.0;
+#else
+    ekin = 0.5*vsq;
+#endif
+    if (ekin >= t->ekin_min) return 1;
+  }
+
+  return 0;
+}
+
+#endif /* PARTICLES */
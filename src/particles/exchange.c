@@ -7,14 +7,19 @@
  * PURPOSE: Particles near grid boundaries deposit their physical properties
  *   partially to the ghost zones. This part of the deposit is to be mapped
  *   to the grid zone. The procedure is opposite to setting boundary conditions.
+ *   exchange_gpcouple() exchanges the feedback in the gas-particle coupling
+ *   array (with FEEDBACK only), and exchange_moments() the binned particle
+ *   moments (see moments_particle.c).
  *
  * CONTAINS PUBLIC FUNCTIONS:
  * - exchange_gpcouple()
+ * - exchange_moments()
  * - exchange_gpcouple_init()
  * - exchange_gpcouple_fun()
  * - exchange_gpcouple_destruct()
  *
  * PRIVATE FUNCTIONS:
+ * - exchange_core()
  * - reflecting_???
  * - outflow_???
  * - periodic_???
@@ -106,6 +111,8 @@ static void reflect_ox3_exchange(GridS *pG);
 
 static void outflow_exchange(GridS *pG);
 
+static void exchange_core(DomainS *pD, short lab);
+
 static void periodic_ix1_exchange(GridS *pG);
 static void periodic_ox1_exchange(GridS *pG);
 static void periodic_ix2_exchange(GridS *pG);
@@ -158,24 +165,15 @@ static void unpack_ox2_remap(GridS *pG, GPExc ***myZns);
  *  fill the corner cells properly (opposite to setting MHD B.C.!)
  */
 
+#ifdef FEEDBACK
 void exchange_gpcouple(DomainS *pD, short lab)
 {
   GridS *pG = pD->Grid;
   int i,j,k;
-#ifdef SHEARING_BOX
-  int n,myL,myM,myN,BCFlag;
-#ifndef FARGO
-  Real Lx = pD->RootMaxX[0]-pD->RootMinX[0];
-#endif
-#endif
-#ifdef MPI_PARALLEL
-  int cnt1, cnt2, cnt3, cnt, ierr, mIndex;
-#endif /* MPI_PARALLEL */
 	
 /*--- Step 1. ------------------------------------------------------------------	
  * Copy the information in the Gas-Particle coupling array into temporary array
  * This step depends on the parameter "lab", where for
- * lab = 0: particle binning for output purpose
  * lab = 1: predictor step of feedback exchange
  * lab = 2: corrector step of feedback exchange
  * All the operations in this routine are performed on the temporary array,
@@ -187,21 +185,6 @@ void exchange_gpcouple(DomainS *pD, short lab)
 #endif
 
   switch (lab) {
-    case 0: /* particle binning for output purpose */
-		  
-      NVar = 4; NExc = 1; NOfst = 0;
-
-      for (k=klp; k<=kup; k++) {
-       for (j=jlp; j<=jup; j++) {
-        for (i=ilp; i<=iup; i++) {
-	  myCoup[k][j][i].U[0]=pG->Coup[k][j][i].grid_v1;
-          myCoup[k][j][i].U[1]=pG->Coup[k][j][i].grid_v2;
-          myCoup[k][j][i].U[2]=pG->Coup[k][j][i].grid_v3;
-          myCoup[k][j][i].U[3]=pG->Coup[k][j][i].grid_d;
-      }}}
-      break;
-		  
-#ifdef FEEDBACK		  
     case 1: /* predictor step of feedback exchange */
 		  
       NVar = 5; NExc = 1; NOfst = nghost;
@@ -236,12 +219,125 @@ void exchange_gpcouple(DomainS *pD, short lab)
       break;
 
     default:
-      ath_perr(-1,"[exchange_GPCouple]: lab must be equal to 0, 1, or 2!\n");
-#else
+      ath_perr(-1,"[exchange_GPCouple]: lab must be equal to 1 or 2!\n");
+  }
+
+/*--- Steps 2-4: exchange of the temporary array */
+
+  exchange_core(pD, lab);
+
+/*--- Step 5. ------------------------------------------------------------------	
+ * Copy the variables from the temporary array where exchange has finished back
+ * to the Gas-Particle coupling array. Again, for
+ * lab = 1: predictor step of feedback exchange
+ * lab = 2: corrector step of feedback exchange
+ *----------------------------------------------------------------------------*/
+	
+  switch (lab) {
+    case 1: /* predictor step of feedback exchange */
+      for (k=kb; k<=kt; k++) {
+       for (j=jb; j<=jt; j++) {
+        for (i=ib; i<=it; i++) {
+          pG->Coup[k][j][i].fb1    = myCoup[k][j][i].U[0];
+          pG->Coup[k][j][i].fb2    = myCoup[k][j][i].U[1];
+          pG->Coup[k][j][i].fb3    = myCoup[k][j][i].U[2];
+          pG->Coup[k][j][i].FBstiff= myCoup[k][j][i].U[3];
+          pG->Coup[k][j][i].Eloss  = myCoup[k][j][i].U[4];
+      }}}
+      break;
+			
+    case 2: /* corrector step of feedback exchange */
+      for (k=kb; k<=kt; k++) {
+       for (j=jb; j<=jt; j++) {
+        for (i=ib; i<=it; i++) {
+          pG->Coup[k][j][i].fb1  = myCoup[k][j][i].U[0];
+          pG->Coup[k][j][i].fb2  = myCoup[k][j][i].U[1];
+          pG->Coup[k][j][i].fb3  = myCoup[k][j][i].U[2];
+          pG->Coup[k][j][i].Eloss= myCoup[k][j][i].U[3];		  
+      }}}
+      break;
+			
     default:
-      ath_perr(-1,"[exchange_GPCouple]: lab must be equal to 0!\n");
-#endif /* FEEDBACK */
+      ath_perr(-1,"[exchange_GPCouple]: lab must be equal to 1 or 2!\n");
   }
+	
+  return;
+
+}
+#endif /* FEEDBACK */
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void exchange_moments(DomainS *pD, Real ****Mom, int n0, int nvar,
+ *                             int ivel)
+ *  \brief Adds the particle moments deposited in the ghost zones to the
+ *   boundary zones, for the nvar (<= NVar_Max) arrays Mom[n0..n0+nvar-1].
+ *
+ *   If ivel >= 0, Mom[n0+ivel..n0+ivel+2] is the momentum density, to which
+ *   the shear velocity is added across the shearing-box boundaries as for
+ *   particle binning in exchange_gpcouple().  Use ivel < 0 for quantities
+ *   without shear correction.
+ */
+void exchange_moments(DomainS *pD, Real ****Mom, int n0, int nvar, int ivel)
+{
+  int i,j,k,n,m;
+  int map[NVar_Max];	/* map[n]: index in Mom of variable n of myCoup */
+
+  if ((nvar < 1) || (nvar > NVar_Max) || ((ivel >= 0) && (ivel+3 > nvar)))
+    ath_error("[exchange_moments]: Cannot exchange %d variables\n",nvar);
+
+#ifdef SHEARING_BOX
+  Delta = 0.0;
+#endif
+
+/* The momentum density, if any, is variable 0-2 of myCoup, as for lab = 0 in
+ * exchange_gpcouple() */
+  m = 0;
+  if (ivel >= 0)
+    for (n=0; n<3; n++) map[m++] = n0+ivel+n;
+  for (n=0; n<nvar; n++)
+    if ((ivel < 0) || (n < ivel) || (n >= ivel+3)) map[m++] = n0+n;
+
+  NVar = nvar; NExc = 1; NOfst = 0;
+
+  for (k=klp; k<=kup; k++) {
+   for (j=jlp; j<=jup; j++) {
+    for (i=ilp; i<=iup; i++) {
+     for (n=0; n<NVar; n++) {
+       myCoup[k][j][i].U[n] = Mom[map[n]][k][j][i];
+  }}}}
+
+  exchange_core(pD, (ivel >= 0) ? 0 : 3);
+
+  for (k=kb; k<=kt; k++) {
+   for (j=jb; j<=jt; j++) {
+    for (i=ib; i<=it; i++) {
+     for (n=0; n<NVar; n++) {
+       Mom[map[n]][k][j][i] = myCoup[k][j][i].U[n];
+  }}}}
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void exchange_core(DomainS *pD, short lab)
+ *  \brief Exchanges the NVar variables of the temporary array myCoup between
+ *   ghost and boundary zones, in the order x3-x2-x1.  lab is as in
+ *   exchange_gpcouple(); with lab = 0 (particle moments) the shear velocity is
+ *   added to variable 1 (2 for x-z shearing box) across the shearing-box
+ *   boundaries.
+ */
+static void exchange_core(DomainS *pD, short lab)
+{
+  GridS *pG = pD->Grid;
+#ifdef SHEARING_BOX
+  int i,j,k,n,myL,myM,myN,BCFlag;
+#ifndef FARGO
+  Real Lx = pD->RootMaxX[0]-pD->RootMinX[0];
+#endif
+#endif
+#ifdef MPI_PARALLEL
+  int cnt1, cnt2, cnt3, cnt, ierr, mIndex;
+#endif /* MPI_PARALLEL */
 
 /* set left and right grid indices */
   if (pG->Nx[0] > 1) {
@@ -629,58 +725,6 @@ void exchange_gpcouple(DomainS *pD, short lab)
     } 
   }
 
-/*--- Step 5. ------------------------------------------------------------------	
- * Copy the variables from the temporary array where exchange has finished back
- * to the Gas-Particle coupling array. Again, for
- * lab = 0: particle binning for output purpose
- * lab = 1: predictor step of feedback exchange
- * lab = 2: corrector step of feedback exchange
- *----------------------------------------------------------------------------*/
-	
-  switch (lab) {
-    case 0:	/* particle binning for output purpose */
-      for (k=kb; k<=kt; k++) {
-       for (j=jb; j<=jt; j++) {
-        for (i=ib; i<=it; i++) {
-          pG->Coup[k][j][i].grid_v1= myCoup[k][j][i].U[0];
-          pG->Coup[k][j][i].grid_v2= myCoup[k][j][i].U[1];
-          pG->Coup[k][j][i].grid_v3= myCoup[k][j][i].U[2];
-          pG->Coup[k][j][i].grid_d = myCoup[k][j][i].U[3];
-      }}}
-      break;
-			
-#ifdef FEEDBACK		  
-    case 1: /* predictor step of feedback exchange */
-      for (k=kb; k<=kt; k++) {
-       for (j=jb; j<=jt; j++) {
-        for (i=ib; i<=it; i++) {
-          pG->Coup[k][j][i].fb1    = myCoup[k][j][i].U[0];
-          pG->Coup[k][j][i].fb2    = myCoup[k][j][i].U[1];
-          pG->Coup[k][j][i].fb3    = myCoup[k][j][i].U[2];
-          pG->Coup[k][j][i].FBstiff= myCoup[k][j][i].U[3];
-          pG->Coup[k][j][i].Eloss  = myCoup[k][j][i].U[4];
-      }}}
-      break;
-			
-    case 2: /* corrector step of feedback exchange */
-      for (k=kb; k<=kt; k++) {
-       for (j=jb; j<=jt; j++) {
-        for (i=ib; i<=it; i++) {
-          pG->Coup[k][j][i].fb1  = myCoup[k][j][i].U[0];
-          pG->Coup[k][j][i].fb2  = myCoup[k][j][i].U[1];
-          pG->Coup[k][j][i].fb3  = myCoup[k][j][i].U[2];
-          pG->Coup[k][j][i].Eloss= myCoup[k][j][i].U[3];		  
-      }}}
-      break;
-			
-    default:
-      ath_perr(-1,"[exchange_GPCouple]: lab must be equal to 0, 1, or 2!\n");
-#else
-    default:
-      ath_perr(-1,"[exchange_GPCouple]: lab must be equal to 0!\n");
-#endif /* FEEDBACK */
-  }
-	
   return;
 
 }
@@ -15,6 +15,7 @@
  * - init_particle();
  * - particle_destruct();
  * - particle_realloc();
+ * - particle_set_origin();
  *                                                                            */
 /*============================================================================*/
 #include <stdio.h>
@@ -121,6 +122,9 @@ void init_particle(MeshS *pM)
   for (i=0; i<npartypes; i++)
     grproperty[i].integrator =par_geti_def("particle","integrator",2);
 
+  /* cadence of the particle load summary in the log */
+  nstatus = par_geti_def("particle","nstatus",1);
+
   /* set the interpolation function pointer */
   interp = par_geti_def("particle","interp",2);
   if (interp == 1)
@@ -156,6 +160,10 @@ void init_particle(MeshS *pM)
   pG->Coup = (GPCouple***)calloc_3d_array(N3T,N2T,N1T, sizeof(GPCouple));
   if (pG->Coup == NULL) goto on_error;
 
+  /* the moments array is allocated when the particles are first binned */
+  pG->Mom = NULL;
+  pG->nMom = 0;
+
 #ifdef SHEARING_BOX
   if (pG->Nx[2] > 1) /* 3D */
     ShBoxCoord = xy;
@@ -185,6 +193,10 @@ void particle_destruct(MeshS *pM)
   /* free memory for gas and feedback arrays */
   if (pG->Coup != NULL) free_3d_array(pG->Coup);
 
+  particle_moments_destruct(pG);
+  cr_destruct();
+  deposit_destruct();
+
   return;
 }
 
@@ -215,6 +227,31 @@ void particle_realloc(GridS *pG, long n)
   return;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn void particle_set_origin(MeshS *pM)
+ *  \brief Set the initial coordinate of all particles to their current one
+ *
+ * Called after the problem generator for a new run.  The initial coordinate is
+ * afterwards only shifted together with periodic boundary wraps, so x-x_0 is
+ * the unwrapped displacement (see dump_particle_diffusion.c).
+ */
+void particle_set_origin(MeshS *pM)
+{
+  DomainS *pD = (DomainS*)&(pM->Domain[0][0]);
+  GridS *pG = pD->Grid;
+  GrainS *gr;
+  long p;
+
+  for (p=0; p<pG->nparticle; p++) {
+    gr = &(pG->particle[p]);
+    gr->x1_0 = gr->x1;
+    gr->x2_0 = gr->x2;
+    gr->x3_0 = gr->x3;
+  }
+
+  return;
+}
+
 /*============================================================================*/
 /*----------------------------- Private Functions ----------------------------*/
 
@@ -0,0 +1,176 @@
+#include "../copyright.h"
+/*============================================================================*/
+/*! \file inject_particle.c
+ *  \brief Continuous injection of particles during the run.
+ *
+ * PURPOSE: Continuous injection of particles during the run, e.g. at shocks
+ *   or at boundaries.  The problem generator enrolls an injection function
+ *   with particle_inject_enroll() (in problem() and, for restarts, in
+ *   problem_read_restart()).  inject_particles() calls it once every time
+ *   step, after the time is updated and before the particle boundary
+ *   conditions, so that a particle injected outside the grid is handed over
+ *   to its neighbor as any other particle.
+ *
+ *   The injection function fills a batch of free slots at the end of the
+ *   particle array, and returns the number of particles it filled:
+ *
+ *     long fun(GridS *pG, GrainS *gr, long nslot)
+ *
+ *   sets x1,x2,x3, v1,v2,v3 and property of gr[0..n-1], n <= nslot, and
+ *   returns n.  The other fields are set here; my_id is set before the call,
+ *   so that the function may key its random numbers on it.  The free slots are taken from
+ *   a pool: the particle array is enlarged by at least
+ *   <particle>/inject_pool slots at a time (default 1024), so that it is
+ *   reallocated once per pool rather than for each injected particle.  If the
+ *   function fills all nslot slots, the pool is enlarged and the function is
+ *   called again in the same step, until it returns n < nslot.
+ *
+ *   Each rank reserves its own range of particle ids, so the ids are unique
+ *   without any communication: the n-th particle injected by rank r gets
+ *   my_id = (r+1)*2^INJECT_ID_BITS + n, above the ids given by the problem
+ *   generator (which must be smaller than 2^INJECT_ID_BITS).  The ids stay
+ *   below 2^53, as they are sent as doubles by bvals_particle.  After a
+ *   restart, the counter n starts after the largest injected id found on any
+ *   rank (the only communication, done once).
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - particle_inject_enroll() - enrolls the injection function
+ * - inject_particles()       - injects the particles of one time step
+ *
+ * PRIVATE FUNCTION PROTOTYPES:
+ * - inject_init() - reads the pool size and sets the id counter             */
+/*============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../defs.h"
+#include "../athena.h"
+#include "../prototypes.h"
+#include "prototypes.h"
+#include "particle.h"
+#include "../globals.h"
+
+#ifdef PARTICLES         /* endif at the end of the file */
+
+#define INJECT_ID_BITS 32  /* size of the id range of each rank: 2^32 */
+
+static InjectFun_t InjectFun = NULL;  /* enrolled injection function */
+static long npool = 0;                /* minimum number of free slots */
+static long idnext = 0;               /* counter of the injected particles */
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   inject_init() - reads the pool size and sets the id counter
+ *============================================================================*/
+static void inject_init(GridS *pG);
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void particle_inject_enroll(InjectFun_t fun)
+ *  \brief Enrolls the particle injection function */
+void particle_inject_enroll(InjectFun_t fun)
+{
+  InjectFun = fun;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void inject_particles(DomainS *pD)
+ *  \brief Calls the enrolled injection function to add the particles of this
+ *   time step to the grid.  Does nothing if no function is enrolled on this
+ *   rank, except for the setup on the first call.
+ */
+void inject_particles(DomainS *pD)
+{
+  GridS *pG = pD->Grid;
+  GrainS *gr;
+  long p, n, nslot;
+
+  /* on all ranks, since the injection function may be enrolled on some only */
+  if (npool == 0) inject_init(pG);
+
+  if (InjectFun == NULL) return;
+
+  do {
+    /* make sure at least npool slots are free */
+    if (pG->arrsize - pG->nparticle < npool)
+      particle_realloc(pG, pG->nparticle + npool);
+    nslot = pG->arrsize - pG->nparticle;
+
+    /* the ids the particles get if filled */
+    for (p=0; p<nslot; p++)
+      pG->particle[pG->nparticle+p].my_id =
+        ((long)(myID_Comm_world+1) << INJECT_ID_BITS) + idnext + p;
+
+    n = (*InjectFun)(pG, &(pG->particle[pG->nparticle]), nslot);
+    if ((n < 0) || (n > nslot))
+      ath_error("[inject_particles]: %ld particles injected in %ld slots\n",
+                n, nslot);
+
+    for (p=pG->nparticle; p<pG->nparticle+n; p++) {
+      gr = &(pG->particle[p]);
+      if ((gr->property < 0) || (gr->property >= npartypes))
+        ath_error("[inject_particles]: Invalid particle property %d\n",
+                  gr->property);
+      grproperty[gr->property].num += 1;
+      gr->x1_0 = gr->x1;
+      gr->x2_0 = gr->x2;
+      gr->x3_0 = gr->x3;
+      gr->pos = 1; /* grid particle */
+#ifdef MPI_PARALLEL
+      gr->init_id = myID_Comm_world;
+#endif
+      idnext++;
+    }
+    pG->nparticle += n;
+
+  } while (n == nslot);
+
+  if (idnext >= (1L << INJECT_ID_BITS))
+    ath_error("[inject_particles]: The id range of rank %d is exhausted\n",
+              myID_Comm_world);
+
+  return;
+}
+
+/*============================================================================*/
+/*----------------------------- Private Functions ----------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void inject_init(GridS *pG)
+ *  \brief Reads the pool size, and starts the id counter after the largest
+ *   id injected so far by any rank (for restarts).
+ */
+static void inject_init(GridS *pG)
+{
+  long p, nmax = -1;
+#ifdef MPI_PARALLEL
+  long nmax_local;
+  int ierr;
+#endif
+
+  npool = par_geti_def("particle","inject_pool",1024);
+  if (npool < 1)
+    ath_error("[inject_init]: inject_pool must be positive, not %ld\n",npool);
+
+  for (p=0; p<pG->nparticle; p++) {
+    if (pG->particle[p].my_id >= (1L << INJECT_ID_BITS))
+      nmax = MAX(nmax, pG->particle[p].my_id & ((1L << INJECT_ID_BITS) - 1));
+  }
+
+#ifdef MPI_PARALLEL
+  nmax_local = nmax;
+  ierr = MPI_Allreduce(&nmax_local, &nmax, 1, MPI_LONG, MPI_MAX,
+                       MPI_COMM_WORLD);
+  if (ierr) ath_error("[inject_init]: MPI_Allreduce error = %d\n",ierr);
+#endif
+
+  idnext = nmax + 1;
+
+  return;
+}
+
+#undef INJECT_ID_BITS
+
+#endif /* PARTICLES */
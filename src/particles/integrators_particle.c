@@ -19,6 +19,7 @@
  * - JudgeCrossing()  - judge if the particle cross the grid boundary
  * - Get_Drag()       - calculate the drag force
  * - Get_Force()      - calculate forces other than the drag
+ * - Particle_Status()- aggregated particle count / load imbalance report
  *
  * REFERENCE:
  *   X.-N. Bai & J.M. Stone, 2010, ApJS, 190, 297 									      */
@@ -44,6 +45,7 @@
  *   Get_Drag()       - calculate the drag force
  *   Get_Force()      - calculate forces other than the drag
  *   Get_ForceDiff()  - calculate the force difference between particle and gas
+ *   Particle_Status()- aggregated particle count / load imbalance report
  *============================================================================*/
 void   Delete_Ghost(GridS *pG);
 void   JudgeCrossing(GridS *pG, Real x1, Real x2, Real x3, GrainS *gr);
@@ -51,6 +53,7 @@ Real3Vect Get_Drag(GridS *pG, int type, Real x1, Real x2, Real x3,
                 Real v1, Real v2, Real v3, Real3Vect cell1, Real *tstop1);
 Real3Vect Get_Force(GridS *pG, Real x1, Real x2, Real x3,
                                Real v1, Real v2, Real v3);
+void   Particle_Status(GridS *pG);
 
 /*=========================== PUBLIC FUNCTIONS ===============================*/
 /*----------------------------------------------------------------------------*/
@@ -180,8 +183,7 @@ void Integrate_Particles(DomainS *pD)
   } /* end of the for loop */
 
   /* output the status */
-  ath_pout(0, "In processor %d, there are %ld particles.\n",
-                           myID_Comm_world, pG->nparticle);
+  Particle_Status(pG);
 
   return;
 }
@@ -1094,4 +1096,58 @@ Real3Vect Get_Force(GridS *pG, Real x1, Real x2, Real x3,
   return ft;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn void Particle_Status(GridS *pG)
+ *  \brief Report the particle load on all processors
+ *
+ * Every nstatus calls (<particle>/nstatus, 0 disables it) the particle counts
+ * are reduced to the root process, which writes the total, min/max/mean count
+ * per processor and the imbalance factor max/mean.  The old per-processor line
+ * is kept for debugging at log level 1 (out_level/child_out_level >= 1).
+ */
+void Particle_Status(GridS *pG)
+{
+  static long ncall = 0;        /* number of calls since start (or restart) */
+  long nmin, nmax, ntot;        /* min, max and total particle number */
+  double nmean;                 /* mean number of particles per processor */
+  int nproc = 1;                /* number of processors */
+#ifdef MPI_PARALLEL
+  long my_nrange[2], nrange[2]; /* (max,-min) of the particle number */
+  int err;
+#endif
+
+  ath_pout(1, "In processor %d, there are %ld particles.\n",
+                           myID_Comm_world, pG->nparticle);
+
+  ncall++;
+  if ((nstatus <= 0) || (ncall % nstatus != 0)) return;
+
+  nmin = pG->nparticle;
+  nmax = pG->nparticle;
+  ntot = pG->nparticle;
+
+#ifdef MPI_PARALLEL
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  my_nrange[0] =  pG->nparticle;
+  my_nrange[1] = -pG->nparticle;
+
+  err = MPI_Reduce(my_nrange, nrange, 2, MPI_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+  if (err) ath_error("[Particle_Status]: MPI_Reduce returned error %d\n",err);
+  err = MPI_Reduce(&(pG->nparticle), &ntot, 1, MPI_LONG, MPI_SUM, 0,
+                                                             MPI_COMM_WORLD);
+  if (err) ath_error("[Particle_Status]: MPI_Reduce returned error %d\n",err);
+
+  nmax =  nrange[0];
+  nmin = -nrange[1];
+#endif
+
+  nmean = (double)ntot/(double)nproc;
+
+  ath_pout(0, "Particles: total=%ld min=%ld max=%ld mean=%.1f imbalance=%.3f\n",
+           ntot, nmin, nmax, nmean, (nmean > 0.0) ? (double)nmax/nmean : 1.0);
+
+  return;
+}
+
 #endif /*PARTICLES*/
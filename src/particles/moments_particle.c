@@ -0,0 +1,574 @@
+#include "../copyright.h"
+/*============================================================================*/
+/*! \file moments_particle.c
+ *  \brief Single-pass binning of the particle moments onto the grid.
+ *
+ * PURPOSE: Single-pass binning of the particle moments onto the grid.  All
+ *   the particle selection functions (PropFun_t) whose moments are needed at
+ *   the current time are binned together in one deposition pass (see
+ *   deposit_particle.c), rather than once per output.  The moments are stored
+ *   in the moments array pG->Mom, which is separate from the gas-particle
+ *   coupling array Coup, and has its own ghost zone exchange
+ *   (exchange_moments() in exchange.c).
+ *
+ *   Each selection has a slot of nblk blocks of nmomq arrays.  Block 0 holds
+ *   the moments of all the selected particles; with <particle>/moments_species
+ *   = 1, block t+1 holds those of the selected particles of type t.  The
+ *   quantities of a block (enum MomQuantity in athena.h) are
+ *   - the density mom_d and momentum density mom_M1..3 (always),
+ *   - the current density mom_J1..3 if <particle>/moments_current = 1,
+ *   - the momentum flux (pressure) tensor mom_P11..33 if
+ *     <particle>/moments_pressure = 1,
+ *   - the kinetic energy density mom_E if <particle>/moments_energy = 1,
+ *   in this order.  The particle mass is grproperty[].m with FEEDBACK, and 1
+ *   otherwise; the charge is grproperty[].alpha times the mass.  With
+ *   SPECIAL_RELATIVITY, the pressure tensor and energy density are those of
+ *   relativistic particles (gamma*m*v_i*v_j and (gamma-1)*m).
+ *   particle_moment_index() gives the index in pG->Mom of a quantity.
+ *
+ *   The slots are kept until the time changes: a later call at the same time
+ *   only bins the selections that are not binned yet (in one pass), so the
+ *   particle history and list dumps reuse the binning of the grid outputs.
+ *   particle_moments_select() chooses the slot read by the expression
+ *   functions expr_*par used by the outputs.
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - particle_moments()          - bins the particles for a list of selections
+ * - particle_moments_select()   - chooses the slot read by expr_*par
+ * - particle_moment_index()     - index of a binned quantity in pG->Mom
+ * - particle_dpar()             - sets the local particle density
+ * - particle_moments_destruct() - frees the moments array
+ * - expr_*par()                 - expression functions of the binned moments
+ *
+ * PRIVATE FUNCTION PROTOTYPES:
+ * - moments_init()  - reads the binned quantities
+ * - moments_alloc() - enlarges the moments array
+ * - property_new()  - selects the particles of the selections being binned
+ * - deposit_mom()   - deposits the moments of one particle
+ * - moments_check() - compares the binned density with a reference (DEBUG)  */
+/*============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../defs.h"
+#include "../athena.h"
+#include "../prototypes.h"
+#include "prototypes.h"
+#include "particle.h"
+#include "../globals.h"
+
+#ifdef PARTICLES         /* endif at the end of the file */
+
+static int momq[NMOMQ];           /* index of each quantity in a block, or -1 */
+static int qlist[NMOMQ];          /* binned quantities, in the block order */
+static int nmomq = 0;             /* number of quantities in a block */
+static int nblk = 0;              /* number of blocks of a slot */
+static int nslot = 0;             /* number of arrays of a slot */
+
+static int nsel = 0;              /* number of binned selections */
+static PropFun_t *momsel = NULL;  /* binned selections */
+static Real momtime;              /* time of the binning */
+static int imom = 0;              /* first moment of the selected slot */
+
+/* the selections being binned by the current deposition pass */
+static int nnew = 0;
+static PropFun_t *newsel = NULL;
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   moments_init()  - reads the binned quantities
+ *   moments_alloc() - enlarges the moments array
+ *   property_new()  - selects the particles of the selections being binned
+ *   deposit_mom()   - deposits the moments of one particle
+ *   moments_check() - compares the binned density with a reference (DEBUG)
+ *============================================================================*/
+static void moments_init(void);
+static void moments_alloc(GridS *pG, int n);
+static int  property_new(const GrainS *gr, const GrainAux *grsub);
+static void deposit_mom(GridS *pG, const GrainS *gr, Real weight[3][3][3],
+                        int is, int js, int ks);
+#ifdef DEBUG
+static void moments_check(GridS *pG);
+#endif
+
+Real expr_dpar (const GridS *pG, const int i, const int j, const int k);
+Real expr_M1par(const GridS *pG, const int i, const int j, const int k);
+Real expr_M2par(const GridS *pG, const int i, const int j, const int k);
+Real expr_M3par(const GridS *pG, const int i, const int j, const int k);
+Real expr_V1par(const GridS *pG, const int i, const int j, const int k);
+Real expr_V2par(const GridS *pG, const int i, const int j, const int k);
+Real expr_V3par(const GridS *pG, const int i, const int j, const int k);
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void particle_moments(DomainS *pD, int n, PropFun_t *sel)
+ *  \brief Bins the particles selected by each of sel[0..n-1] to the grid, in
+ *   one pass over the particles.  Selections already binned at this time are
+ *   not binned again.  The first selection is then the selected slot.
+ */
+void particle_moments(DomainS *pD, int n, PropFun_t *sel)
+{
+  GridS *pG = pD->Grid;
+  int i,j,k,m,s,t,b,nvar;
+
+  if (n < 1) return;
+  if (nmomq == 0) moments_init();
+
+/* Forget the slots of an earlier time */
+
+  if ((nsel > 0) && (pG->time != momtime)) nsel = 0;
+  momtime = pG->time;
+
+/* Collect the selections that are not binned yet */
+
+  if ((momsel = (PropFun_t*)realloc(momsel,
+                                   (nsel+n)*sizeof(PropFun_t))) == NULL)
+    ath_error("[particle_moments]: Error allocating memory\n");
+
+  nnew = 0;
+  newsel = &(momsel[nsel]);
+  for (s=0; s<n; s++) {
+    for (t=0; t<nsel+nnew; t++)
+      if (momsel[t] == sel[s]) break;
+    if (t == nsel+nnew) newsel[nnew++] = sel[s];
+  }
+
+  if (nnew > 0) {
+    moments_alloc(pG, nslot*(nsel+nnew));
+
+    /* initialization */
+    for (m=nslot*nsel; m<nslot*(nsel+nnew); m++) {
+#ifdef OPENMP
+#pragma omp parallel for private(i,j)
+#endif
+      for (k=klp; k<=kup; k++)
+        for (j=jlp; j<=jup; j++)
+          for (i=ilp; i<=iup; i++)
+            pG->Mom[m][k][j][i] = 0.0;
+    }
+
+    /* bin the particles of all the new selections */
+    deposit_particles(pG, property_new, deposit_mom, 0.0);
+#ifdef DEBUG
+    moments_check(pG);
+#endif
+
+    /* deposit ghost zone values into the boundary zones: the density and
+     * momentum density together (for the shear correction), then the other
+     * quantities by groups of at most 5 */
+    for (s=nsel; s<nsel+nnew; s++) {
+      for (b=0; b<nblk; b++) {
+        m = nslot*s + nmomq*b;
+        exchange_moments(pD, pG->Mom, m, 4, 1);
+        for (t=4; t<nmomq; t+=nvar) {
+          nvar = MIN(nmomq-t, 5);
+          exchange_moments(pD, pG->Mom, m+t, nvar, -1);
+        }
+      }
+    }
+
+    nsel += nnew;
+    nnew = 0;
+  }
+
+  particle_moments_select(sel[0]);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void particle_moments_select(PropFun_t par_prop)
+ *  \brief Chooses the slot of selection par_prop, which must have been binned
+ *   by particle_moments(), as the one read by expr_*par
+ */
+void particle_moments_select(PropFun_t par_prop)
+{
+  int s;
+
+  for (s=0; s<nsel; s++) {
+    if (momsel[s] == par_prop) {
+      imom = nslot*s;
+      return;
+    }
+  }
+
+  ath_error("[particle_moments_select]: This selection is not binned\n");
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn int particle_moment_index(PropFun_t par_prop, int type,
+ *                                enum MomQuantity q)
+ *  \brief Returns the index in pG->Mom of quantity q of the particles of type
+ *   type (-1: all types) selected by par_prop, or -1 if it is not binned.
+ */
+int particle_moment_index(PropFun_t par_prop, int type, enum MomQuantity q)
+{
+  int s;
+
+  if ((q < 0) || (q >= NMOMQ) || (momq[q] < 0)) return -1;
+  if ((type < -1) || (type >= nblk-1)) return -1;
+
+  for (s=0; s<nsel; s++)
+    if (momsel[s] == par_prop)
+      return nslot*s + nmomq*(type+1) + momq[q];
+
+  return -1;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void particle_dpar(DomainS *pD)
+ *  \brief Sets the local particle density pG->parsub[].dpar, interpolated
+ *   from the binned density of all the particles
+ */
+void particle_dpar(DomainS *pD)
+{
+  GridS *pG = pD->Grid;
+  PropFun_t allsel[1] = {property_all};
+  int i,j,k, is,js,ks, k1,k2, j1,j2, i1,i2, n0 = ncell-1;
+  long p;
+  Real weight[3][3][3], D, totwei;
+  Real ***dpar;
+  Real3Vect cell1;
+  GrainS *gr;
+
+  particle_moments(pD, 1, allsel);
+  dpar = pG->Mom[particle_moment_index(property_all, -1, mom_d)];
+
+  if (pG->Nx[0] > 1)  cell1.x1 = 1.0/pG->dx1;  else cell1.x1 = 0.0;
+  if (pG->Nx[1] > 1)  cell1.x2 = 1.0/pG->dx2;  else cell1.x2 = 0.0;
+  if (pG->Nx[2] > 1)  cell1.x3 = 1.0/pG->dx3;  else cell1.x3 = 0.0;
+
+  for (p=0; p<pG->nparticle; p++) {
+    gr = &(pG->particle[p]);
+    getweight(pG, gr->x1, gr->x2, gr->x3, cell1, weight, &is, &js, &ks);
+
+    k1 = MAX(ks, klp);    k2 = MIN(ks+n0, kup);
+    j1 = MAX(js, jlp);    j2 = MIN(js+n0, jup);
+    i1 = MAX(is, ilp);    i2 = MIN(is+n0, iup);
+
+    D = 0.0;  totwei = 0.0;
+    for (k=k1; k<=k2; k++)
+      for (j=j1; j<=j2; j++)
+        for (i=i1; i<=i2; i++) {
+          D += weight[k-ks][j-js][i-is]*dpar[k][j][i];
+          totwei += weight[k-ks][j-js][i-is];
+        }
+
+    /* leave dpar unchanged for a particle out of the grid, as getvalues() */
+    if (totwei >= TINY_NUMBER)
+      pG->parsub[p].dpar = D/totwei;
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void particle_moments_destruct(GridS *pG)
+ *  \brief Frees the moments array */
+void particle_moments_destruct(GridS *pG)
+{
+  int m;
+
+  if (pG->Mom != NULL) {
+    for (m=0; m<pG->nMom; m++) free_3d_array(pG->Mom[m]);
+    free_1d_array(pG->Mom);
+  }
+  pG->Mom = NULL;
+  pG->nMom = 0;
+
+  if (momsel != NULL) free(momsel);
+  momsel = NULL;
+  nsel = 0;
+
+  return;
+}
+
+/* expr_*: where * are variables d,M1,M2,M3,V1,V2,V3 for particles */
+
+/*! \fn Real expr_dpar(const Grid *pG, const int i, const int j, const int k)
+ *  \brief Wrapper for particle density */
+Real expr_dpar(const GridS *pG, const int i, const int j, const int k) {
+  return pG->Mom[imom+mom_d][k][j][i];
+}
+/*! \fn Real expr_M1par(const Grid *pG, const int i, const int j, const int k)
+ *  \brief Wrapper for particle 1-momentum */
+Real expr_M1par(const GridS *pG, const int i, const int j, const int k) {
+  return pG->Mom[imom+mom_M1][k][j][i];
+}
+
+/*! \fn Real expr_M2par(const Grid *pG, const int i, const int j, const int k)
+ *  \brief Wrapper for particle 2-momentum */
+Real expr_M2par(const GridS *pG, const int i, const int j, const int k) {
+  return pG->Mom[imom+mom_M2][k][j][i];
+}
+/*! \fn Real expr_M3par(const Grid *pG, const int i, const int j, const int k)
+ *  \brief Wrapper for particle 3-momentum */
+Real expr_M3par(const GridS *pG, const int i, const int j, const int k) {
+  return pG->Mom[imom+mom_M3][k][j][i];
+}
+/*! \fn Real expr_V1par(const Grid *pG, const int i, const int j, const int k)
+ *  \brief Wrapper for particle 1-velocity */
+Real expr_V1par(const GridS *pG, const int i, const int j, const int k) {
+  if (pG->Mom[imom+mom_d][k][j][i]>0.0)
+    return pG->Mom[imom+mom_M1][k][j][i]/pG->Mom[imom+mom_d][k][j][i];
+  else return 0.0;
+}
+/*! \fn Real expr_V2par(const Grid *pG, const int i, const int j, const int k)
+ *  \brief Wrapper for particle 2-velocity */
+Real expr_V2par(const GridS *pG, const int i, const int j, const int k) {
+  if (pG->Mom[imom+mom_d][k][j][i]>0.0)
+    return pG->Mom[imom+mom_M2][k][j][i]/pG->Mom[imom+mom_d][k][j][i];
+  else return 0.0;
+}
+/*! \fn Real expr_V3par(const Grid *pG, const int i, const int j, const int k)
+ *  \brief Wrapper for particle 3-velocity */
+Real expr_V3par(const GridS *pG, const int i, const int j, const int k) {
+  if (pG->Mom[imom+mom_d][k][j][i]>0.0)
+    return pG->Mom[imom+mom_M3][k][j][i]/pG->Mom[imom+mom_d][k][j][i];
+  else return 0.0;
+}
+
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*--------------------------------------------------------------------------- */
+/*! \fn static void moments_init(void)
+ *  \brief Reads the quantities to bin, and sets the layout of a slot */
+static void moments_init(void)
+{
+  int q;
+
+  for (q=0; q<NMOMQ; q++) momq[q] = -1;
+
+  nmomq = 0;
+  for (q=mom_d; q<=mom_M3; q++) momq[q] = nmomq++;
+  if (par_geti_def("particle","moments_current",0))
+    for (q=mom_J1; q<=mom_J3; q++) momq[q] = nmomq++;
+  if (par_geti_def("particle","moments_pressure",0))
+    for (q=mom_P11; q<=mom_P33; q++) momq[q] = nmomq++;
+  if (par_geti_def("particle","moments_energy",0))
+    momq[mom_E] = nmomq++;
+
+  for (q=0; q<NMOMQ; q++)
+    if (momq[q] >= 0) qlist[momq[q]] = q;
+
+  nblk = 1;
+  if (par_geti_def("particle","moments_species",0))
+    nblk += npartypes;
+
+  nslot = nmomq*nblk;
+
+  return;
+}
+
+/*--------------------------------------------------------------------------- */
+/*! \fn static void moments_alloc(GridS *pG, int n)
+ *  \brief Enlarges the moments array to at least n arrays, keeping the
+ *   existing ones */
+static void moments_alloc(GridS *pG, int n)
+{
+  int m, N1T, N2T, N3T;
+  Real ****Mom;
+
+  if (n <= pG->nMom) return;
+
+  N1T = iup-ilp+1;
+  N2T = jup-jlp+1;
+  N3T = kup-klp+1;
+
+  if ((Mom = (Real****)calloc_1d_array(n, sizeof(Real***))) == NULL)
+    ath_error("[moments_alloc]: Error allocating memory\n");
+  for (m=0; m<pG->nMom; m++) Mom[m] = pG->Mom[m];
+  for (m=pG->nMom; m<n; m++) {
+    Mom[m] = (Real***)calloc_3d_array(N3T,N2T,N1T, sizeof(Real));
+    if (Mom[m] == NULL)
+      ath_error("[moments_alloc]: Error allocating memory\n");
+  }
+
+  if (pG->Mom != NULL) free_1d_array(pG->Mom);
+  pG->Mom = Mom;
+  pG->nMom = n;
+
+  return;
+}
+
+/*--------------------------------------------------------------------------- */
+/*! \fn static int property_new(const GrainS *gr, const GrainAux *grsub)
+ *  \brief True if any of the selections being binned selects the particle */
+static int property_new(const GrainS *gr, const GrainAux *grsub)
+{
+  int s;
+
+  for (s=0; s<nnew; s++)
+    if ((*newsel[s])(gr, grsub)) return 1;
+
+  return 0;
+}
+
+/*--------------------------------------------------------------------------- */
+/*! \fn static void deposit_mom(GridS *pG, const GrainS *gr,
+ *                  Real weight[3][3][3], int is, int js, int ks)
+ *  \brief Adds the moments of one particle to the slots of the selections
+ *   being binned that select it */
+static void deposit_mom(GridS *pG, const GrainS *gr, Real weight[3][3][3],
+                        int is, int js, int ks)
+{
+  int i,j,k, k1,k2, j1,j2, i1,i2, s,b,nb,n,m;
+  int n0 = ncell-1;
+  GrainAux *grsub = &(pG->parsub[gr - pG->particle]);
+  Real w, mp, vsq, gam, val[NMOMQ];
+
+  k1 = MAX(ks, klp);    k2 = MIN(ks+n0, kup);
+  j1 = MAX(js, jlp);    j2 = MIN(js+n0, jup);
+  i1 = MAX(is, ilp);    i2 = MIN(is+n0, iup);
+
+/* The moments of the particle */
+
+#ifdef FEEDBACK
+  mp = grproperty[gr->property].m;
+#else
+  mp = 1.0;
+#endif
+  vsq = SQR(gr->v1) + SQR(gr->v2) + SQR(gr->v3);
+#ifdef SPECIAL_RELATIVITY
+  gam = 1.0/sqrt(MAX(1.0 - vsq, TINY_NUMBER));
+#else
+  gam = 1.0;
+#endif
+
+  val[mom_d]  = mp;
+  val[mom_M1] = mp*gr->v1;
+  val[mom_M2] = mp*gr->v2;
+  val[mom_M3] = mp*gr->v3;
+  if (momq[mom_J1] >= 0) {
+    val[mom_J1] = grproperty[gr->property].alpha*mp*gr->v1;
+    val[mom_J2] = grproperty[gr->property].alpha*mp*gr->v2;
+    val[mom_J3] = grproperty[gr->property].alpha*mp*gr->v3;
+  }
+  if (momq[mom_P11] >= 0) {
+    val[mom_P11] = gam*mp*gr->v1*gr->v1;
+    val[mom_P12] = gam*mp*gr->v1*gr->v2;
+    val[mom_P13] = gam*mp*gr->v1*gr->v3;
+    val[mom_P22] = gam*mp*gr->v2*gr->v2;
+    val[mom_P23] = gam*mp*gr->v2*gr->v3;
+    val[mom_P33] = gam*mp*gr->v3*gr->v3;
+  }
+  if (momq[mom_E] >= 0) {
+#ifdef SPECIAL_RELATIVITY
+    val[mom_E] = (gam - 1.0)*mp;
+#else
+    val[mom_E] = 0.5*mp*vsq;
+#endif
+  }
+
+/* Deposit them in block 0 and the block of the particle type of the slot of
+ * each selection */
+
+  nb = (nblk > 1) ? 2 : 1;
+
+  for (s=0; s<nnew; s++) {
+    if (!(*newsel[s])(gr, grsub)) continue;
+
+    m = nslot*(nsel+s);
+    for (b=0; b<nb; b++) {
+      if (b == 1) m += nmomq*(gr->property+1);
+
+      for (k=k1; k<=k2; k++) {
+        for (j=j1; j<=j2; j++) {
+          for (i=i1; i<=i2; i++) {
+            w = weight[k-ks][j-js][i-is];
+            for (n=0; n<nmomq; n++)
+              pG->Mom[m+n][k][j][i] += w*val[qlist[n]];
+          }
+        }
+      }
+    }
+  }
+
+  return;
+}
+
+#ifdef DEBUG
+/*--------------------------------------------------------------------------- */
+/*! \fn static void moments_check(GridS *pG)
+ *  \brief Compares the density binned by deposit_mom() with a serial
+ *   reference deposition, for all the selections being binned.
+ *
+ * The reference adds weight[a][b][c] to cell ks+a,js+b,is+c for the stencil
+ * offsets a,b,c, skipping the cells outside of the grid, so it does not
+ * depend on the clipping of the stencil.  It checks that the weights of a
+ * particle in the outermost ghost cells are indexed from the stencil start
+ * ks,js,is (and not from the clipped start).
+ */
+static void moments_check(GridS *pG)
+{
+  int i,j,k, a,b,c, is,js,ks, s,m;
+  int n0 = ncell-1;
+  long p;
+  Real mp, dmax, err, weight[3][3][3];
+  Real ***ref;
+  Real3Vect cell1;
+  GrainS *gr;
+
+  if (pG->Nx[0] > 1)  cell1.x1 = 1.0/pG->dx1;  else cell1.x1 = 0.0;
+  if (pG->Nx[1] > 1)  cell1.x2 = 1.0/pG->dx2;  else cell1.x2 = 0.0;
+  if (pG->Nx[2] > 1)  cell1.x3 = 1.0/pG->dx3;  else cell1.x3 = 0.0;
+
+  ref = (Real***)calloc_3d_array(kup-klp+1, jup-jlp+1, iup-ilp+1,
+                                 sizeof(Real));
+  if (ref == NULL)
+    ath_error("[moments_check]: Error allocating memory\n");
+
+  for (s=0; s<nnew; s++) {
+    for (k=0; k<=kup-klp; k++)
+      for (j=0; j<=jup-jlp; j++)
+        for (i=0; i<=iup-ilp; i++)
+          ref[k][j][i] = 0.0;
+
+    for (p=0; p<pG->nparticle; p++) {
+      gr = &(pG->particle[p]);
+      if (!(*newsel[s])(gr, &(pG->parsub[p]))) continue;
+#ifdef FEEDBACK
+      mp = grproperty[gr->property].m;
+#else
+      mp = 1.0;
+#endif
+      getweight(pG, gr->x1, gr->x2, gr->x3, cell1, weight, &is, &js, &ks);
+      for (a=0; a<=n0; a++) {
+        k = ks+a;
+        if ((k < klp) || (k > kup)) continue;
+        for (b=0; b<=n0; b++) {
+          j = js+b;
+          if ((j < jlp) || (j > jup)) continue;
+          for (c=0; c<=n0; c++) {
+            i = is+c;
+            if ((i < ilp) || (i > iup)) continue;
+            ref[k-klp][j-jlp][i-ilp] += weight[a][b][c]*mp;
+          }
+        }
+      }
+    }
+
+    /* the deposition order differs, so compare to round-off */
+    m = nslot*(nsel+s) + momq[mom_d];
+    dmax = TINY_NUMBER;
+    for (k=klp; k<=kup; k++)
+      for (j=jlp; j<=jup; j++)
+        for (i=ilp; i<=iup; i++)
+          dmax = MAX(dmax, fabs(ref[k-klp][j-jlp][i-ilp]));
+
+    for (k=klp; k<=kup; k++)
+      for (j=jlp; j<=jup; j++)
+        for (i=ilp; i<=iup; i++) {
+          err = fabs(pG->Mom[m][k][j][i] - ref[k-klp][j-jlp][i-ilp]);
+          if (err > 1.0e-10*dmax)
+            ath_error("[moments_check]: density %e, reference %e at %d,%d,%d\n",
+                      pG->Mom[m][k][j][i], ref[k-klp][j-jlp][i-ilp], i,j,k);
+        }
+  }
+
+  free_3d_array(ref);
+
+  return;
+}
+#endif /* DEBUG */
+
+#endif /* PARTICLES */
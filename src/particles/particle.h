@@ -41,6 +41,10 @@ Real *grrhoa;
 Real alamcoeff;
 
 
+/*! \var int nstatus
+ *  \brief number of particle steps between particle load summaries */
+int nstatus;
+
 /*! \var int ncell
  *  \brief number of neighbouring cells involved in 1D interpolation */
 int ncell;
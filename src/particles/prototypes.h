@@ -14,6 +14,13 @@
 
 #ifdef PARTICLES
 
+/* backreaction_particle.c */
+void cr_source_enroll(CRSrcFun_t fun);
+void cr_deposit(DomainS *pD);
+void cr_source_terms(DomainS *pD, Real dt);
+void cr_source_lorentz(GridS *pG, Real ****crd, Real dt);
+void cr_destruct(void);
+
 /* bvals_particle.c */
 void bvals_particle(DomainS *pD);
 #ifdef FARGO
@@ -23,12 +30,41 @@ void bvals_particle_init(MeshS *pM);
 void bvals_particle_fun(enum BCDirection dir, VGFun_t prob_bc);
 void bvals_final_particle(MeshS *pM);
 
+/* deposit_particle.c */
+void deposit_particles(GridS *pG, PropFun_t par_prop, DepFun_t dep,
+                       Real drift);
+void deposit_destruct(void);
+
 /* dump_particle_history.c */
 void dump_particle_history(MeshS *pM, OutputS *pOut);
 void dump_parhistory_enroll();
 
+/* dump_particle_diffusion.c */
+void dump_particle_diffusion(MeshS *pM, OutputS *pOut);
+
+/* dump_particle_mpiio.c */
+#ifdef MPI_PARALLEL
+void dump_particle_mpiio(MeshS *pM, OutputS *pOut);
+#endif
+
+/* dump_particle_spectrum.c */
+void dump_particle_spectrum(MeshS *pM, OutputS *pOut);
+void ekin_bins_init(char *block, int nekin_def, int *nekin,
+                    Real *lemin, Real *dlekin);
+int ekin_bin(GrainS *gr, Real lemin, Real dlekin, int nekin);
+Real *particle_hist_sum(Real *hist, int nbin);
+void particle_hist_append(MeshS *pM, OutputS *pOut, char *ext,
+                          int nekin, Real lemin, Real dlekin,
+                          int nsub, Real *sub_edges, int nbin, Real *hist);
+
+/* dump_particle_track.c */
+void dump_particle_track(MeshS *pM, OutputS *pOut);
+
 /* exchange.c */
+#ifdef FEEDBACK
 void exchange_gpcouple(DomainS *pD, short lab);
+#endif
+void exchange_moments(DomainS *pD, Real ****Mom, int n0, int nvar, int ivel);
 void exchange_gpcouple_init(MeshS *pM);
 void exchange_gpcouple_fun(enum BCDirection dir, VGFun_t prob_bc);
 void exchange_gpcouple_destruct(MeshS *pM);
@@ -37,6 +73,11 @@ void exchange_gpcouple_destruct(MeshS *pM);
 void init_particle(MeshS *pM);
 void particle_destruct(MeshS *pM);
 void particle_realloc(GridS *pG, long n);
+void particle_set_origin(MeshS *pM);
+
+/* inject_particle.c */
+void particle_inject_enroll(InjectFun_t fun);
+void inject_particles(DomainS *pD);
 
 /* integrators_particle.c */
 void Integrate_Particles(DomainS *pD);
@@ -52,11 +93,25 @@ void feedback_corrector(GridS *pG, GrainS *gri, GrainS *grf, Real3Vect cell1,
                               Real dv1, Real dv2, Real dv3, Real ts);
 #endif
 
+/* moments_particle.c */
+void particle_moments(DomainS *pD, int n, PropFun_t *sel);
+void particle_moments_select(PropFun_t par_prop);
+int  particle_moment_index(PropFun_t par_prop, int type, enum MomQuantity q);
+void particle_dpar(DomainS *pD);
+void particle_moments_destruct(GridS *pG);
+
 /* output_particle.c */
-void particle_to_grid(DomainS *pD, PropFun_t par_prop);
 void dump_particle_binary(MeshS *pM, OutputS *pOut);
 int  property_all(const GrainS *gr, const GrainAux *grsub);
 
+/* restart_particle.c */
+void dump_particle_restart(GridS *pG, FILE *fp);
+void read_particle_restart(GridS *pG, FILE *fp);
+#ifdef MPI_PARALLEL
+void dump_particle_restart_mpiio(DomainS *pD, MPI_File fh, MPI_Offset *base);
+void read_particle_restart_mpiio(DomainS *pD, MPI_File fh, MPI_Offset *base);
+#endif
+
 /* utils_particle.c */
 void get_gasinfo(GridS *pG);
 
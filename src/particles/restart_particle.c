@@ -0,0 +1,852 @@
+#include "../copyright.h"
+/*============================================================================*/
+/*! \file restart_particle.c
+ *  \brief Functions to write and read the particle section of restart files.
+ *
+ * PURPOSE: Functions to write and read the particle section of restart files,
+ *   called by dump_restart() and restart_grids() for each Grid.  The section
+ *   is versioned (PARTICLE_RESTART_VERSION) and self describing:
+ *
+ *   - "\nPARTICLE RESTART\n", int version, int sizeof(Real), long np,
+ *     int npartypes, int nreal, Real prop[npartypes][nreal],
+ *     short integrator[npartypes], Real alamcoeff, int ncol
+ *   - the ncol columns of the np grid particles, each as one contiguous block:
+ *     Real x1,x2,x3,v1,v2,v3,x1_0,x2_0,x3_0; int property; long my_id;
+ *     int init_id (0 without MPI)
+ *   - unsigned long long checksum of the property block and all columns
+ *
+ *   with prop = {[m,] rad, rho, alpha, tstop0, grrhoa} ([m] with FEEDBACK),
+ *   so that the charge-to-mass ratio alpha and the integrator of every
+ *   particle type are restored without the problem generator.  A column is
+ *   written and read with one fwrite()/fread() per staging buffer of up to
+ *   NSTAGE particles (i.e. one call per column for up to NSTAGE particles).
+ *
+ *   Restart files written before this version (section "PARTICLE LIST") are
+ *   still read; alpha is then left as set by init_particle().
+ *
+ *   For single-file restarts written with MPI-IO (see restart_mpiio.c) the
+ *   particle section of a Domain holds the same quantities for all processors:
+ *
+ *   - int version, int sizeof(Real), int npartypes, int nreal, int ncol,
+ *     int nwriter, long ntot, Real prop[npartypes][nreal],
+ *     short integrator[npartypes], Real alamcoeff
+ *   - for each writing processor w: Real bounds[nwriter][6] (MinX, MaxX of
+ *     its Grid), long offset[nwriter], long count[nwriter],
+ *     unsigned long long checksum[nwriter]
+ *   - the ncol columns of all ntot particles, ordered by writing processor
+ *
+ *   On reading, each processor only reads the particles of the writers whose
+ *   Grid overlaps its own, and keeps those inside its Grid, so the file can be
+ *   read with any domain decomposition.
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - dump_particle_restart() - writes the particle section
+ * - read_particle_restart() - reads the particle section (any version)
+ * - dump_particle_restart_mpiio() - writes the section of a single-file restart
+ * - read_particle_restart_mpiio() - reads the section of a single-file restart
+ *
+ * PRIVATE FUNCTION PROTOTYPES:
+ * - read_particle_restart_v1() - reads a "PARTICLE LIST" section
+ * - owns_particle()            - is a particle inside a Grid of the Domain?
+ * - pack_properties()          - copies the particle type properties to arrays
+ * - unpack_properties()        - copies arrays to the particle type properties
+ * - col_size()                 - size in bytes of one element of a column
+ * - get_col() / set_col()      - copy one element between particle and buffer
+ * - checksum()                 - updates the checksum with a block of bytes  */
+/*============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../defs.h"
+#include "../athena.h"
+#include "../globals.h"
+#include "../prototypes.h"
+#include "prototypes.h"
+#include "particle.h"
+
+#ifdef PARTICLES /* endif at the end of the file */
+
+#define PARTICLE_RESTART_VERSION 2
+#define NCOL_RST 12	/* number of particle columns */
+#define NSTAGE 1048576	/* particles per staging buffer */
+#define NSTAGE_MPIIO 65536	/* particles per column buffer of the reader */
+
+/* number of Reals per particle type in the property block */
+#ifdef FEEDBACK
+#define NREAL_PROP 6
+#else
+#define NREAL_PROP 5
+#endif
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   read_particle_restart_v1() - reads a "PARTICLE LIST" section
+ *   owns_particle()            - is a particle inside a Grid of the Domain?
+ *   pack_properties()          - copies the particle type properties to arrays
+ *   unpack_properties()        - copies arrays to the particle type properties
+ *   col_size()                 - size in bytes of one element of a column
+ *   get_col() / set_col()      - copy one element between particle and buffer
+ *   checksum()                 - updates the checksum with a block of bytes
+ *============================================================================*/
+static void read_particle_restart_v1(GridS *pG, FILE *fp);
+static void pack_properties(Real *prop, short *integ);
+static void unpack_properties(const Real *prop, const short *integ);
+#ifdef MPI_PARALLEL
+static int owns_particle(const DomainS *pD, const GrainS *gr);
+#endif
+static size_t col_size(int col);
+static void get_col(const GrainS *gr, int col, char *dst);
+static void set_col(GrainS *gr, int col, const char *src);
+static void checksum(unsigned long long *h, const void *data, size_t nbyte);
+
+/*============================================================================*/
+/*----------------------------- Public Functions -----------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void dump_particle_restart(GridS *pG, FILE *fp)
+ *  \brief Writes the particle section of a restart file */
+void dump_particle_restart(GridS *pG, FILE *fp)
+{
+  int col, version = PARTICLE_RESTART_VERSION, prec = (int)sizeof(Real);
+  int nreal = NREAL_PROP, ncol = NCOL_RST;
+  long p, n, np;
+  size_t size;
+  unsigned long long h = 0;
+  char *stage;
+  Real *prop;
+  short *integ;
+
+/* Header and property block */
+
+  np = 0;
+  for (p=0; p<pG->nparticle; p++)
+    if (pG->particle[p].pos == 1) np += 1;
+
+  prop  = (Real*)calloc_1d_array(npartypes*NREAL_PROP, sizeof(Real));
+  integ = (short*)calloc_1d_array(npartypes, sizeof(short));
+  stage = (char*)calloc_1d_array(MIN(MAX(np,1),NSTAGE), sizeof(long));
+  if ((prop == NULL) || (integ == NULL) || (stage == NULL))
+    ath_error("[dump_particle_restart]: Error allocating memory\n");
+
+  pack_properties(prop, integ);
+
+  fprintf(fp,"\nPARTICLE RESTART\n");
+  fwrite(&version,sizeof(int),1,fp);
+  fwrite(&prec,sizeof(int),1,fp);
+  fwrite(&np,sizeof(long),1,fp);
+  fwrite(&npartypes,sizeof(int),1,fp);
+  fwrite(&nreal,sizeof(int),1,fp);
+  fwrite(prop,sizeof(Real),npartypes*NREAL_PROP,fp);
+  fwrite(integ,sizeof(short),npartypes,fp);
+  fwrite(&alamcoeff,sizeof(Real),1,fp);
+  fwrite(&ncol,sizeof(int),1,fp);
+
+  checksum(&h, prop, npartypes*NREAL_PROP*sizeof(Real));
+  checksum(&h, integ, npartypes*sizeof(short));
+
+/* Particle columns, staged NSTAGE particles at a time */
+
+  for (col=0; col<NCOL_RST; col++) {
+    size = col_size(col);
+    n = 0;
+    for (p=0; p<pG->nparticle; p++) {
+      if (pG->particle[p].pos != 1) continue;
+      get_col(&(pG->particle[p]), col, stage + n*size);
+      if (++n == NSTAGE) {
+        if (fwrite(stage,size,n,fp) != (size_t)n)
+          ath_error("[dump_particle_restart]: fwrite() error\n");
+        checksum(&h, stage, n*size);
+        n = 0;
+      }
+    }
+    if (n > 0) {
+      if (fwrite(stage,size,n,fp) != (size_t)n)
+        ath_error("[dump_particle_restart]: fwrite() error\n");
+      checksum(&h, stage, n*size);
+    }
+  }
+
+  fwrite(&h,sizeof(unsigned long long),1,fp);
+
+  free_1d_array(prop);
+  free_1d_array(integ);
+  free_1d_array(stage);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void read_particle_restart(GridS *pG, FILE *fp)
+ *  \brief Reads the particle section of a restart file, in the current or
+ *   the original ("PARTICLE LIST") format */
+void read_particle_restart(GridS *pG, FILE *fp)
+{
+  char line[MAXLEN];
+  int i, col, version, prec, nreal, ncol, ntype;
+  long p, n, np, nread;
+  size_t size;
+  unsigned long long h = 0, hfile;
+  char *stage;
+  Real *prop;
+  short *integ;
+
+  fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
+  fgets(line,MAXLEN,fp);
+  if(strncmp(line,"PARTICLE LIST",13) == 0) {
+    read_particle_restart_v1(pG, fp);
+    return;
+  }
+  if(strncmp(line,"PARTICLE RESTART",16) != 0)
+    ath_error("[read_particle_restart]: Expected PARTICLE RESTART, found %s",
+              line);
+
+/* Header and property block */
+
+  fread(&version,sizeof(int),1,fp);
+  fread(&prec,sizeof(int),1,fp);
+  if (version != PARTICLE_RESTART_VERSION)
+    ath_error("[read_particle_restart]: Unsupported version %d\n",version);
+  if (prec != (int)sizeof(Real))
+    ath_error("[read_particle_restart]: Written with sizeof(Real)=%d\n",prec);
+
+  fread(&np,sizeof(long),1,fp);
+  fread(&ntype,sizeof(int),1,fp);
+  fread(&nreal,sizeof(int),1,fp);
+  if (ntype != npartypes)
+    ath_error("[read_particle_restart]: %d particle types, expected %d\n",
+              ntype,npartypes);
+  if (nreal != NREAL_PROP)
+    ath_error("[read_particle_restart]: %d Reals per particle type, expected \
+%d (FEEDBACK mismatch?)\n",nreal,NREAL_PROP);
+
+  prop  = (Real*)calloc_1d_array(npartypes*NREAL_PROP, sizeof(Real));
+  integ = (short*)calloc_1d_array(npartypes, sizeof(short));
+  stage = (char*)calloc_1d_array(MIN(MAX(np,1),NSTAGE), sizeof(long));
+  if ((prop == NULL) || (integ == NULL) || (stage == NULL))
+    ath_error("[read_particle_restart]: Error allocating memory\n");
+
+  fread(prop,sizeof(Real),npartypes*NREAL_PROP,fp);
+  fread(integ,sizeof(short),npartypes,fp);
+  fread(&alamcoeff,sizeof(Real),1,fp);
+  fread(&ncol,sizeof(int),1,fp);
+  if (ncol != NCOL_RST)
+    ath_error("[read_particle_restart]: %d columns, expected %d\n",
+              ncol,NCOL_RST);
+
+  checksum(&h, prop, npartypes*NREAL_PROP*sizeof(Real));
+  checksum(&h, integ, npartypes*sizeof(short));
+
+  unpack_properties(prop, integ);
+
+/* Particle columns, staged NSTAGE particles at a time */
+
+  pG->nparticle = np;
+  if (pG->nparticle > pG->arrsize-2)
+    particle_realloc(pG, pG->nparticle+2);
+
+  for (col=0; col<NCOL_RST; col++) {
+    size = col_size(col);
+    for (p=0; p<np; p+=nread) {
+      nread = MIN(np-p, NSTAGE);
+      if (fread(stage,size,nread,fp) != (size_t)nread)
+        ath_error("[read_particle_restart]: fread() error\n");
+      checksum(&h, stage, nread*size);
+      for (n=0; n<nread; n++)
+        set_col(&(pG->particle[p+n]), col, stage + n*size);
+    }
+  }
+
+  fread(&hfile,sizeof(unsigned long long),1,fp);
+  if (hfile != h)
+    ath_error("[read_particle_restart]: Checksum mismatch, the particle \
+section of the restart file is corrupted\n");
+
+  for (p=0; p<np; p++)
+    pG->particle[p].pos = 1;	/* grid particle */
+
+/* count the number of particles with different types */
+
+  for (i=0; i<npartypes; i++)
+    grproperty[i].num = 0;
+  for (p=0; p<pG->nparticle; p++)
+    grproperty[pG->particle[p].property].num += 1;
+
+  free_1d_array(prop);
+  free_1d_array(integ);
+  free_1d_array(stage);
+
+  return;
+}
+
+#ifdef MPI_PARALLEL
+/*----------------------------------------------------------------------------*/
+/*! \fn void dump_particle_restart_mpiio(DomainS *pD, MPI_File fh,
+ *                                       MPI_Offset *base)
+ *  \brief Writes the particle section of Domain pD of a single-file restart
+ *   at offset *base, and advances *base past it.  Collective over all
+ *   processors, also those without a Grid in pD. */
+void dump_particle_restart_mpiio(DomainS *pD, MPI_File fh, MPI_Offset *base)
+{
+  GridS *pG = pD->Grid;
+  MPI_Status stat;
+  MPI_Offset hsize, cbase;
+  int i, col, nwriter, err, hdr[6];
+  long p, n, np, ntot, offset, *loff = NULL, *lcnt = NULL;
+  size_t size;
+  unsigned long long h, hcol[NCOL_RST], *lh = NULL;
+  char *stage;
+  Real box[6], *lbox = NULL, *prop;
+  short *integ;
+
+  MPI_Comm_size(MPI_COMM_WORLD, &nwriter);
+
+/* Number of grid particles, offset of this processor and total */
+
+  np = 0;
+  if (pG != NULL)
+    for (p=0; p<pG->nparticle; p++)
+      if (pG->particle[p].pos == 1) np += 1;
+
+  offset = 0;
+  err = MPI_Exscan(&np, &offset, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+  if (err) ath_error("[dump_particle_restart_mpiio]: MPI_Exscan error = %d\n",
+                     err);
+  if (myID_Comm_world == 0) offset = 0; /* undefined on the first process */
+  err = MPI_Allreduce(&np, &ntot, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+  if (err) ath_error("[dump_particle_restart_mpiio]: MPI_Allreduce error = \
+%d\n",err);
+
+  hsize = 6*sizeof(int) + sizeof(long)
+        + npartypes*(NREAL_PROP*sizeof(Real) + sizeof(short)) + sizeof(Real)
+        + nwriter*(6*sizeof(Real) + 2*sizeof(long)
+                 + sizeof(unsigned long long));
+
+/* Write the columns of this processor, staged NSTAGE particles at a time */
+
+  stage = (char*)calloc_1d_array(MIN(MAX(np,1),NSTAGE), sizeof(long));
+  if (stage == NULL)
+    ath_error("[dump_particle_restart_mpiio]: Error allocating memory\n");
+
+  cbase = *base + hsize;
+  for (col=0; col<NCOL_RST; col++) {
+    size = col_size(col);
+    hcol[col] = 0;
+    n = 0;
+    for (p=0; np>0 && p<pG->nparticle; p++) {
+      if (pG->particle[p].pos != 1) continue;
+      get_col(&(pG->particle[p]), col, stage + n*size);
+      if (++n == NSTAGE) {
+        MPI_File_write_at(fh, cbase + offset*size, stage, (int)(n*size),
+                          MPI_BYTE, &stat);
+        checksum(&(hcol[col]), stage, n*size);
+        offset += n;
+        n = 0;
+      }
+    }
+    if (n > 0) {
+      MPI_File_write_at(fh, cbase + offset*size, stage, (int)(n*size),
+                        MPI_BYTE, &stat);
+      checksum(&(hcol[col]), stage, n*size);
+      offset += n;
+    }
+    offset -= np;
+    cbase += ntot*size;
+  }
+  h = 0;
+  checksum(&h, hcol, NCOL_RST*sizeof(unsigned long long));
+  free_1d_array(stage);
+
+/* Gather the Grid bounds, offsets, counts and checksums on the root */
+
+  for (i=0; i<6; i++) box[i] = 0.0;
+  if (pG != NULL) {
+    for (i=0; i<3; i++) {
+      box[i]   = pG->MinX[i];
+      box[3+i] = pG->MaxX[i];
+    }
+  }
+  if (myID_Comm_world == 0) {
+    lbox = (Real*)calloc_1d_array(6*nwriter, sizeof(Real));
+    loff = (long*)calloc_1d_array(nwriter, sizeof(long));
+    lcnt = (long*)calloc_1d_array(nwriter, sizeof(long));
+    lh   = (unsigned long long*)calloc_1d_array(nwriter,
+                                                sizeof(unsigned long long));
+    if ((lbox == NULL) || (loff == NULL) || (lcnt == NULL) || (lh == NULL))
+      ath_error("[dump_particle_restart_mpiio]: Error allocating memory\n");
+  }
+  MPI_Gather(box, 6, MPI_DOUBLE, lbox, 6, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  MPI_Gather(&offset, 1, MPI_LONG, loff, 1, MPI_LONG, 0, MPI_COMM_WORLD);
+  MPI_Gather(&np, 1, MPI_LONG, lcnt, 1, MPI_LONG, 0, MPI_COMM_WORLD);
+  MPI_Gather(&h, 1, MPI_UNSIGNED_LONG_LONG, lh, 1, MPI_UNSIGNED_LONG_LONG, 0,
+             MPI_COMM_WORLD);
+
+/* The root process writes the header */
+
+  if (myID_Comm_world == 0) {
+    prop  = (Real*)calloc_1d_array(npartypes*NREAL_PROP, sizeof(Real));
+    integ = (short*)calloc_1d_array(npartypes, sizeof(short));
+    if ((prop == NULL) || (integ == NULL))
+      ath_error("[dump_particle_restart_mpiio]: Error allocating memory\n");
+    pack_properties(prop, integ);
+
+    hdr[0] = PARTICLE_RESTART_VERSION;
+    hdr[1] = (int)sizeof(Real);
+    hdr[2] = npartypes;
+    hdr[3] = NREAL_PROP;
+    hdr[4] = NCOL_RST;
+    hdr[5] = nwriter;
+    cbase = *base;
+    MPI_File_write_at(fh, cbase, hdr, 6, MPI_INT, &stat);
+    cbase += 6*sizeof(int);
+    MPI_File_write_at(fh, cbase, &ntot, 1, MPI_LONG, &stat);
+    cbase += sizeof(long);
+    MPI_File_write_at(fh, cbase, prop, npartypes*NREAL_PROP*sizeof(Real),
+                      MPI_BYTE, &stat);
+    cbase += npartypes*NREAL_PROP*sizeof(Real);
+    MPI_File_write_at(fh, cbase, integ, npartypes, MPI_SHORT, &stat);
+    cbase += npartypes*sizeof(short);
+    MPI_File_write_at(fh, cbase, &alamcoeff, sizeof(Real), MPI_BYTE, &stat);
+    cbase += sizeof(Real);
+    MPI_File_write_at(fh, cbase, lbox, 6*nwriter*sizeof(Real), MPI_BYTE,
+                      &stat);
+    cbase += 6*nwriter*sizeof(Real);
+    MPI_File_write_at(fh, cbase, loff, nwriter, MPI_LONG, &stat);
+    cbase += nwriter*sizeof(long);
+    MPI_File_write_at(fh, cbase, lcnt, nwriter, MPI_LONG, &stat);
+    cbase += nwriter*sizeof(long);
+    MPI_File_write_at(fh, cbase, lh, nwriter, MPI_UNSIGNED_LONG_LONG, &stat);
+
+    free_1d_array(prop);
+    free_1d_array(integ);
+    free_1d_array(lbox);
+    free_1d_array(loff);
+    free_1d_array(lcnt);
+    free_1d_array(lh);
+  }
+
+  for (col=0; col<NCOL_RST; col++)
+    hsize += ntot*col_size(col);
+  *base += hsize;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void read_particle_restart_mpiio(DomainS *pD, MPI_File fh,
+ *                                       MPI_Offset *base)
+ *  \brief Reads the particle section of Domain pD of a single-file restart at
+ *   offset *base, and advances *base past it.  Each processor keeps the
+ *   particles inside its Grid, whatever decomposition wrote the file.
+ *   Collective over all processors, also those without a Grid in pD. */
+void read_particle_restart_mpiio(DomainS *pD, MPI_File fh, MPI_Offset *base)
+{
+  GridS *pG = pD->Grid;
+  GrainS gr;
+  MPI_Status stat;
+  MPI_Offset hsize, cbase, coff[NCOL_RST];
+  int i, w, col, nwriter, overlap, hdr[6];
+  long p, n, nread, ntot, nmine, nall, *loff, *lcnt;
+  unsigned long long h, hcol[NCOL_RST], *lh;
+  char *stage[NCOL_RST];
+  Real *lbox, *prop;
+  short *integ;
+
+/* Header and property block */
+
+  cbase = *base;
+  MPI_File_read_at(fh, cbase, hdr, 6, MPI_INT, &stat);
+  cbase += 6*sizeof(int);
+  if (hdr[0] != PARTICLE_RESTART_VERSION)
+    ath_error("[read_particle_restart_mpiio]: Unsupported version %d\n",
+              hdr[0]);
+  if (hdr[1] != (int)sizeof(Real))
+    ath_error("[read_particle_restart_mpiio]: Written with sizeof(Real)=%d\n",
+              hdr[1]);
+  if (hdr[2] != npartypes)
+    ath_error("[read_particle_restart_mpiio]: %d particle types, expected %d\n",
+              hdr[2],npartypes);
+  if (hdr[3] != NREAL_PROP)
+    ath_error("[read_particle_restart_mpiio]: %d Reals per particle type, \
+expected %d (FEEDBACK mismatch?)\n",hdr[3],NREAL_PROP);
+  if (hdr[4] != NCOL_RST)
+    ath_error("[read_particle_restart_mpiio]: %d columns, expected %d\n",
+              hdr[4],NCOL_RST);
+  nwriter = hdr[5];
+
+  MPI_File_read_at(fh, cbase, &ntot, 1, MPI_LONG, &stat);
+  cbase += sizeof(long);
+
+  prop  = (Real*)calloc_1d_array(npartypes*NREAL_PROP, sizeof(Real));
+  integ = (short*)calloc_1d_array(npartypes, sizeof(short));
+  lbox  = (Real*)calloc_1d_array(6*nwriter, sizeof(Real));
+  loff  = (long*)calloc_1d_array(nwriter, sizeof(long));
+  lcnt  = (long*)calloc_1d_array(nwriter, sizeof(long));
+  lh    = (unsigned long long*)calloc_1d_array(nwriter,
+                                               sizeof(unsigned long long));
+  if ((prop == NULL) || (integ == NULL) || (lbox == NULL) || (loff == NULL) ||
+      (lcnt == NULL) || (lh == NULL))
+    ath_error("[read_particle_restart_mpiio]: Error allocating memory\n");
+
+  MPI_File_read_at(fh, cbase, prop, npartypes*NREAL_PROP*sizeof(Real),
+                   MPI_BYTE, &stat);
+  cbase += npartypes*NREAL_PROP*sizeof(Real);
+  MPI_File_read_at(fh, cbase, integ, npartypes, MPI_SHORT, &stat);
+  cbase += npartypes*sizeof(short);
+  MPI_File_read_at(fh, cbase, &alamcoeff, sizeof(Real), MPI_BYTE, &stat);
+  cbase += sizeof(Real);
+  MPI_File_read_at(fh, cbase, lbox, 6*nwriter*sizeof(Real), MPI_BYTE, &stat);
+  cbase += 6*nwriter*sizeof(Real);
+  MPI_File_read_at(fh, cbase, loff, nwriter, MPI_LONG, &stat);
+  cbase += nwriter*sizeof(long);
+  MPI_File_read_at(fh, cbase, lcnt, nwriter, MPI_LONG, &stat);
+  cbase += nwriter*sizeof(long);
+  MPI_File_read_at(fh, cbase, lh, nwriter, MPI_UNSIGNED_LONG_LONG, &stat);
+  cbase += nwriter*sizeof(unsigned long long);
+  hsize = cbase - *base;
+
+  unpack_properties(prop, integ);
+
+  for (col=0; col<NCOL_RST; col++) {
+    coff[col] = cbase;
+    cbase += ntot*col_size(col);
+  }
+
+/* Read the particles of all writers whose Grid overlaps this Grid (the
+ * complete range of a writer, to verify its checksum), and keep those inside
+ * this Grid */
+
+  nmine = 0;
+  if (pG != NULL) {
+    pG->nparticle = 0;
+    for (col=0; col<NCOL_RST; col++)
+      if ((stage[col] = (char*)calloc_1d_array(NSTAGE_MPIIO, sizeof(long)))
+          == NULL)
+        ath_error("[read_particle_restart_mpiio]: Error allocating memory\n");
+
+    for (w=0; w<nwriter; w++) {
+      if (lcnt[w] == 0) continue;
+      overlap = 1;
+      for (i=0; i<3; i++) {
+        if (pD->Nx[i] == 1) continue;
+        if ((lbox[6*w+i] > pG->MaxX[i]) || (lbox[6*w+3+i] < pG->MinX[i]))
+          overlap = 0;
+      }
+      if (!overlap) continue;
+
+      for (col=0; col<NCOL_RST; col++) hcol[col] = 0;
+      for (p=0; p<lcnt[w]; p+=nread) {
+        nread = MIN(lcnt[w]-p, NSTAGE_MPIIO);
+        for (col=0; col<NCOL_RST; col++) {
+          MPI_File_read_at(fh, coff[col] + (loff[w]+p)*col_size(col),
+                     stage[col], (int)(nread*col_size(col)), MPI_BYTE, &stat);
+          checksum(&(hcol[col]), stage[col], nread*col_size(col));
+        }
+        for (n=0; n<nread; n++) {
+          for (col=0; col<NCOL_RST; col++)
+            set_col(&gr, col, stage[col] + n*col_size(col));
+          if (!owns_particle(pD, &gr)) continue;
+          if (pG->nparticle+2 > pG->arrsize)
+            particle_realloc(pG, pG->nparticle+3);
+          gr.pos = 1;	/* grid particle */
+          pG->particle[pG->nparticle] = gr;
+          pG->nparticle += 1;
+        }
+      }
+      h = 0;
+      checksum(&h, hcol, NCOL_RST*sizeof(unsigned long long));
+      if (h != lh[w])
+        ath_error("[read_particle_restart_mpiio]: Checksum mismatch for the \
+particles of writer %d, the restart file is corrupted\n",w);
+    }
+    nmine = pG->nparticle;
+
+    for (col=0; col<NCOL_RST; col++)
+      free_1d_array(stage[col]);
+
+/* count the number of particles with different types */
+
+    for (i=0; i<npartypes; i++)
+      grproperty[i].num = 0;
+    for (p=0; p<pG->nparticle; p++)
+      grproperty[pG->particle[p].property].num += 1;
+  }
+
+/* Every particle must have been picked up by exactly one processor */
+
+  MPI_Allreduce(&nmine, &nall, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+  if (nall != ntot)
+    ath_error("[read_particle_restart_mpiio]: Read %ld particles, expected \
+%ld\n",nall,ntot);
+
+  free_1d_array(prop);
+  free_1d_array(integ);
+  free_1d_array(lbox);
+  free_1d_array(loff);
+  free_1d_array(lcnt);
+  free_1d_array(lh);
+
+  *base += hsize;
+  for (col=0; col<NCOL_RST; col++)
+    *base += ntot*col_size(col);
+
+  return;
+}
+#endif /* MPI_PARALLEL */
+
+/*============================================================================*/
+/*----------------------------- Private Functions ----------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void read_particle_restart_v1(GridS *pG, FILE *fp)
+ *  \brief Reads the original particle section, after its "PARTICLE LIST"
+ *   label: one block per quantity, each preceeded by its own label */
+static void read_particle_restart_v1(GridS *pG, FILE *fp)
+{
+  char line[MAXLEN];
+  static const char *label[NCOL_RST] = {"PARTICLE X1", "PARTICLE X2",
+    "PARTICLE X3", "PARTICLE V1", "PARTICLE V2", "PARTICLE V3", NULL, NULL,
+    NULL, "PARTICLE PROPERTY", "PARTICLE MY_ID", "PARTICLE INIT_ID"};
+  int i, col;
+  long p, fpos;
+
+  fread(&(pG->nparticle),sizeof(long),1,fp);
+
+  if (pG->nparticle > pG->arrsize-2)
+    particle_realloc(pG, pG->nparticle+2);
+
+  fread(&(npartypes),sizeof(int),1,fp);
+  for (i=0; i<npartypes; i++) {          /* particle property list */
+#ifdef FEEDBACK
+    fread(&(grproperty[i].m),sizeof(Real),1,fp);
+#endif
+    fread(&(grproperty[i].rad),sizeof(Real),1,fp);
+    fread(&(grproperty[i].rho),sizeof(Real),1,fp);
+    fread(&(tstop0[i]),sizeof(Real),1,fp);
+    fread(&(grrhoa[i]),sizeof(Real),1,fp);
+  }
+  fread(&(alamcoeff),sizeof(Real),1,fp);  /* coef to calc Reynolds number */
+
+  for (i=0; i<npartypes; i++)
+    fread(&(grproperty[i].integrator),sizeof(short),1,fp);
+
+/* Read the labelled quantities (init_id only with MPI) */
+
+  for (col=0; col<NCOL_RST; col++) {
+    if (label[col] == NULL) continue;
+#ifndef MPI_PARALLEL
+    if (col == NCOL_RST-1) continue;
+#endif
+    fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
+    fgets(line,MAXLEN,fp);
+    if(strncmp(line,label[col],strlen(label[col])) != 0)
+      ath_error("[read_particle_restart]: Expected %s, found %s",
+                label[col],line);
+    for (p=0; p<pG->nparticle; p++) {
+      fread(line,col_size(col),1,fp);
+      set_col(&(pG->particle[p]), col, line);
+    }
+  }
+  for (p=0; p<pG->nparticle; p++)
+    pG->particle[p].pos = 1;	/* grid particle */
+
+/* Read the initial particle coordinates, if present.  Otherwise the current
+ * positions are used as the origin. */
+
+  fpos = ftell(fp);
+  fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
+  fgets(line,MAXLEN,fp);
+  if(strncmp(line,"PARTICLE ORIGIN",15) == 0) {
+    for (p=0; p<pG->nparticle; p++) {
+      fread(&(pG->particle[p].x1_0),sizeof(Real),1,fp);
+      fread(&(pG->particle[p].x2_0),sizeof(Real),1,fp);
+      fread(&(pG->particle[p].x3_0),sizeof(Real),1,fp);
+    }
+  } else {
+    fseek(fp,fpos,SEEK_SET);
+    ath_pout(0,"[read_particle_restart]: No PARTICLE ORIGIN, resetting \
+origin\n");
+    for (p=0; p<pG->nparticle; p++) {
+      pG->particle[p].x1_0 = pG->particle[p].x1;
+      pG->particle[p].x2_0 = pG->particle[p].x2;
+      pG->particle[p].x3_0 = pG->particle[p].x3;
+    }
+  }
+
+/* count the number of particles with different types */
+
+  for (i=0; i<npartypes; i++)
+    grproperty[i].num = 0;
+  for (p=0; p<pG->nparticle; p++)
+    grproperty[pG->particle[p].property].num += 1;
+
+  return;
+}
+
+#ifdef MPI_PARALLEL
+/*----------------------------------------------------------------------------*/
+/*! \fn static int owns_particle(const DomainS *pD, const GrainS *gr)
+ *  \brief Returns 1 if particle gr lies inside the Grid of Domain pD on this
+ *   processor.  The Grids at the Domain edges also own the particles beyond
+ *   the edge, so every particle is owned by exactly one Grid. */
+static int owns_particle(const DomainS *pD, const GrainS *gr)
+{
+  const GridS *pG = pD->Grid;
+  Real x[3];
+  int i;
+
+  x[0] = gr->x1;  x[1] = gr->x2;  x[2] = gr->x3;
+  for (i=0; i<3; i++) {
+    if (pD->Nx[i] == 1) continue;
+    if ((x[i] < pG->MinX[i]) && (pG->Disp[i] > pD->Disp[i]))
+      return 0;
+    if ((x[i] >= pG->MaxX[i]) &&
+        (pG->Disp[i] + pG->Nx[i] < pD->Disp[i] + pD->Nx[i]))
+      return 0;
+  }
+
+  return 1;
+}
+#endif /* MPI_PARALLEL */
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void pack_properties(Real *prop, short *integ)
+ *  \brief Copies the properties of all particle types to prop[npartypes]
+ *   [NREAL_PROP] and their integrators to integ[npartypes] */
+static void pack_properties(Real *prop, short *integ)
+{
+  int i, n;
+
+  for (i=0; i<npartypes; i++) {
+    n = i*NREAL_PROP;
+#ifdef FEEDBACK
+    prop[n++] = grproperty[i].m;
+#endif
+    prop[n++] = grproperty[i].rad;
+    prop[n++] = grproperty[i].rho;
+    prop[n++] = grproperty[i].alpha;
+    prop[n++] = tstop0[i];
+    prop[n++] = grrhoa[i];
+    integ[i] = grproperty[i].integrator;
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void unpack_properties(const Real *prop, const short *integ)
+ *  \brief Sets the properties of all particle types from the arrays written
+ *   by pack_properties() */
+static void unpack_properties(const Real *prop, const short *integ)
+{
+  int i, n;
+
+  for (i=0; i<npartypes; i++) {
+    n = i*NREAL_PROP;
+#ifdef FEEDBACK
+    grproperty[i].m = prop[n++];
+#endif
+    grproperty[i].rad = prop[n++];
+    grproperty[i].rho = prop[n++];
+    grproperty[i].alpha = prop[n++];
+    tstop0[i] = prop[n++];
+    grrhoa[i] = prop[n++];
+    grproperty[i].integrator = integ[i];
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static size_t col_size(int col)
+ *  \brief Size in bytes of one element of column col */
+static size_t col_size(int col)
+{
+  if (col < 9)  return sizeof(Real);
+  if (col == 10) return sizeof(long);
+  return sizeof(int);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void get_col(const GrainS *gr, int col, char *dst)
+ *  \brief Copies the element of column col of particle gr to dst */
+static void get_col(const GrainS *gr, int col, char *dst)
+{
+  int init_id = 0;
+
+  switch (col) {
+  case 0:  memcpy(dst, &(gr->x1),   sizeof(Real));  break;
+  case 1:  memcpy(dst, &(gr->x2),   sizeof(Real));  break;
+  case 2:  memcpy(dst, &(gr->x3),   sizeof(Real));  break;
+  case 3:  memcpy(dst, &(gr->v1),   sizeof(Real));  break;
+  case 4:  memcpy(dst, &(gr->v2),   sizeof(Real));  break;
+  case 5:  memcpy(dst, &(gr->v3),   sizeof(Real));  break;
+  case 6:  memcpy(dst, &(gr->x1_0), sizeof(Real));  break;
+  case 7:  memcpy(dst, &(gr->x2_0), sizeof(Real));  break;
+  case 8:  memcpy(dst, &(gr->x3_0), sizeof(Real));  break;
+  case 9:  memcpy(dst, &(gr->property), sizeof(int));  break;
+  case 10: memcpy(dst, &(gr->my_id), sizeof(long));  break;
+  default:
+#ifdef MPI_PARALLEL
+    init_id = gr->init_id;
+#endif
+    memcpy(dst, &init_id, sizeof(int));
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void set_col(GrainS *gr, int col, const char *src)
+ *  \brief Copies src to the element of column col of particle gr */
+static void set_col(GrainS *gr, int col, const char *src)
+{
+  switch (col) {
+  case 0:  memcpy(&(gr->x1),   src, sizeof(Real));  break;
+  case 1:  memcpy(&(gr->x2),   src, sizeof(Real));  break;
+  case 2:  memcpy(&(gr->x3),   src, sizeof(Real));  break;
+  case 3:  memcpy(&(gr->v1),   src, sizeof(Real));  break;
+  case 4:  memcpy(&(gr->v2),   src, sizeof(Real));  break;
+  case 5:  memcpy(&(gr->v3),   src, sizeof(Real));  break;
+  case 6:  memcpy(&(gr->x1_0), src, sizeof(Real));  break;
+  case 7:  memcpy(&(gr->x2_0), src, sizeof(Real));  break;
+  case 8:  memcpy(&(gr->x3_0), src, sizeof(Real));  break;
+  case 9:  memcpy(&(gr->property), src, sizeof(int));  break;
+  case 10: memcpy(&(gr->my_id), src, sizeof(long));  break;
+  default:
+#ifdef MPI_PARALLEL
+    memcpy(&(gr->init_id), src, sizeof(int));
+#endif
+    break;
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void checksum(unsigned long long *h, const void *data,
+ *                           size_t nbyte)
+ *  \brief Updates the checksum h (FNV-1a on 64-bit words) with nbyte bytes */
+static void checksum(unsigned long long *h, const void *data, size_t nbyte)
+{
+  const unsigned char *pc = (const unsigned char*)data;
+  unsigned long long w;
+  size_t i;
+
+  for (i=0; i+8<=nbyte; i+=8) {
+    memcpy(&w, pc+i, 8);
+    *h = (*h ^ w)*0x100000001b3ULL;
+  }
+  for (; i<nbyte; i++)
+    *h = (*h ^ (unsigned long long)pc[i])*0x100000001b3ULL;
+
+  return;
+}
+
+#undef PARTICLE_RESTART_VERSION
+#undef NCOL_RST
+#undef NSTAGE
+#undef NSTAGE_MPIIO
+#undef NREAL_PROP
+
+#endif /* PARTICLES */
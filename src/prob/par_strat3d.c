@@ -61,8 +61,6 @@ Real dpar_thresh; /* threshold particle density */
 
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
- * ran2()            - random number generator
- * Normal()          - normal distribution generator
  * Erf()             - error function
  * MultiNSH()        - multiple component NSH equilibrium solver
  * ShearingBoxPot()  - shearing box tidal gravitational potential
@@ -70,8 +68,6 @@ Real dpar_thresh; /* threshold particle density */
  * property_???()    - particle property selection function
  *============================================================================*/
 
-double ran2(long int *idum);
-double Normal(long int *idum);
 Real Erf(Real z);
 
 void MultiNSH(int n, Real *tstop, Real *mratio, Real etavk,
@@ -104,7 +100,8 @@ void problem(DomainS *pDomain)
   Real *ep,*ScaleHpar,epsum,mratio,pwind,rhoaconv,etavk;
   Real *epsilon,*uxNSH,*uyNSH,**wxNSH,**wyNSH;
   Real rhog,h,x1,x2,x3,t,x1p,x2p,x3p,zmin,zmax,dx3_1,b;
-  long int iseed = myID_Comm_world; /* Initialize on the first call to ran2 */
+  unsigned long seed,pid;
+  unsigned int n;
 
   if (pDomain->Nx[2] == 1) {
     ath_error("[par_strat3d]: par_strat3d only works for 3D problem.\n");
@@ -278,15 +275,24 @@ void problem(DomainS *pDomain)
   zmin = pGrid->MinX[2];
   zmax = pGrid->MaxX[2];
 
+/* The random numbers are keyed on (seed, global particle id, stream), where the
+ * global id counts the particles of all grids in the order of the grid offsets,
+ * so a particle does not depend on the rank that creates it. */
+  seed = (unsigned long)par_geti_def("problem","seed",0);
+  pid = ((unsigned long)pGrid->Disp[2]*pDomain->Nx[1] + pGrid->Disp[1])
+        *pDomain->Nx[0] + pGrid->Disp[0];
+  pid *= Npar*npartypes;
+
   for (q=0; q<Npar; q++) {
 
     for (pt=0; pt<npartypes; pt++) {
 
-      x1p = x1min + Lx*ran2(&iseed);
-      x2p = x2min + Ly*ran2(&iseed);
-      x3p = ScaleHpar[pt]*ScaleHg*Normal(&iseed);
+      x1p = x1min + Lx*ath_rand_uniform(seed,pid+p,0,0);
+      x2p = x2min + Ly*ath_rand_uniform(seed,pid+p,1,0);
+      n = 0;
+      x3p = ScaleHpar[pt]*ScaleHg*ath_rand_normal(seed,pid+p,2,n++);
       while ((x3p >= zmax) || (x3p < zmin))
-        x3p = ScaleHpar[pt]*ScaleHg*Normal(&iseed);
+        x3p = ScaleHpar[pt]*ScaleHg*ath_rand_normal(seed,pid+p,2,n++);
 
       pGrid->particle[p].property = pt;
       pGrid->particle[p].x1 = x1p;
@@ -615,83 +621,6 @@ void MultiNSH(int n, Real *tstop, Real *mratio, Real etavk,
 /*------------------------------------------------------------------------------
  */
 
-#define IM1 2147483563
-#define IM2 2147483399
-#define AM (1.0/IM1)
-#define IMM1 (IM1-1)
-#define IA1 40014
-#define IA2 40692
-#define IQ1 53668
-#define IQ2 52774
-#define IR1 12211
-#define IR2 3791
-#define NTAB 32
-#define NDIV (1+IMM1/NTAB)
-#define RNMX (1.0-DBL_EPSILON)
-
-/*! \fn double ran2(long int *idum)
- *  \brief Extracted from the Numerical Recipes in C (version 2) code.  Modified
- *   to use doubles instead of floats. -- T. A. Gardiner -- Aug. 12, 2003
- *
- * Long period (> 2 x 10^{18}) random number generator of L'Ecuyer
- * with Bays-Durham shuffle and added safeguards.  Returns a uniform
- * random deviate between 0.0 and 1.0 (exclusive of the endpoint
- * values).  Call with idum = a negative integer to initialize;
- * thereafter, do not alter idum between successive deviates in a
- * sequence.  RNMX should appriximate the largest floating point value
- * that is less than 1.
- */
-
-double ran2(long int *idum)
-{
-  int j;
-  long int k;
-  static long int idum2=123456789;
-  static long int iy=0;
-  static long int iv[NTAB];
-  double temp;
-
-  if (*idum <= 0) { /* Initialize */
-    if (-(*idum) < 1) *idum=1; /* Be sure to prevent idum = 0 */
-    else *idum = -(*idum);
-    idum2=(*idum);
-    for (j=NTAB+7;j>=0;j--) { /* Load the shuffle table (after 8 warm-ups) */
-      k=(*idum)/IQ1;
-      *idum=IA1*(*idum-k*IQ1)-k*IR1;
-      if (*idum < 0) *idum += IM1;
-      if (j < NTAB) iv[j] = *idum;
-    }
-    iy=iv[0];
-  }
-  k=(*idum)/IQ1;                 /* Start here when not initializing */
-  *idum=IA1*(*idum-k*IQ1)-k*IR1; /* Compute idum=(IA1*idum) % IM1 without */
-  if (*idum < 0) *idum += IM1;   /* overflows by Schrage's method */
-  k=idum2/IQ2;
-  idum2=IA2*(idum2-k*IQ2)-k*IR2; /* Compute idum2=(IA2*idum) % IM2 likewise */
-  if (idum2 < 0) idum2 += IM2;
-  j=(int)(iy/NDIV);              /* Will be in the range 0...NTAB-1 */
-  iy=iv[j]-idum2;                /* Here idum is shuffled, idum and idum2 */
-  iv[j] = *idum;                 /* are combined to generate output */
-  if (iy < 1) iy += IMM1;
-  if ((temp=AM*iy) > RNMX) return RNMX; /* No endpoint values */
-  else return temp;
-}
-
-/*--------------------------------------------------------------------------- */
-/*! \fn double Normal(long int *idum)
- *  \brief Normal distribution random number generator */
-double Normal(long int *idum)
-{
-  double Y,X1,X2;
-
-  X1 = ran2(idum);
-  X2 = ran2(idum);
-
-  Y = sqrt(-2.0*log(X1+TINY_NUMBER))*cos(2*PI*X2);
-
-  return Y;
-}
-
 /*--------------------------------------------------------------------------- */
 /*! \fn Real Erf(Real z)
  *  \brief Error function  */
@@ -754,16 +683,3 @@ Real Erf(Real z)
   return g;
 }
 
-#undef IM1
-#undef IM2
-#undef AM
-#undef IMM1
-#undef IA1
-#undef IA2
-#undef IQ1
-#undef IQ2
-#undef IR1
-#undef IR2
-#undef NTAB
-#undef NDIV
-#undef RNMX
@@ -357,7 +357,7 @@ static Real expr_rhopardif(const GridS *pG,
 {
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
-  return pG->Coup[k][j][i].grid_d - rho0*mratio;
+  return expr_dpar(pG,i,j,k) - rho0*mratio;
 }
 
 /*----------------------------------------------------------------------------*/
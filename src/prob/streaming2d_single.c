@@ -76,6 +76,7 @@ static Real UnstratifiedDisk(const Real x1, const Real x2, const Real x3);
 static Real pert_even(Real fR, Real fI, Real x, Real z, Real t);
 static Real pert_odd(Real fR, Real fI, Real x, Real z, Real t);
 static int property_mybin(const GrainS *gr, const GrainAux *grsub);
+extern Real expr_dpar(const GridS *pG, const int i, const int j, const int k);
 extern Real expr_V1par(const GridS *pG, const int i, const int j, const int k);
 extern Real expr_V2par(const GridS *pG, const int i, const int j, const int k);
 extern Real expr_V3par(const GridS *pG, const int i, const int j, const int k);
@@ -559,7 +560,7 @@ static Real expr_rhopardif(const GridS *pG,
 {
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
-  return pG->Coup[k][j][i].grid_d - rho0*mratio;
+  return expr_dpar(pG,i,j,k) - rho0*mratio;
 }
 
 /* dVxpar */
@@ -647,8 +648,9 @@ void OutputModeAmplitude(MeshS *pM, OutputS *pOut)
   long p;
   GrainS *gr;
   Real dm,dparm,uxm,uym,uzm,wxm,wym,wzm;
+  PropFun_t allsel[1] = {property_all};
 
-  particle_to_grid(pDomain, property_all);
+  particle_moments(pDomain, 1, allsel);
 
   dm=0.0; dparm=0.0; uxm=0.0; uym=0.0; uzm=0.0; wxm=0.0; wym=0.0; wzm=0.0;
 
@@ -76,6 +76,7 @@ static Real pert_even(Real fR, Real fI, Real x, Real z, Real t);
 static Real pert_odd(Real fR, Real fI, Real x, Real z, Real t);
 static int property_mybin(const GrainS *gr, const GrainAux *grsub);
 extern Real expr_V3(const GridS *pG, const int i, const int j, const int k);
+extern Real expr_dpar(const GridS *pG, const int i, const int j, const int k);
 extern Real expr_V1par(const GridS *pG, const int i, const int j, const int k);
 extern Real expr_V2par(const GridS *pG, const int i, const int j, const int k);
 extern Real expr_V3par(const GridS *pG, const int i, const int j, const int k);
@@ -501,7 +502,7 @@ static Real expr_rhopardif(const GridS *pG, const int i, const int j, const int
 {
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
-return pG->Coup[k][j][i].grid_d - rho0*mratio;
+  return expr_dpar(pG,i,j,k) - rho0*mratio;
 }
 
 /*! \fn static Real expr_dVxpar(const GridS *pG, const int i, const int j, 
@@ -646,8 +647,9 @@ void OutputModeAmplitude(MeshS *pM, OutputS *pOut)
   FILE *fid;
   int i,j,k;
   Real dm,dparm,uxm,uym,uzm,wxm,wym,wzm;
+  PropFun_t allsel[1] = {property_all};
 
-  particle_to_grid(pDomain, property_all);
+  particle_moments(pDomain, 1, allsel);
 
   dm=0.0; dparm=0.0; uxm=0.0; uym=0.0; uzm=0.0; wxm=0.0; wym=0.0; wzm=0.0;
 
@@ -27,9 +27,15 @@ inline Real gamma2v (Real _gamma)
  *============================================================================*/
 
 static bool part_in_rank (const Real3Vect pos);
+static void inject_setup(DomainS *pDomain);
+static long inject_x1_boundary(GridS *pG, GrainS *gr, long nslot);
 
 /*------------------------ filewide global variables -------------------------*/
 char name[50];
+/* particle injection at the inner x1 boundary */
+static long inject_rate, nleft = 0;
+static unsigned long inject_seed;
+static Real inject_vel1, inject_vel2, inject_vel3, tinject = -1.0;
 
 /*=========================== PUBLIC FUNCTIONS ===============================*/
 /*----------------------------------------------------------------------------*/
@@ -84,14 +90,9 @@ void problem(DomainS *pDomain)
   Real part_vel2 = par_getd("problem", "part_vel2");
   Real part_vel3 = par_getd("problem", "part_vel3");
   int part_pos_type = par_geti("problem", "part_pos_type");
-  if (part_pos_type == 1) { // initialize rand()
-    time_t t;
-    #ifdef MPI_PARALLEL
-    srand((unsigned) myID_Comm_world * time(&t));
-    #else
-    srand((unsigned) time(&t));
-    #endif
-  }
+  /* seed of the counter-based random numbers: the random positions depend only
+   * on (seed, particle id), and so are the same for any domain decomposition */
+  unsigned long seed = (unsigned long)par_geti_def("problem","seed",0);
   #ifdef MHD
   Real bfield1 = par_getd("problem", "bfield1");
   int bfield1_type = par_geti("problem", "bfield1_type");
@@ -232,54 +233,6 @@ void problem(DomainS *pDomain)
   }
   #endif //MHD
 
-  // Generate particle positions and broadcast to all ranks
-  Real3Vect positions [npart];
-  if (part_pos_type == 1) { // random
-    #ifdef MPI_PARALLEL
-    int nproc, step, pmin, pmax;
-    // figure out how many processes there are for parallelization
-    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
-    step = (int) (npart / nproc) + 1;
-    pmin = (myID_Comm_world * step);
-    pmax = (int) fmin(npart, (myID_Comm_world+1) * step);
-    #pragma omp simd
-    for(p = pmin; p < pmax; p++) {
-      positions[p].x1 = x1min + (rand()*1./RAND_MAX) * (x1max-x1min);
-      positions[p].x2 = x2min + (rand()*1./RAND_MAX) * (x2max-x2min);
-      positions[p].x3 = x3min + (rand()*1./RAND_MAX) * (x3max-x3min);
-    }
-    // send the work from this rank to all other
-    MPI_Request request [nproc+1];
-    for (i = 0; i < nproc; i++) {
-      if (i == myID_Comm_world) continue;
-      MPI_Isend(&(positions[pmin]), 3*(pmax-pmin), MPI_DOUBLE, i, 0, MPI_COMM_WORLD, &(request[nproc]));
-    }
-    // receive from all other ranks
-    for (i = 0; i < nproc; i++) {
-      if (i == myID_Comm_world) continue;
-      pmin = (i * step);
-      pmax = (int) fmin(npart, (i+1) * step);
-      MPI_Irecv(&(positions[pmin]), 3*(pmax-pmin), MPI_DOUBLE, i, 0, MPI_COMM_WORLD, &(request[i]));
-    }
-    // wait until communication done
-    MPI_Status status;
-    for (i = 0; i < nproc; i++) {
-      if (i == myID_Comm_world) continue;
-      MPI_Wait(&(request[i]), &status);
-    }
-    /*printf("Rank %i has positions of no 5 at: %.2f %.2f\n",
-        myID_Comm_world, positions[5].x1, positions[5].x2, positions[5].x3);
-    exit(0);*/
-    #else // MPI off
-    #pragma omp simd
-    for(p = 0; p < npart; p++) {
-      positions[p].x1 = x1min + (rand()/RAND_MAX) * (x1max-x1min);
-      positions[p].x2 = x2min + (rand()/RAND_MAX) * (x2max-x2min);
-      positions[p].x3 = x3min + (rand()/RAND_MAX) * (x3max-x3min);
-    }
-    #endif
-  }
-
 	// Prepare the particles
 	tstop0[0] = par_getd_def("particle","tstop",1.0e20); // particle stopping time, sim.u.
   grproperty[0].alpha = par_getd("particle", "alpha"); /*!< charge-to-mass ratio, q/mc, see Mignone et al. (2018), eq. 18 */
@@ -289,10 +242,10 @@ void problem(DomainS *pDomain)
 	  if (part_pos_type == 0) { // a line along x1
       pos.x1 = x1min + L1 * ((0.5 + p)/(npart+1));
       pos.x2 = 0.; pos.x3 = 0.;
-	  } else if (part_pos_type == 1) { // random
-	    pos.x1 = positions[p].x1;
-      pos.x2 = positions[p].x2;
-      pos.x3 = positions[p].x3;
+	  } else if (part_pos_type == 1) { // random, one stream per coordinate
+	    pos.x1 = x1min + L1 * ath_rand_uniform(seed, p, 0, 0);
+      pos.x2 = x2min + L2 * ath_rand_uniform(seed, p, 1, 0);
+      pos.x3 = x3min + L3 * ath_rand_uniform(seed, p, 2, 0);
 	  }
 	  if (part_in_rank(pos)) { // if in this MPI rank
 	    (pGrid->nparticle)++;
@@ -331,6 +284,7 @@ void problem(DomainS *pDomain)
 	  MPI_Bcast(name,50,MPI_CHAR,0,MPI_COMM_WORLD);
 	#endif
 
+  inject_setup(pDomain);
 }
 
 /*==============================================================================
@@ -353,6 +307,7 @@ void problem_write_restart(MeshS *pM, FILE *fp)
 void problem_read_restart(MeshS *pM, FILE *fp)
 {
   fread(name, sizeof(char),50,fp);
+  inject_setup(&(pM->Domain[0][0]));
   return;
 }
 
@@ -405,3 +360,51 @@ static bool part_in_rank (const Real3Vect pos)
   return ((pos.x1<x1upar) && (pos.x1>=x1lpar) && (pos.x2<x2upar)
       && (pos.x2>=x2lpar) &&(pos.x3<x3upar) && (pos.x3>=x3lpar));
 }
+
+/*! \fn static void inject_setup(DomainS *pDomain)
+ *  \brief Enrolls the injection of inject_rate particles per time step at the
+ *   inner x1 boundary, on the grids touching it */
+static void inject_setup(DomainS *pDomain)
+{
+  GridS *pGrid = pDomain->Grid;
+
+  inject_rate = par_geti_def("problem","inject_rate",0);
+  inject_seed = (unsigned long)par_geti_def("problem","seed",0);
+  inject_vel1 = par_getd("problem","part_vel1");
+  inject_vel2 = par_getd("problem","part_vel2");
+  inject_vel3 = par_getd("problem","part_vel3");
+
+  if ((inject_rate > 0) && (pGrid->Disp[0] == pDomain->Disp[0]))
+    particle_inject_enroll(inject_x1_boundary);
+}
+
+/*! \fn static long inject_x1_boundary(GridS *pG, GrainS *gr, long nslot)
+ *  \brief Fills gr with the particles injected in this time step, placed
+ *   at random in the first cell layer of the grid in x1 */
+static long inject_x1_boundary(GridS *pG, GrainS *gr, long nslot)
+{
+  long p, n;
+
+  if (pG->time != tinject) { // a new time step
+    nleft = inject_rate;
+    tinject = pG->time;
+  }
+  n = MIN(nleft, nslot);
+
+  for (p = 0; p < n; p++) {
+    // random numbers keyed on the id set by inject_particles(), streams 3-5
+    gr[p].property = 0;
+    gr[p].x1 = pG->MinX[0] + pG->dx1
+             * ath_rand_uniform(inject_seed, gr[p].my_id, 3, 0);
+    gr[p].x2 = pG->MinX[1] + (pG->MaxX[1] - pG->MinX[1])
+             * ath_rand_uniform(inject_seed, gr[p].my_id, 4, 0);
+    gr[p].x3 = pG->MinX[2] + (pG->MaxX[2] - pG->MinX[2])
+             * ath_rand_uniform(inject_seed, gr[p].my_id, 5, 0);
+    gr[p].v1 = inject_vel1;
+    gr[p].v2 = inject_vel2;
+    gr[p].v3 = inject_vel3;
+  }
+  nleft -= n;
+
+  return n;
+}
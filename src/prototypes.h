@@ -48,6 +48,12 @@ void ath_flush_err(void);
 int ath_perr(const int level, const char *fmt, ...);
 int ath_pout(const int level, const char *fmt, ...);
 
+/*----------------------------------------------------------------------------*/
+/* ath_async.c */
+FILE *ath_async_open(const char *fname, const OutputS *pOut);
+int ath_async_close(FILE *fp);
+void ath_async_wait(void);
+
 /*----------------------------------------------------------------------------*/
 /* ath_files.c */
 char *ath_fname(const char *path, const char *basename,
@@ -70,6 +76,9 @@ void baton_stop(const int Nb, const int tag);
 void bvals_mhd_init(MeshS *pM);
 void bvals_mhd_fun(DomainS *pD, enum BCDirection dir, VGFun_t prob_bc);
 void bvals_mhd(DomainS *pDomain);
+void bvals_mhd_start(DomainS *pD);
+void bvals_mhd_finish(DomainS *pD);
+void bvals_mhd_destruct(void);
 
 /*----------------------------------------------------------------------------*/
 /* bvals_shear.c  */
@@ -128,6 +137,8 @@ Real x3cc(const GridS *pG, const int k);
 /*----------------------------------------------------------------------------*/
 /* convert_var.c */
 PrimS Cons_to_Prim(const ConsS *pU);
+void Cons_to_Prim_pencil(const int il, const int iu, const ConsS *pU,
+                         PrimS *pW, const PrimS *pWg);
 ConsS Prim_to_Cons(const PrimS *pW);
 Prim1DS Cons1D_to_Prim1D(const Cons1DS *pU, const Real *pBx);
 Cons1DS Prim1D_to_Cons1D(const Prim1DS *pW, const Real *pBx);
@@ -137,6 +148,8 @@ Real cfast(const Cons1DS *U, const Real *Bx);
 #endif
 #ifdef SPECIAL_RELATIVITY
 PrimS check_Prim(const ConsS *pU);
+void check_Prim_pencil(const int il, const int iu, const ConsS *pU,
+                       PrimS *pW, const PrimS *pWg);
 #ifdef MHD
 PrimS fix_vsq (const ConsS *pU);
 PrimS entropy_fix (const ConsS *pU, const Real *ent);
@@ -233,6 +246,13 @@ void get_eta_user(GridS *pG, int i, int j, int k,
 void dump_restart(MeshS *pM, OutputS *pout);
 void restart_grids(char *res_file, MeshS *pM);
 
+/* restart_mpiio.c  */
+#ifdef MPI_PARALLEL
+void dump_restart_mpiio(MeshS *pM, OutputS *pout);
+void restart_grids_mpiio(char *res_file, MeshS *pM);
+int  restart_file_is_mpiio(char *res_file);
+#endif
+
 /*----------------------------------------------------------------------------*/
 /* show_config.c */
 void show_config(void);
@@ -274,6 +294,13 @@ void ath_error(char *fmt, ...);
 void minmax1(Real   *data, int nx1,                   Real *dmin, Real *dmax);
 void minmax2(Real  **data, int nx2, int nx1,          Real *dmin, Real *dmax);
 void minmax3(Real ***data, int nx3, int nx2, int nx1, Real *dmin, Real *dmax);
+void ath_philox(const unsigned long seed, const unsigned long id,
+                const unsigned int stream, const unsigned int n,
+                unsigned int r[4]);
+Real ath_rand_uniform(const unsigned long seed, const unsigned long id,
+                      const unsigned int stream, const unsigned int n);
+Real ath_rand_normal(const unsigned long seed, const unsigned long id,
+                     const unsigned int stream, const unsigned int n);
 void do_nothing_bc(GridS *pG);
 Real compute_div_b(GridS *pG);
 int sign_change(Real (*func)(const Real,const Real), const Real a0, const Real b0, const Real x, Real *a, Real *b);
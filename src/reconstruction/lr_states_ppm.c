@@ -49,6 +49,9 @@
 #endif /* VL_INTEGRATOR */
 
 static Real **pW=NULL, **dWm=NULL, **Wim1h=NULL;
+#ifdef OPENMP
+#pragma omp threadprivate(pW,dWm,Wim1h)
+#endif
 
 /*----------------------------------------------------------------------------*/
 /*! \fn void lr_states(const GridS* pG, const Prim1DS W[], const Real Bxc[],
@@ -685,7 +688,7 @@ void lr_states(const GridS* pG __attribute__((unused)),
 
 void lr_states_init(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,ierr=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -709,13 +712,20 @@ void lr_states_init(MeshS *pM)
   size3 = size3 + 2*nghost;
   nmax = MAX((MAX(size1,size2)),size3);
 
-  if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) goto on_error;
+/* Each OpenMP thread allocates its own (threadprivate) work arrays */
+#ifdef OPENMP
+#pragma omp parallel reduction(+:ierr)
+#endif
+  {
+    if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) ierr++;
 
-  if ((dWm = (Real**)calloc_2d_array(nmax, (NWAVE + NSCALARS), sizeof(Real))) == NULL)
-    goto on_error;
+    if ((dWm = (Real**)calloc_2d_array(nmax, (NWAVE + NSCALARS), sizeof(Real))) == NULL)
+      ierr++;
 
-  if ((Wim1h = (Real**)calloc_2d_array(nmax, (NWAVE + NSCALARS), sizeof(Real))) == NULL)
-    goto on_error;
+    if ((Wim1h = (Real**)calloc_2d_array(nmax, (NWAVE + NSCALARS), sizeof(Real))) == NULL)
+      ierr++;
+  }
+  if (ierr > 0) goto on_error;
 
   return;
   on_error:
@@ -729,9 +739,15 @@ void lr_states_init(MeshS *pM)
 
 void lr_states_destruct(void)
 {
-  if (pW != NULL) free(pW);
-  if (dWm != NULL) free_2d_array(dWm);
-  if (Wim1h != NULL) free_2d_array(Wim1h);
+#ifdef OPENMP
+#pragma omp parallel
+#endif
+  {
+    if (pW != NULL) free(pW);
+    if (dWm != NULL) free_2d_array(dWm);
+    if (Wim1h != NULL) free_2d_array(Wim1h);
+    pW = NULL;  dWm = NULL;  Wim1h = NULL;
+  }
   return;
 }
 
@@ -20,11 +20,19 @@
  *   superceded by input from the command line, or another input file.
  *
  * MPI parallel jobs must be restarted on the same number of processors as they
- * were run originally.
+ * were run originally, unless the restart was written as a single file with
+ * MPI-IO (single_file = 1, see restart_mpiio.c), which restart_grids() hands
+ * over to restart_grids_mpiio().
  *
  * With SMR, restart files contain ALL levels and domains being updated by each
  * processor in one file, written in the default directory for the process.
  *
+ * With ASYNC_IO, dump_restart() writes into a staging buffer, which is written
+ * to disk in the background (see ath_async.c).
+ *
+ * With particles, the particle section of each Grid is written and read by
+ * dump_particle_restart() and read_particle_restart() in restart_particle.c.
+ *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - restart_grids() - reads nstep,time,dt,ConsS and B from restart file 
  * - dump_restart()  - writes a restart file
@@ -66,9 +74,6 @@ void restart_grids(char *res_file, MeshS *pM)
   int n;
   char scalarstr[16];
 #endif
-#ifdef PARTICLES
-  long p;
-#endif
 
 /* Open the restart file */
 
@@ -81,9 +86,19 @@ void restart_grids(char *res_file, MeshS *pM)
     fgets(line,MAXLEN,fp);
   }while(strncmp(line,"<par_end>",9) != 0);
 
-/* read nstep */
+/* read nstep, unless this is a single-file restart written with MPI-IO */
 
   fgets(line,MAXLEN,fp);
+  if(strncmp(line,"GLOBAL RESTART",14) == 0) {
+    fclose(fp);
+#ifdef MPI_PARALLEL
+    restart_grids_mpiio(res_file, pM);
+    return;
+#else
+    ath_error("[restart_grids]: %s was written with MPI-IO, and can only be \
+read by a MPI parallel job\n",res_file);
+#endif
+  }
   if(strncmp(line,"N_STEP",6) != 0)
     ath_error("[restart_grids]: Expected N_STEP, found %s",line);
   fread(&(pM->nstep),sizeof(int),1,fp);
@@ -331,130 +346,7 @@ void restart_grids(char *res_file, MeshS *pM)
 #ifdef PARTICLES
 /* Read particle properties and the complete particle list */
 
-      fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
-      fgets(line,MAXLEN,fp);
-      if(strncmp(line,"PARTICLE LIST",13) != 0)
-        ath_error("[restart_grids]: Expected PARTICLE LIST, found %s",line);
-      fread(&(pG->nparticle),sizeof(long),1,fp);
-
-      if (pG->nparticle > pG->arrsize-2)
-        particle_realloc(pG, pG->nparticle+2);
-
-      fread(&(npartypes),sizeof(int),1,fp);
-      for (i=0; i<npartypes; i++) {          /* particle property list */
-#ifdef FEEDBACK
-        fread(&(grproperty[i].m),sizeof(Real),1,fp);
-#endif
-        fread(&(grproperty[i].rad),sizeof(Real),1,fp);
-        fread(&(grproperty[i].rho),sizeof(Real),1,fp);
-        fread(&(tstop0[i]),sizeof(Real),1,fp);
-        fread(&(grrhoa[i]),sizeof(Real),1,fp);
-      }
-      fread(&(alamcoeff),sizeof(Real),1,fp);  /* coef to calc Reynolds number */
-
-      for (i=0; i<npartypes; i++)
-        fread(&(grproperty[i].integrator),sizeof(short),1,fp);
-
-/* Read the x1-positions */
-
-      fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
-      fgets(line,MAXLEN,fp);
-      if(strncmp(line,"PARTICLE X1",11) != 0)
-        ath_error("[restart_grids]: Expected PARTICLE X1, found %s",line);
-      for (p=0; p<pG->nparticle; p++) {
-        fread(&(pG->particle[p].x1),sizeof(Real),1,fp);
-      }
-
-/* Read the x2-positions */
-
-      fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
-      fgets(line,MAXLEN,fp);
-      if(strncmp(line,"PARTICLE X2",11) != 0)
-        ath_error("[restart_grids]: Expected PARTICLE X2, found %s",line);
-      for (p=0; p<pG->nparticle; p++) {
-        fread(&(pG->particle[p].x2),sizeof(Real),1,fp);
-      }
-
-/* Read the x3-positions */
-
-      fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
-      fgets(line,MAXLEN,fp);
-      if(strncmp(line,"PARTICLE X3",11) != 0)
-        ath_error("[restart_grids]: Expected PARTICLE X3, found %s",line);
-      for (p=0; p<pG->nparticle; p++) {
-        fread(&(pG->particle[p].x3),sizeof(Real),1,fp);
-      }
-
-/* Read the v1 velocity */
-
-      fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
-      fgets(line,MAXLEN,fp);
-      if(strncmp(line,"PARTICLE V1",11) != 0)
-        ath_error("[restart_grids]: Expected PARTICLE V1, found %s",line);
-      for (p=0; p<pG->nparticle; p++) {
-        fread(&(pG->particle[p].v1),sizeof(Real),1,fp);
-      }
-
-/* Read the v2 velocity */
-
-      fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
-      fgets(line,MAXLEN,fp);
-      if(strncmp(line,"PARTICLE V2",11) != 0)
-        ath_error("[restart_grids]: Expected PARTICLE V2, found %s",line);
-      for (p=0; p<pG->nparticle; p++) {
-        fread(&(pG->particle[p].v2),sizeof(Real),1,fp);
-      }
-
-/* Read the v3 velocity */
-
-      fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
-      fgets(line,MAXLEN,fp);
-      if(strncmp(line,"PARTICLE V3",11) != 0)
-        ath_error("[restart_grids]: Expected PARTICLE V3, found %s",line);
-      for (p=0; p<pG->nparticle; p++) {
-        fread(&(pG->particle[p].v3),sizeof(Real),1,fp);
-      }
-
-/* Read particle properties */
-
-      fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
-      fgets(line,MAXLEN,fp);
-      if(strncmp(line,"PARTICLE PROPERTY",17) != 0)
-        ath_error("[restart_grids]: Expected PARTICLE PROPERTY, found %s",line);
-      for (p=0; p<pG->nparticle; p++) {
-        fread(&(pG->particle[p].property),sizeof(int),1,fp);
-        pG->particle[p].pos = 1;	/* grid particle */
-      }
-
-/* Read particle my_id */
-
-      fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
-      fgets(line,MAXLEN,fp);
-      if(strncmp(line,"PARTICLE MY_ID",14) != 0)
-        ath_error("[restart_grids]: Expected PARTICLE MY_ID, found %s",line);
-      for (p=0; p<pG->nparticle; p++) {
-        fread(&(pG->particle[p].my_id),sizeof(long),1,fp);
-      }
-
-#ifdef MPI_PARALLEL
-/* Read particle init_id */
-
-      fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
-      fgets(line,MAXLEN,fp);
-      if(strncmp(line,"PARTICLE INIT_ID",16) != 0)
-        ath_error("[restart_grids]: Expected PARTICLE INIT_ID, found %s",line);
-      for (p=0; p<pG->nparticle; p++) {
-        fread(&(pG->particle[p].init_id),sizeof(int),1,fp);
-      }
-#endif
-
-/* count the number of particles with different types */
-
-      for (i=0; i<npartypes; i++)
-        grproperty[i].num = 0;
-      for (p=0; p<pG->nparticle; p++)
-        grproperty[pG->particle[p].property].num += 1;
-
+      read_particle_restart(pG, fp);
 #endif /* PARTICLES */
 
     }
@@ -489,12 +381,6 @@ void dump_restart(MeshS *pM, OutputS *pout)
 #endif
 #if (NSCALARS > 0)
   int n;
-#endif
-#ifdef PARTICLES
-  int nprop, *ibuf = NULL, ibufsize, lbufsize, sbufsize, nibuf, nlbuf, nsbuf;
-  long np, p, *lbuf = NULL;
-  short *sbuf = NULL;
-  nibuf = 0;	nsbuf = 0;	nlbuf = 0;
 #endif
   int bufsize, nbuf = 0;
   Real *buf = NULL;
@@ -505,23 +391,6 @@ void dump_restart(MeshS *pM, OutputS *pout)
     ath_perr(-1,"[dump_restart]: Error allocating memory for buffer\n");
     return;  /* Right now, we just don't write instead of aborting completely */
   }
-#ifdef PARTICLES
-  ibufsize = 262144 / sizeof(int);  /* 256 KB worth of ints */
-  if ((ibuf = (int*)calloc_1d_array(ibufsize, sizeof(int))) == NULL) {
-    ath_perr(-1,"[dump_restart]: Error allocating memory for buffer\n");
-    return;  /* Right now, we just don't write instead of aborting completely */
-  }
-  lbufsize = 262144 / sizeof(long);  /* 256 KB worth of longs */
-  if ((lbuf = (long*)calloc_1d_array(lbufsize, sizeof(long))) == NULL) {
-    ath_perr(-1,"[dump_restart]: Error allocating memory for buffer\n");
-    return;  /* Right now, we just don't write instead of aborting completely */
-  }
-  sbufsize = 262144 / sizeof(short);  /* 256 KB worth of longs */
-  if ((sbuf = (short*)calloc_1d_array(sbufsize, sizeof(short))) == NULL) {
-    ath_perr(-1,"[dump_restart]: Error allocating memory for buffer\n");
-    return;  /* Right now, we just don't write instead of aborting completely */
-  }
-#endif
 
 /* Create filename and Open the output file */
 
@@ -530,7 +399,7 @@ void dump_restart(MeshS *pM, OutputS *pout)
     ath_error("[dump_restart]: Error constructing filename\n");
   }
 
-  if((fp = fopen(fname,"wb")) == NULL){
+  if((fp = ath_async_open(fname,pout)) == NULL){
     ath_error("[dump_restart]: Unable to open restart file\n");
     return;
   }
@@ -770,198 +639,9 @@ void dump_restart(MeshS *pM, OutputS *pout)
 #endif
 
 #ifdef PARTICLES
-/* Write out the number of particles */
+/* Write out particle properties and the complete particle list */
 
-      fprintf(fp,"\nPARTICLE LIST\n");
-      np = 0;
-      for (p=0; p<pG->nparticle; p++)
-        if (pG->particle[p].pos == 1) np += 1;
-      fwrite(&(np),sizeof(long),1,fp);
-    
-/* Write out the particle properties */
-    
-#ifdef FEEDBACK
-      nprop = 5;
-#else
-      nprop = 4;
-#endif
-      fwrite(&(npartypes),sizeof(int),1,fp); /* number of particle types */
-      for (i=0; i<npartypes; i++) {          /* particle property list */
-#ifdef FEEDBACK
-        buf[nbuf++] = grproperty[i].m;
-#endif
-        buf[nbuf++] = grproperty[i].rad;
-        buf[nbuf++] = grproperty[i].rho;
-        buf[nbuf++] = tstop0[i];
-        buf[nbuf++] = grrhoa[i];
-        if ((nbuf+nprop) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
-          nbuf = 0;
-        }
-      }
-      if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
-        nbuf = 0;
-      }
-      fwrite(&(alamcoeff),sizeof(Real),1,fp);  /* coef for Reynolds number */
-    
-      for (i=0; i<npartypes; i++) {         /* particle integrator type */
-        sbuf[nsbuf++] = grproperty[i].integrator;
-        if ((nsbuf+1) > sbufsize) {
-          fwrite(sbuf,sizeof(short),nsbuf,fp);
-          nsbuf = 0;
-        }
-      }
-      if (nsbuf > 0) {
-        fwrite(sbuf,sizeof(short),nsbuf,fp);
-        nsbuf = 0;
-      }
-    
-/* Write x1 */
-    
-      fprintf(fp,"\nPARTICLE X1\n");
-      for (p=0;p<pG->nparticle;p++)
-      if (pG->particle[p].pos == 1){
-        buf[nbuf++] = pG->particle[p].x1;
-        if ((nbuf+1) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
-          nbuf = 0;
-        }
-      }
-      if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
-        nbuf = 0;
-      }
-    
-/* Write x2 */
-    
-      fprintf(fp,"\nPARTICLE X2\n");
-      for (p=0;p<pG->nparticle;p++)
-      if (pG->particle[p].pos == 1){
-        buf[nbuf++] = pG->particle[p].x2;
-        if ((nbuf+1) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
-          nbuf = 0;
-        }
-      }
-      if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
-        nbuf = 0;
-      }
-    
-/* Write x3 */
-    
-      fprintf(fp,"\nPARTICLE X3\n");
-      for (p=0;p<pG->nparticle;p++)
-      if (pG->particle[p].pos == 1){
-        buf[nbuf++] = pG->particle[p].x3;
-        if ((nbuf+1) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
-          nbuf = 0;
-        }
-      }
-      if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
-        nbuf = 0;
-      }
-    
-/* Write v1 */
-    
-      fprintf(fp,"\nPARTICLE V1\n");
-      for (p=0;p<pG->nparticle;p++)
-      if (pG->particle[p].pos == 1){
-        buf[nbuf++] = pG->particle[p].v1;
-        if ((nbuf+1) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
-          nbuf = 0;
-        }
-      }
-      if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
-        nbuf = 0;
-      }
-    
-/* Write v2 */
-    
-      fprintf(fp,"\nPARTICLE V2\n");
-      for (p=0;p<pG->nparticle;p++)
-      if (pG->particle[p].pos == 1){
-        buf[nbuf++] = pG->particle[p].v2;
-        if ((nbuf+1) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
-          nbuf = 0;
-        }
-      }
-      if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
-        nbuf = 0;
-      }
-    
-/* Write v3 */
-    
-      fprintf(fp,"\nPARTICLE V3\n");
-      for (p=0;p<pG->nparticle;p++)
-      if (pG->particle[p].pos == 1){
-        buf[nbuf++] = pG->particle[p].v3;
-        if ((nbuf+1) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
-          nbuf = 0;
-        }
-      }
-      if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
-        nbuf = 0;
-      }
-    
-/* Write properties */
-    
-      fprintf(fp,"\nPARTICLE PROPERTY\n");
-      for (p=0;p<pG->nparticle;p++)
-      if (pG->particle[p].pos == 1){
-        ibuf[nibuf++] = pG->particle[p].property;
-        if ((nibuf+1) > ibufsize) {
-          fwrite(ibuf,sizeof(int),nibuf,fp);
-          nibuf = 0;
-        }
-      }
-      if (nibuf > 0) {
-        fwrite(ibuf,sizeof(int),nibuf,fp);
-        nibuf = 0;
-      }
-    
-/* Write my_id */
-    
-      fprintf(fp,"\nPARTICLE MY_ID\n");
-      for (p=0;p<pG->nparticle;p++)
-      if (pG->particle[p].pos == 1){
-        lbuf[nlbuf++] = pG->particle[p].my_id;
-        if ((nlbuf+1) > lbufsize) {
-          fwrite(lbuf,sizeof(long),nlbuf,fp);
-          nlbuf = 0;
-        }
-      }
-      if (nlbuf > 0) {
-        fwrite(lbuf,sizeof(long),nlbuf,fp);
-        nlbuf = 0;
-      }
-    
-#ifdef MPI_PARALLEL
-/* Write init_id */
-    
-      fprintf(fp,"\nPARTICLE INIT_ID\n");
-      for (p=0;p<pG->nparticle;p++)
-      if (pG->particle[p].pos == 1){
-        ibuf[nibuf++] = pG->particle[p].init_id;
-        if ((nibuf+1) > ibufsize) {
-          fwrite(ibuf,sizeof(int),nibuf,fp);
-          nibuf = 0;
-        }
-      }
-      if (nibuf > 0) {
-        fwrite(ibuf,sizeof(int),nibuf,fp);
-        nibuf = 0;
-      }
-#endif
+      dump_particle_restart(pG, fp);
 #endif /*PARTICLES*/
 
     }
@@ -972,7 +652,7 @@ void dump_restart(MeshS *pM, OutputS *pout)
   fprintf(fp,"\nUSER_DATA\n");
   problem_write_restart(pM, fp);
 
-  fclose(fp);
+  ath_async_close(fp);
 
   free_1d_array(buf);
 
@@ -0,0 +1,598 @@
+#include "copyright.h"
+/*============================================================================*/
+/*! \file restart_mpiio.c
+ *  \brief Functions for writing and reading single-file restarts with MPI-IO,
+ *   which can be read with any domain decomposition.
+ *
+ * PURPOSE: Functions for writing and reading single-file restarts with MPI-IO.
+ *   The per-processor restart files of restart.c can only be read with the
+ *   same decomposition (NGrid_x1/x2/x3) that wrote them.  With single_file = 1
+ *   in the <outputN> block with out_fmt = rst, all processors instead write
+ *   one file <basename>.<num>.rst in the run directory, which stores every
+ *   array of every Domain in global index order.  Each processor writes (and
+ *   on restart reads) its hyperslab at the global cell offset of its Grid with
+ *   one collective call per array, using an MPI subarray file view.  The
+ *   particles are redistributed according to the bounds of the new Grids
+ *   (see read_particle_restart_mpiio()).
+ *
+ *   The decomposition may thus be changed on restart, e.g. with
+ *   -r run.0010.rst domain1/NGrid_x1=8 on the command line.
+ *
+ *   File layout (native endianness):
+ *   - the parameter file, ending with <par_end>, and the line "GLOBAL RESTART"
+ *   - int version, int sizeof(Real), int nstep, Real time, Real dt,
+ *     [Real diff_dt, int N_STS, Real nu_STS with STS]
+ *   - for each Domain: int Nx[3], followed by the global arrays d, M1, M2, M3,
+ *     [E], [B1i, B2i, B3i with MHD], [s[n]], each of size Nx[2]*Nx[1]*Nx[0],
+ *     except that the face-centered fields have one more face in their
+ *     direction if there is more than one cell in it, and [the particles]
+ *   - "\nUSER_DATA\n" followed by the problem-specific data of the root
+ *     processor, which is read by all processors.
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - dump_restart_mpiio()    - writes a single-file restart
+ * - restart_grids_mpiio()   - reads a single-file restart
+ * - restart_file_is_mpiio() - checks whether a restart file is a single file
+ *
+ * PRIVATE FUNCTION PROTOTYPES:
+ * - rst_nvar()     - number of arrays per Domain
+ * - get_var()      - value of array var in cell (k,j,i)
+ * - set_var()      - sets the value of array var in cell (k,j,i)
+ * - array_slab()   - global size, and local size and start of array var
+ * - write_array()  - writes array var of a Domain collectively
+ * - read_array()   - reads array var of a Domain collectively
+ * - set_cc_fields() - sets the cell-centered fields from the interface fields*/
+/*============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "defs.h"
+#include "athena.h"
+#include "globals.h"
+#include "prototypes.h"
+#include "particles/particle.h"
+
+#ifdef MPI_PARALLEL /* endif at the end of the file */
+
+#define RESTART_MPIIO_VERSION 1
+
+/* arrays of each Domain, in file order; the scalars follow RST_S0 */
+enum RstVar {RST_D, RST_M1, RST_M2, RST_M3, RST_E, RST_B1, RST_B2, RST_B3,
+             RST_S0};
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   rst_nvar()     - number of arrays per Domain
+ *   is_stored()    - is array var stored in this configuration?
+ *   get_var()      - value of array var in cell (k,j,i)
+ *   set_var()      - sets the value of array var in cell (k,j,i)
+ *   array_slab()   - global size, and local size and start of array var
+ *   write_array()  - writes array var of a Domain collectively
+ *   read_array()   - reads array var of a Domain collectively
+ *   set_cc_fields() - sets the cell-centered fields from the interface fields
+ *============================================================================*/
+static int rst_nvar(void);
+static int is_stored(int var);
+static Real get_var(GridS *pG, int var, int k, int j, int i);
+static void set_var(GridS *pG, int var, int k, int j, int i, Real val);
+static void array_slab(DomainS *pD, int var, int rd, int gsize[3],
+                       int lsize[3], int start[3]);
+static void write_array(DomainS *pD, int var, MPI_File fh, MPI_Offset *base,
+                        Real *buf);
+static void read_array(DomainS *pD, int var, MPI_File fh, MPI_Offset *base,
+                       Real *buf);
+#ifdef MHD
+static void set_cc_fields(GridS *pG);
+#endif
+
+/*============================================================================*/
+/*----------------------------- Public Functions -----------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void dump_restart_mpiio(MeshS *pM, OutputS *pout)
+ *  \brief Writes a single-file restart, including problem-specific data of
+ *   the root processor from a user defined function */
+void dump_restart_mpiio(MeshS *pM, OutputS *pout)
+{
+  DomainS *pD;
+  GridS *pG;
+  MPI_File fh;
+  MPI_Status stat;
+  MPI_Offset base;
+  FILE *fp;
+  char *fname, name[MAXLEN];
+  int nl, nd, var, err, hdr[3];
+  long bufsize = 1;
+  Real *buf;
+
+/* The root process constructs the filename, and writes the current state of
+ * the parameter file (the other processes have a different outfilename) */
+
+  if (myID_Comm_world == 0) {
+    if((fname = ath_fname("../",pM->outfilename,NULL,NULL,num_digit,
+        pout->num,NULL,"rst")) == NULL)
+      ath_error("[dump_restart_mpiio]: Error constructing filename\n");
+    strncpy(name, fname, MAXLEN-1);
+    name[MAXLEN-1] = '\0';
+    free(fname);
+
+    if((fp = fopen(name,"wb")) == NULL)
+      ath_error("[dump_restart_mpiio]: Unable to open restart file\n");
+
+    par_setd("time","time","%e",pM->time,"Current Simulation Time");
+    par_seti("time","nstep","%d",pM->nstep,"Current Simulation Time Step");
+    par_dump(2,fp);
+    fprintf(fp,"GLOBAL RESTART\n");
+    base = (MPI_Offset)ftell(fp);
+    fclose(fp);
+  }
+  err = MPI_Bcast(name, MAXLEN, MPI_CHAR, 0, MPI_COMM_WORLD);
+  if (err) ath_error("[dump_restart_mpiio]: MPI_Bcast error = %d\n",err);
+  err = MPI_Bcast(&base, sizeof(MPI_Offset), MPI_BYTE, 0, MPI_COMM_WORLD);
+  if (err) ath_error("[dump_restart_mpiio]: MPI_Bcast error = %d\n",err);
+
+  err = MPI_File_open(MPI_COMM_WORLD, name, MPI_MODE_WRONLY, MPI_INFO_NULL,
+                      &fh);
+  if (err) ath_error("[dump_restart_mpiio]: Unable to open %s\n",name);
+
+/* The root process writes the step number, time and time step */
+
+  if (myID_Comm_world == 0) {
+    hdr[0] = RESTART_MPIIO_VERSION;
+    hdr[1] = (int)sizeof(Real);
+    hdr[2] = pM->nstep;
+    MPI_File_write_at(fh, base, hdr, 3, MPI_INT, &stat);
+    MPI_File_write_at(fh, base+3*sizeof(int), &(pM->time), sizeof(Real),
+                      MPI_BYTE, &stat);
+    MPI_File_write_at(fh, base+3*sizeof(int)+sizeof(Real), &(pM->dt),
+                      sizeof(Real), MPI_BYTE, &stat);
+#ifdef STS
+    MPI_File_write_at(fh, base+3*sizeof(int)+2*sizeof(Real), &(pM->diff_dt),
+                      sizeof(Real), MPI_BYTE, &stat);
+    MPI_File_write_at(fh, base+3*sizeof(int)+3*sizeof(Real), &N_STS,
+                      1, MPI_INT, &stat);
+    MPI_File_write_at(fh, base+4*sizeof(int)+3*sizeof(Real), &nu_STS,
+                      sizeof(Real), MPI_BYTE, &stat);
+#endif
+  }
+  base += 3*sizeof(int) + 2*sizeof(Real);
+#ifdef STS
+  base += sizeof(int) + 2*sizeof(Real);
+#endif
+
+/* Now loop over all Domains, also those without a Grid on this processor,
+ * since the writes are collective */
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = &(pM->Domain[nl][nd]);
+      pG = pD->Grid;
+
+      if (myID_Comm_world == 0)
+        MPI_File_write_at(fh, base, pD->Nx, 3, MPI_INT, &stat);
+      base += 3*sizeof(int);
+
+      if (pG != NULL)
+        bufsize = (long)(pG->Nx[0]+1)*(pG->Nx[1]+1)*(pG->Nx[2]+1);
+      if ((buf = (Real*)calloc_1d_array(bufsize, sizeof(Real))) == NULL)
+        ath_error("[dump_restart_mpiio]: Error allocating memory\n");
+
+      for (var=0; var<rst_nvar(); var++)
+        if (is_stored(var)) write_array(pD, var, fh, &base, buf);
+
+      free_1d_array(buf);
+
+#ifdef PARTICLES
+      dump_particle_restart_mpiio(pD, fh, &base);
+#endif
+    }
+  }
+
+  MPI_File_close(&fh);
+
+/* The root process appends its problem-specific data */
+
+  if (myID_Comm_world == 0) {
+    if((fp = fopen(name,"r+b")) == NULL)
+      ath_error("[dump_restart_mpiio]: Unable to open restart file\n");
+    fseek(fp, (long)base, SEEK_SET);
+    fprintf(fp,"\nUSER_DATA\n");
+    problem_write_restart(pM, fp);
+    fclose(fp);
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void restart_grids_mpiio(char *res_file, MeshS *pM)
+ *  \brief Reads nstep, time, dt, the arrays of all Grids on this processor
+ *   and the particles inside them from a single-file restart.  Called by
+ *   restart_grids() on all processors. */
+void restart_grids_mpiio(char *res_file, MeshS *pM)
+{
+  DomainS *pD;
+  GridS *pG;
+  MPI_File fh;
+  MPI_Status stat;
+  MPI_Offset base;
+  FILE *fp;
+  char line[MAXLEN];
+  int nl, nd, var, err, hdr[3], nx[3];
+  long bufsize = 1;
+  Real *buf;
+
+/* Find the start of the binary data after the parameter file */
+
+  if((fp = fopen(res_file,"rb")) == NULL)
+    ath_error("[restart_grids_mpiio]: Error opening the restart file %s\n",
+              res_file);
+  do{
+    if (fgets(line,MAXLEN,fp) == NULL)
+      ath_error("[restart_grids_mpiio]: No <par_end> in %s\n",res_file);
+  }while(strncmp(line,"<par_end>",9) != 0);
+  fgets(line,MAXLEN,fp);
+  if(strncmp(line,"GLOBAL RESTART",14) != 0)
+    ath_error("[restart_grids_mpiio]: Expected GLOBAL RESTART, found %s",line);
+  base = (MPI_Offset)ftell(fp);
+  fclose(fp);
+
+  err = MPI_File_open(MPI_COMM_WORLD, res_file, MPI_MODE_RDONLY,
+                      MPI_INFO_NULL, &fh);
+  if (err) ath_error("[restart_grids_mpiio]: Unable to open %s\n",res_file);
+
+/* read nstep, time and dt */
+
+  MPI_File_read_at_all(fh, base, hdr, 3, MPI_INT, &stat);
+  if (hdr[0] != RESTART_MPIIO_VERSION)
+    ath_error("[restart_grids_mpiio]: Unsupported version %d\n",hdr[0]);
+  if (hdr[1] != (int)sizeof(Real))
+    ath_error("[restart_grids_mpiio]: Written with sizeof(Real)=%d\n",hdr[1]);
+  pM->nstep = hdr[2];
+  base += 3*sizeof(int);
+  MPI_File_read_at_all(fh, base, &(pM->time), sizeof(Real), MPI_BYTE, &stat);
+  base += sizeof(Real);
+  MPI_File_read_at_all(fh, base, &(pM->dt), sizeof(Real), MPI_BYTE, &stat);
+  base += sizeof(Real);
+#ifdef STS
+  MPI_File_read_at_all(fh, base, &(pM->diff_dt), sizeof(Real), MPI_BYTE,
+                       &stat);
+  base += sizeof(Real);
+  MPI_File_read_at_all(fh, base, &N_STS, 1, MPI_INT, &stat);
+  base += sizeof(int);
+  MPI_File_read_at_all(fh, base, &nu_STS, sizeof(Real), MPI_BYTE, &stat);
+  base += sizeof(Real);
+#endif
+
+/* Now loop over all Domains, also those without a Grid on this processor,
+ * since the reads are collective */
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = &(pM->Domain[nl][nd]);
+      pG = pD->Grid;
+
+      MPI_File_read_at_all(fh, base, nx, 3, MPI_INT, &stat);
+      if ((nx[0] != pD->Nx[0]) || (nx[1] != pD->Nx[1]) || (nx[2] != pD->Nx[2]))
+        ath_error("[restart_grids_mpiio]: Domain %d on level %d has %dx%dx%d \
+cells in the restart file, but %dx%dx%d now\n",nd,nl,nx[0],nx[1],nx[2],
+                  pD->Nx[0],pD->Nx[1],pD->Nx[2]);
+      base += 3*sizeof(int);
+
+      if (pG != NULL) {
+        pG->time = pM->time;
+        pG->dt   = pM->dt;
+        bufsize = (long)(pG->Nx[0]+1)*(pG->Nx[1]+1)*(pG->Nx[2]+1);
+      }
+      if ((buf = (Real*)calloc_1d_array(bufsize, sizeof(Real))) == NULL)
+        ath_error("[restart_grids_mpiio]: Error allocating memory\n");
+
+      for (var=0; var<rst_nvar(); var++)
+        if (is_stored(var)) read_array(pD, var, fh, &base, buf);
+
+      free_1d_array(buf);
+
+#ifdef MHD
+      if (pG != NULL) set_cc_fields(pG);
+#endif
+
+#ifdef PARTICLES
+      read_particle_restart_mpiio(pD, fh, &base);
+#endif
+    }
+  }
+
+  MPI_File_close(&fh);
+
+/* Call a user function to read the problem-specific data */
+
+  if((fp = fopen(res_file,"rb")) == NULL)
+    ath_error("[restart_grids_mpiio]: Error opening the restart file %s\n",
+              res_file);
+  fseek(fp, (long)base, SEEK_SET);
+  fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
+  fgets(line,MAXLEN,fp);
+  if(strncmp(line,"USER_DATA",9) != 0)
+    ath_error("[restart_grids_mpiio]: Expected USER_DATA, found %s",line);
+  problem_read_restart(pM, fp);
+  fclose(fp);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn int restart_file_is_mpiio(char *res_file)
+ *  \brief Returns 1 if res_file is a single-file restart, 0 otherwise.
+ *   Called by the root process in main() before the restart filename is
+ *   shared with the children. */
+int restart_file_is_mpiio(char *res_file)
+{
+  FILE *fp;
+  char line[MAXLEN];
+  int ret = 0;
+
+  if((fp = fopen(res_file,"r")) == NULL) return 0;
+  do{
+    if (fgets(line,MAXLEN,fp) == NULL) {
+      fclose(fp);
+      return 0;
+    }
+  }while(strncmp(line,"<par_end>",9) != 0);
+  if ((fgets(line,MAXLEN,fp) != NULL) &&
+      (strncmp(line,"GLOBAL RESTART",14) == 0))
+    ret = 1;
+  fclose(fp);
+
+  return ret;
+}
+
+/*============================================================================*/
+/*----------------------------- Private Functions ----------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int rst_nvar(void)
+ *  \brief Number of arrays per Domain, including those not stored */
+static int rst_nvar(void)
+{
+  return RST_S0 + NSCALARS;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int is_stored(int var)
+ *  \brief Returns 1 if array var is stored with this configuration */
+static int is_stored(int var)
+{
+#ifdef BAROTROPIC
+  if (var == RST_E) return 0;
+#endif
+#ifndef MHD
+  if ((var == RST_B1) || (var == RST_B2) || (var == RST_B3)) return 0;
+#endif
+  return 1;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real get_var(GridS *pG, int var, int k, int j, int i)
+ *  \brief Value of array var in cell (k,j,i) */
+static Real get_var(GridS *pG, int var, int k, int j, int i)
+{
+  switch (var) {
+  case RST_D:  return pG->U[k][j][i].d;
+  case RST_M1: return pG->U[k][j][i].M1;
+  case RST_M2: return pG->U[k][j][i].M2;
+  case RST_M3: return pG->U[k][j][i].M3;
+#ifndef BAROTROPIC
+  case RST_E:  return pG->U[k][j][i].E;
+#endif
+#ifdef MHD
+  case RST_B1: return pG->B1i[k][j][i];
+  case RST_B2: return pG->B2i[k][j][i];
+  case RST_B3: return pG->B3i[k][j][i];
+#endif
+  default:
+#if (NSCALARS > 0)
+    if (var >= RST_S0) return pG->U[k][j][i].s[var-RST_S0];
+#endif
+    break;
+  }
+
+  return 0.0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void set_var(GridS *pG, int var, int k, int j, int i, Real val)
+ *  \brief Sets the value of array var in cell (k,j,i) */
+static void set_var(GridS *pG, int var, int k, int j, int i, Real val)
+{
+  switch (var) {
+  case RST_D:  pG->U[k][j][i].d  = val;  break;
+  case RST_M1: pG->U[k][j][i].M1 = val;  break;
+  case RST_M2: pG->U[k][j][i].M2 = val;  break;
+  case RST_M3: pG->U[k][j][i].M3 = val;  break;
+#ifndef BAROTROPIC
+  case RST_E:  pG->U[k][j][i].E  = val;  break;
+#endif
+#ifdef MHD
+  case RST_B1: pG->B1i[k][j][i] = val;  break;
+  case RST_B2: pG->B2i[k][j][i] = val;  break;
+  case RST_B3: pG->B3i[k][j][i] = val;  break;
+#endif
+  default:
+#if (NSCALARS > 0)
+    if (var >= RST_S0) pG->U[k][j][i].s[var-RST_S0] = val;
+#endif
+    break;
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void array_slab(DomainS *pD, int var, int rd, int gsize[3],
+ *                             int lsize[3], int start[3])
+ *  \brief Global size of array var of Domain pD, and the size and start of the
+ *   part of the Grid on this processor, in (k,j,i) order.
+ *
+ *   Face-centered fields have one more face than cells in their direction if
+ *   there is more than one cell.  The last face of a Grid is shared with its
+ *   neighbour, so it is only written by the last Grid, but always read
+ *   (rd = 1). */
+static void array_slab(DomainS *pD, int var, int rd, int gsize[3],
+                       int lsize[3], int start[3])
+{
+  GridS *pG = pD->Grid;
+  int n, dir = -1;
+
+  if (var == RST_B1) dir = 0;
+  if (var == RST_B2) dir = 1;
+  if (var == RST_B3) dir = 2;
+
+  for (n=0; n<3; n++) {
+    gsize[2-n] = pD->Nx[n];
+    lsize[2-n] = pG->Nx[n];
+    start[2-n] = pG->Disp[n] - pD->Disp[n];
+    if ((n == dir) && (pD->Nx[n] > 1)) {
+      gsize[2-n] += 1;
+      if (rd || (start[2-n] + pG->Nx[n] == pD->Nx[n])) lsize[2-n] += 1;
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void write_array(DomainS *pD, int var, MPI_File fh,
+ *                              MPI_Offset *base, Real *buf)
+ *  \brief Writes array var of Domain pD at offset *base with one collective
+ *   call, and advances *base past it */
+static void write_array(DomainS *pD, int var, MPI_File fh, MPI_Offset *base,
+                        Real *buf)
+{
+  GridS *pG = pD->Grid;
+  MPI_Datatype ftype;
+  MPI_Status stat;
+  int i, j, k, n, gsize[3], lsize[3], start[3];
+
+  if (pG != NULL) {
+    array_slab(pD, var, 0, gsize, lsize, start);
+    n = 0;
+    for (k=pG->ks; k<pG->ks+lsize[0]; k++)
+      for (j=pG->js; j<pG->js+lsize[1]; j++)
+        for (i=pG->is; i<pG->is+lsize[2]; i++)
+          buf[n++] = get_var(pG, var, k, j, i);
+
+    MPI_Type_create_subarray(3, gsize, lsize, start, MPI_ORDER_C, MPI_DOUBLE,
+                             &ftype);
+    MPI_Type_commit(&ftype);
+    MPI_File_set_view(fh, *base, MPI_DOUBLE, ftype, "native", MPI_INFO_NULL);
+    MPI_File_write_all(fh, buf, n, MPI_DOUBLE, &stat);
+    MPI_Type_free(&ftype);
+  } else {
+    MPI_File_set_view(fh, *base, MPI_DOUBLE, MPI_DOUBLE, "native",
+                      MPI_INFO_NULL);
+    MPI_File_write_all(fh, buf, 0, MPI_DOUBLE, &stat);
+  }
+  MPI_File_set_view(fh, 0, MPI_BYTE, MPI_BYTE, "native", MPI_INFO_NULL);
+
+/* all processors need the global size, also those without a Grid */
+
+  gsize[0] = pD->Nx[2];  gsize[1] = pD->Nx[1];  gsize[2] = pD->Nx[0];
+  if ((var == RST_B1) && (pD->Nx[0] > 1)) gsize[2] += 1;
+  if ((var == RST_B2) && (pD->Nx[1] > 1)) gsize[1] += 1;
+  if ((var == RST_B3) && (pD->Nx[2] > 1)) gsize[0] += 1;
+  *base += (MPI_Offset)gsize[0]*gsize[1]*gsize[2]*sizeof(Real);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void read_array(DomainS *pD, int var, MPI_File fh,
+ *                             MPI_Offset *base, Real *buf)
+ *  \brief Reads array var of Domain pD at offset *base with one collective
+ *   call, and advances *base past it */
+static void read_array(DomainS *pD, int var, MPI_File fh, MPI_Offset *base,
+                       Real *buf)
+{
+  GridS *pG = pD->Grid;
+  MPI_Datatype ftype;
+  MPI_Status stat;
+  int i, j, k, n, gsize[3], lsize[3], start[3];
+
+  if (pG != NULL) {
+    array_slab(pD, var, 1, gsize, lsize, start);
+    MPI_Type_create_subarray(3, gsize, lsize, start, MPI_ORDER_C, MPI_DOUBLE,
+                             &ftype);
+    MPI_Type_commit(&ftype);
+    MPI_File_set_view(fh, *base, MPI_DOUBLE, ftype, "native", MPI_INFO_NULL);
+    MPI_File_read_all(fh, buf, lsize[0]*lsize[1]*lsize[2], MPI_DOUBLE, &stat);
+    MPI_Type_free(&ftype);
+
+    n = 0;
+    for (k=pG->ks; k<pG->ks+lsize[0]; k++)
+      for (j=pG->js; j<pG->js+lsize[1]; j++)
+        for (i=pG->is; i<pG->is+lsize[2]; i++)
+          set_var(pG, var, k, j, i, buf[n++]);
+  } else {
+    MPI_File_set_view(fh, *base, MPI_DOUBLE, MPI_DOUBLE, "native",
+                      MPI_INFO_NULL);
+    MPI_File_read_all(fh, buf, 0, MPI_DOUBLE, &stat);
+  }
+  MPI_File_set_view(fh, 0, MPI_BYTE, MPI_BYTE, "native", MPI_INFO_NULL);
+
+  gsize[0] = pD->Nx[2];  gsize[1] = pD->Nx[1];  gsize[2] = pD->Nx[0];
+  if ((var == RST_B1) && (pD->Nx[0] > 1)) gsize[2] += 1;
+  if ((var == RST_B2) && (pD->Nx[1] > 1)) gsize[1] += 1;
+  if ((var == RST_B3) && (pD->Nx[2] > 1)) gsize[0] += 1;
+  *base += (MPI_Offset)gsize[0]*gsize[1]*gsize[2]*sizeof(Real);
+
+  return;
+}
+
+#ifdef MHD
+/*----------------------------------------------------------------------------*/
+/*! \fn static void set_cc_fields(GridS *pG)
+ *  \brief Initializes the cell center magnetic fields as either the average
+ *   of the face centered field if there is more than one cell in that
+ *   dimension, or just the face centered field if not (as in restart_grids) */
+static void set_cc_fields(GridS *pG)
+{
+  int i, j, k;
+
+  for (k=pG->ks; k<=pG->ke; k++) {
+  for (j=pG->js; j<=pG->je; j++) {
+  for (i=pG->is; i<=pG->ie; i++) {
+    if (pG->ie > pG->is) {
+#if defined(CARTESIAN)
+      pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
+#elif defined(CYLINDRICAL)
+      pG->U[k][j][i].B1c = 0.5*(pG->ri[i]*pG->B1i[k][j][i] + pG->ri[i+1]*pG->B1i[k][j][i+1])/pG->r[i];
+#elif defined(SPHERICAL)
+      pG->U[k][j][i].B1c = ((pG->px1i[i+1]-pG->px1v[i])*pG->B1i[k][j][i] + (pG->px1v[i]-pG->px1i[i])*pG->B1i[k][j][i+1])/pG->dx1;
+#endif
+    } else {
+      pG->U[k][j][i].B1c = pG->B1i[k][j][i];
+    }
+    if (pG->je > pG->js) {
+#ifdef SPHERICAL
+      pG->U[k][j][i].B2c = ((pG->px2i[j+1]-pG->px2v[j])*pG->B2i[k][j][i] + (pG->px2v[j]-pG->px2i[j])*pG->B2i[k][j+1][i])/pG->dx2;
+#else
+      pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
+#endif
+    } else {
+      pG->U[k][j][i].B2c = pG->B2i[k][j][i];
+    }
+    if (pG->ke > pG->ks) {
+      pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
+    } else {
+      pG->U[k][j][i].B3c = pG->B3i[k][j][i];
+    }
+  }}}
+
+  return;
+}
+#endif /* MHD */
+
+#undef RESTART_MPIIO_VERSION
+
+#endif /* MPI_PARALLEL */
@@ -44,6 +44,9 @@
 enum WaveType {Two_S, RS, SR, Two_R, None}; 
 
 static enum WaveType wave; /* the wave pattern of the Riemann problem */ 
+#ifdef OPENMP
+#pragma omp threadprivate(wave)
+#endif
 
 void fluxes(const Cons1DS Ul, const Cons1DS Ur,
             const Prim1DS Wl, const Prim1DS Wr, const Real Bx, Cons1DS *pF);
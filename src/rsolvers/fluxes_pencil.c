@@ -0,0 +1,57 @@
+#include "../copyright.h"
+/*============================================================================*/
+/*! \file fluxes_pencil.c
+ *  \brief Computes 1D fluxes at the interfaces of a pencil with fluxes().
+ *
+ * PURPOSE: Computes 1D fluxes at the interfaces il..iu of a pencil by calling
+ *   fluxes() at each interface.  This is the default for the Riemann solvers
+ *   which do not provide their own fluxes_pencil(), currently all but the SR
+ *   HLLE and HLLD solvers (hlle_sr.c, hlld_sr.c), where the wave speeds are
+ *   found for the whole pencil and the fluxes selected with masks.
+ *
+ *   Note fluxes_pencil() does not take the H-correction etah, so the
+ *   integrators with H_CORRECTION and the Roe flux (roe.c) must call fluxes()
+ *   per interface.
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - fluxes_pencil() - fluxes() at the interfaces of a pencil                */
+/*============================================================================*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../defs.h"
+#include "../athena.h"
+#include "../globals.h"
+#include "prototypes.h"
+#include "../prototypes.h"
+
+#if !(defined(SPECIAL_RELATIVITY) && (defined(HLLE_FLUX) || defined(HLLD_FLUX)))
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void fluxes_pencil(const int il, const int iu,
+ *         const Cons1DS *Ul, const Cons1DS *Ur, const Prim1DS *Wl,
+ *         const Prim1DS *Wr, const Real *Bxi, Cons1DS *pFlux)
+ *  \brief Computes 1D fluxes at the interfaces il..iu of a pencil
+ *   Input Arguments:
+ *   - Ul,Ur = L/R-states of CONSERVED variables at the interfaces
+ *   - Wl,Wr = L/R-states of PRIMITIVE variables at the interfaces
+ *   - Bxi = B in direction of slice at the interfaces
+ *   Output Arguments:
+ *   - pFlux = fluxes of CONSERVED variables at the interfaces
+ */
+
+void fluxes_pencil(const int il, const int iu,
+                   const Cons1DS *Ul, const Cons1DS *Ur,
+                   const Prim1DS *Wl, const Prim1DS *Wr,
+                   const Real *Bxi, Cons1DS *pFlux)
+{
+  int i;
+
+  for (i=il; i<=iu; i++)
+    fluxes(Ul[i],Ur[i],Wl[i],Wr[i],Bxi[i],&pFlux[i]);
+
+  return;
+}
+
+#endif /* SPECIAL_RELATIVITY && (HLLE_FLUX || HLLD_FLUX) */
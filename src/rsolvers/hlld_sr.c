@@ -12,6 +12,22 @@
  * - A. Mignone, M. Ugliano and G. Bodo, "A five-wave HLL Riemann solver for
  * relativistic MHD", Mon. Not. R. Astron. Soc. 000, 1-15 (2007)
  *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - fluxes() - all Riemann solvers in Athena must have this function name and
+ *              use the same argument list as defined in rsolvers/prototypes.h
+ * - fluxes_pencil() - fluxes() at the interfaces of a pencil, with the star
+ *              states only solved for inside the Riemann fan
+ * - hybrid_flux_init()     - reads the parameters of the hybrid flux
+ * - hybrid_flux_destruct() - reports the mix of HLLE and HLLD fluxes
+ *
+ * With <time>/hybrid_flux = 1, fluxes_pencil() uses the HLLE flux at the
+ * interfaces where the L/R states are smooth: the jumps in d and P are within
+ * a fraction <time>/hybrid_eps (default 0.1) of their smaller value, those in
+ * V (in units of c) within hybrid_eps, and those in By, Bz within
+ * hybrid_eps*sqrt(B^2 + 2P), with B^2 the larger of the L/R values.  There
+ * the wave speeds are the ECHO estimate (Del Zanna et al. 2007) instead of
+ * the roots of the quartic, and the star states are not solved for.  The HLLD
+ * flux is kept at shocks, contacts and rotational discontinuities.
  *============================================================================*/
 
 #include <math.h>
@@ -56,7 +72,34 @@ typedef struct RIEMANN_STATE{
   Real S, Sa, sw;
 } Riemann_State;
 
+/* L/R fluxes of a block of NPENCIL interfaces in fluxes_pencil(), in SoA
+ * layout */
+#define NPENCIL 64
+
+typedef struct CONS_PENCIL{
+  Real d[NPENCIL],E[NPENCIL];
+  Real Mx[NPENCIL],My[NPENCIL],Mz[NPENCIL];
+  Real By[NPENCIL],Bz[NPENCIL];
+} ConsPencil;
+
+/* Hybrid HLLE/HLLD flux: switch, smoothness threshold, and the number of
+ * interfaces inside the Riemann fan, and of those given the HLLE flux */
+static int hybrid=0;
+static Real hybrid_eps=0.1;
+static double nfan=0.0, nsmooth=0.0;
+
 void flux_LR(Cons1DS U, Prim1DS W, Cons1DS *flux, Real Bx, Real* p);
+static void flux_LR_pencil(const int n, const Cons1DS *U, const Prim1DS *W,
+                           const Real *Bx, ConsPencil *F);
+static int signal_speeds(const Prim1DS Wl, const Prim1DS Wr,
+                         const Real Bxi, Real *pSl, Real *pSr);
+static void hll_flux(const Cons1DS Ul, const Cons1DS Ur,
+                     const Cons1DS Fl, const Cons1DS Fr, const Real Bxi,
+                     const Real Sl, const Real Sr, Cons1DS *pFlux);
+static void star_flux(const Cons1DS Ul, const Cons1DS Ur,
+                      const Prim1DS Wl, const Prim1DS Wr, const Real Bxi,
+                      const Real Sl, const Real Sr,
+                      const Cons1DS Fl, const Cons1DS Fr, Cons1DS *pFlux);
 
 Real Fstar (Riemann_State *PaL, Riemann_State *PaR, 
 	    Real *Sc, Real p, const Real Bx);
@@ -89,48 +132,282 @@ int CUBIC(Real b, Real c, Real d, Real z[]);
  *         const Prim1DS Wl, const Prim1DS Wr, const Real Bxi, Cons1DS *pFlux)
  *  \brief Computes 1D fluxes
  *   Input Arguments:
- *   - Ul,Ur = L/R-states of CONSERVED variables at cell interface 
- *   - Wl,Wr = L/R-states of PRIMITIVE variables at cell interface 
+ *   - Ul,Ur = L/R-states of CONSERVED variables at cell interface
+ *   - Wl,Wr = L/R-states of PRIMITIVE variables at cell interface
  *   Output Arguments:
- *   - pFlux = pointer to fluxes of CONSERVED variables at cell interface 
+ *   - pFlux = pointer to fluxes of CONSERVED variables at cell interface
  */
 
 void fluxes(const Cons1DS Ul, const Cons1DS Ur,
             const Prim1DS Wl, const Prim1DS Wr, const Real Bxi, Cons1DS *pFlux)
 {
-  CONS_STATE Uhll,Fhll,Uc;
-  Cons1DS Fl,Fr,Usl,Usr,Utmp,Ftmp;
-  Prim1DS Wsl,Wsr,Whll,Wavg;
+  Cons1DS Fl,Fr;
   Real Sl, Sr, Pl, Pr;
+  int switch_to_hll;
+
+/*--- Step 1. ------------------------------------------------------------------
+ * Compute the max and min wave speeds used in Mignone
+ */
+  switch_to_hll = signal_speeds(Wl,Wr,Bxi,&Sl,&Sr);
+
+  /* compute L/R fluxes */
+  flux_LR(Ul,Wl,&Fl,Bxi,&Pl);
+  flux_LR(Ur,Wr,&Fr,Bxi,&Pr);
+
+/*--- Step 2. ------------------------------------------------------------------
+ * Use the HLL flux if the wave speeds failed
+ */
+  if (switch_to_hll) {
+    hll_flux(Ul,Ur,Fl,Fr,Bxi,Sl,Sr,pFlux);
+    return;
+  }
+
+/*--- Step 3. ------------------------------------------------------------------
+ * Compute fluxes based on wave speeds (Mignone et al. eqn 26)
+ */
+  if(Sl >= 0.0){
+
+    pFlux->d  = Fl.d;
+    pFlux->Mx = Fl.Mx;
+    pFlux->My = Fl.My;
+    pFlux->Mz = Fl.Mz;
+    pFlux->E  = Fl.E;
+    pFlux->By = Fl.By;
+    pFlux->Bz = Fl.Bz;
+
+    return;
+
+  }
+  else if(Sr <= 0.0){
+
+    pFlux->d  = Fr.d;
+    pFlux->Mx = Fr.Mx;
+    pFlux->My = Fr.My;
+    pFlux->Mz = Fr.Mz;
+    pFlux->E  = Fr.E;
+    pFlux->By = Fr.By;
+    pFlux->Bz = Fr.Bz;
+
+    return;
+  }
+  else {
+    star_flux(Ul,Ur,Wl,Wr,Bxi,Sl,Sr,Fl,Fr,pFlux);
+    return;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void fluxes_pencil(const int il, const int iu,
+ *         const Cons1DS *Ul, const Cons1DS *Ur, const Prim1DS *Wl,
+ *         const Prim1DS *Wr, const Real *Bxi, Cons1DS *pFlux)
+ *  \brief Computes 1D fluxes at the interfaces il..iu of a pencil, the same
+ *   as fluxes() at each interface.
+ *
+ *   The interfaces are taken in blocks of NPENCIL.  The wave speeds are found
+ *   one interface at a time (the quartic does not vectorise), with the ECHO
+ *   estimate at the smooth interfaces of the hybrid flux, then the L/R
+ *   fluxes of the block into SoA arrays, and the HLL, left or right flux of
+ *   each interface is selected with masks in one loop without calls.  Only
+ *   the interfaces inside the Riemann fan are gathered for the iterative
+ *   solve of the star states in star_flux().
+ */
+
+void fluxes_pencil(const int il, const int iu,
+                   const Cons1DS *Ul, const Cons1DS *Ur,
+                   const Prim1DS *Wl, const Prim1DS *Wr,
+                   const Real *Bxi, Cons1DS *pFlux)
+{
+  ConsPencil Fl, Fr;
+  Cons1DS Fls, Frs;
+  Real Sl[NPENCIL], Sr[NPENCIL];
+  int hll[NPENCIL], star[NPENCIL], smooth[NPENCIL];
+  Real dS_1, SlSr, fd, fMx, fMy, fMz, fE, fBy, fBz, dmin, Pmin, Bsq;
+  int i0, i, m, n, s, nstar, nin, left, right;
+
+  for (i0=il; i0<=iu; i0+=NPENCIL) {
+    n = MIN(NPENCIL, iu-i0+1);
+
+/* Smooth interfaces of the hybrid flux */
+    for (m=0; m<n; m++) {
+      i = i0 + m;
+      dmin = MIN(Wl[i].d, Wr[i].d);
+      Pmin = MIN(Wl[i].P, Wr[i].P);
+      Bsq = SQR(Bxi[i]) + MAX(SQR(Wl[i].By) + SQR(Wl[i].Bz),
+                              SQR(Wr[i].By) + SQR(Wr[i].Bz));
+      smooth[m] = hybrid &&
+        (fabs(Wr[i].d - Wl[i].d) <= hybrid_eps*dmin) &&
+        (fabs(Wr[i].P - Wl[i].P) <= hybrid_eps*Pmin) &&
+        (fabs(Wr[i].Vx - Wl[i].Vx) + fabs(Wr[i].Vy - Wl[i].Vy)
+          + fabs(Wr[i].Vz - Wl[i].Vz) <= hybrid_eps) &&
+        (SQR(fabs(Wr[i].By - Wl[i].By) + fabs(Wr[i].Bz - Wl[i].Bz))
+          <= SQR(hybrid_eps)*(Bsq + 2.0*Pmin));
+    }
+
+/* Wave speeds, one interface at a time: the ECHO estimate at the smooth
+ * interfaces, unless it fails, else those of signal_speeds() */
+    for (m=0; m<n; m++) {
+      i = i0 + m;
+      if (smooth[m]) {
+        getMaxSignalSpeeds_echo(Wl[i],Wr[i],Bxi[i],&Sl[m],&Sr[m]);
+        if ((Sl[m] >= -1.0) && (Sr[m] <= 1.0) && (Sl[m] < Sr[m])) {
+          hll[m] = 0;
+          continue;
+        }
+      }
+      hll[m] = signal_speeds(Wl[i],Wr[i],Bxi[i],&Sl[m],&Sr[m]);
+    }
+
+/* L/R fluxes of the block */
+    flux_LR_pencil(n, &Ul[i0], &Wl[i0], &Bxi[i0], &Fl);
+    flux_LR_pencil(n, &Ur[i0], &Wr[i0], &Bxi[i0], &Fr);
+
+/* HLL flux, replaced by the L (R) flux where the fan is right (left) of the
+ * interface; the interfaces inside the fan are listed in star[], but for
+ * the smooth ones with the hybrid flux */
+    nstar = 0;
+    nin = 0;
+    for (m=0; m<n; m++) {
+      i = i0 + m;
+      dS_1 = 1.0/(Sr[m] - Sl[m]);
+      SlSr = Sl[m]*Sr[m];
+      fd  = (Sr[m]*Fl.d[m]  - Sl[m]*Fr.d[m]  + SlSr*(Ur[i].d  - Ul[i].d )) * dS_1;
+      fMx = (Sr[m]*Fl.Mx[m] - Sl[m]*Fr.Mx[m] + SlSr*(Ur[i].Mx - Ul[i].Mx)) * dS_1;
+      fMy = (Sr[m]*Fl.My[m] - Sl[m]*Fr.My[m] + SlSr*(Ur[i].My - Ul[i].My)) * dS_1;
+      fMz = (Sr[m]*Fl.Mz[m] - Sl[m]*Fr.Mz[m] + SlSr*(Ur[i].Mz - Ul[i].Mz)) * dS_1;
+      fE  = (Sr[m]*Fl.E[m]  - Sl[m]*Fr.E[m]  + SlSr*(Ur[i].E  - Ul[i].E )) * dS_1;
+      fBy = (Sr[m]*Fl.By[m] - Sl[m]*Fr.By[m] + SlSr*(Ur[i].By - Ul[i].By)) * dS_1;
+      fBz = (Sr[m]*Fl.Bz[m] - Sl[m]*Fr.Bz[m] + SlSr*(Ur[i].Bz - Ul[i].Bz)) * dS_1;
+
+      left  = !hll[m] && (Sl[m] >= 0.0);
+      right = !hll[m] && !left && (Sr[m] <= 0.0);
+
+      pFlux[i].d  = left ? Fl.d[m]  : (right ? Fr.d[m]  : fd );
+      pFlux[i].Mx = left ? Fl.Mx[m] : (right ? Fr.Mx[m] : fMx);
+      pFlux[i].My = left ? Fl.My[m] : (right ? Fr.My[m] : fMy);
+      pFlux[i].Mz = left ? Fl.Mz[m] : (right ? Fr.Mz[m] : fMz);
+      pFlux[i].E  = left ? Fl.E[m]  : (right ? Fr.E[m]  : fE );
+      pFlux[i].By = left ? Fl.By[m] : (right ? Fr.By[m] : fBy);
+      pFlux[i].Bz = left ? Fl.Bz[m] : (right ? Fr.Bz[m] : fBz);
+
+      star[nstar] = m;
+      nin += !hll[m] && !left && !right;
+      nstar += !hll[m] && !left && !right && !smooth[m];
+    }
+
+    if (hybrid) {
+#ifdef OPENMP
+#pragma omp atomic
+#endif
+      nfan += (double)nin;
+#ifdef OPENMP
+#pragma omp atomic
+#endif
+      nsmooth += (double)(nin - nstar);
+    }
+
+/* Star states inside the fan */
+    for (m=0; m<nstar; m++) {
+      s = star[m];
+      i = i0 + s;
+      Fls.d  = Fl.d[s];   Frs.d  = Fr.d[s];
+      Fls.Mx = Fl.Mx[s];  Frs.Mx = Fr.Mx[s];
+      Fls.My = Fl.My[s];  Frs.My = Fr.My[s];
+      Fls.Mz = Fl.Mz[s];  Frs.Mz = Fr.Mz[s];
+      Fls.E  = Fl.E[s];   Frs.E  = Fr.E[s];
+      Fls.By = Fl.By[s];  Frs.By = Fr.By[s];
+      Fls.Bz = Fl.Bz[s];  Frs.Bz = Fr.Bz[s];
+      star_flux(Ul[i],Ur[i],Wl[i],Wr[i],Bxi[i],Sl[s],Sr[s],Fls,Frs,&pFlux[i]);
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void hybrid_flux_init(void)
+ *  \brief Reads <time>/hybrid_flux and <time>/hybrid_eps */
+
+void hybrid_flux_init(void)
+{
+  hybrid = par_geti_def("time","hybrid_flux",0);
+  hybrid_eps = par_getd_def("time","hybrid_eps",0.1);
+  nfan = 0.0;
+  nsmooth = 0.0;
+
+  if (hybrid != 0 && hybrid_eps < 0.0)
+    ath_error("[hybrid_flux_init]: <time>/hybrid_eps=%e must be >= 0\n",
+              hybrid_eps);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void hybrid_flux_destruct(void)
+ *  \brief Reports the fraction of the interfaces inside the Riemann fan
+ *   which were given the HLLE flux (summed over all processors) */
+
+void hybrid_flux_destruct(void)
+{
+  double cnt[2], gcnt[2];
+#ifdef MPI_PARALLEL
+  int ierr;
+#endif
+
+  if (hybrid == 0) return;
+
+  cnt[0] = nfan;
+  cnt[1] = nsmooth;
+#ifdef MPI_PARALLEL
+  ierr = MPI_Reduce(cnt, gcnt, 2, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  if (ierr != MPI_SUCCESS)
+    ath_error("[hybrid_flux_destruct]: MPI_Reduce error = %d\n",ierr);
+#else
+  gcnt[0] = cnt[0];
+  gcnt[1] = cnt[1];
+#endif
+
+  ath_pout(0,"\nhybrid flux: %.4e interfaces in the Riemann fan, ",gcnt[0]);
+  ath_pout(0,"%.2f%% HLLE, %.2f%% HLLD\n",
+           (gcnt[0] > 0.0 ? 100.0*gcnt[1]/gcnt[0] : 0.0),
+           (gcnt[0] > 0.0 ? 100.0*(gcnt[0]-gcnt[1])/gcnt[0] : 0.0));
+
+  hybrid = 0;
+  nfan = 0.0;
+  nsmooth = 0.0;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int signal_speeds(const Prim1DS Wl, const Prim1DS Wr,
+ *                               const Real Bxi, Real *pSl, Real *pSr)
+ *  \brief Max and min wave speeds of Mignone, or of ECHO if these fail.
+ *   Returns 1 if both fail, and the HLL flux with Sl=-1, Sr=1 is to be used.
+ */
+static int signal_speeds(const Prim1DS Wl, const Prim1DS Wr,
+                         const Real Bxi, Real *pSl, Real *pSr)
+{
+  Real Sl, Sr;
   Real Sla, Sra;
-  Real dS_1,scrh,Sc;
-  Real Bx,p0,pguess,f0,p,f,dp;
-  Riemann_State PaL,PaR;
-  int switch_to_hll,wave_speed_fail,k,ISTEP;
-  int current_sheet_fail;
+  int switch_to_hll,wave_speed_fail;
 
   wave_speed_fail = 0;
   switch_to_hll = 0;
-	
-/*--- Step 1. ------------------------------------------------------------------
- * Compute the max and min wave speeds used in Mignone 
- */
+
   getMaxSignalSpeeds_pluto(Wl,Wr,Bxi,&Sl,&Sr);
-	
+
   if (Sl != Sl) {
     wave_speed_fail = 1;
     printf("[hllc_sr_mhd]: NaN in Sl %10.4e %10.4e\n",Sl,Sr);
     Sl = -1.0;
     Sr =  1.0;
   }
-	
+
   if (Sr != Sr) {
     wave_speed_fail = 1;
     printf("[hllc_sr_mhd]: NaN in Sr %10.4e %10.4e\n",Sl,Sr);
     Sl = -1.0;
     Sr = 1.0;
   }
-	
+
   if (Sl < -1.0) {
     wave_speed_fail = 1;
     printf("[hllc_sr_mhd]: Superluminal Sl %10.4e %10.4e\n",Sl,Sr);
@@ -144,26 +421,24 @@ void fluxes(const Cons1DS Ul, const Cons1DS Ur,
     Sr = 1.0;
   }
 
-/*--- Step 1a. -----------------------------------------------------------------
- * If PLUTO wavespeeds are bad, fall back to the estimate used in ECHO
- */
+/* If PLUTO wavespeeds are bad, fall back to the estimate used in ECHO */
   if (wave_speed_fail){
     getMaxSignalSpeeds_echo (Wl,Wr,Bxi,&Sla,&Sra);
-	
+
     if (Sla != Sla) {
       switch_to_hll = 1;
       printf("[hllc_sr_mhd]: NaN in Sl %10.4e %10.4e\n",Sl,Sr);
       Sla = -1.0;
       Sra =  1.0;
     }
-	
+
     if (Sra != Sra) {
       switch_to_hll = 1;
       printf("[hllc_sr_mhd]: NaN in Sr %10.4e %10.4e\n",Sl,Sr);
       Sla = -1.0;
       Sra = 1.0;
     }
-	
+
     if (Sla < -1.0) {
       switch_to_hll = 1;
       printf("[hllc_sr_mhd]: Superluminal Sl %10.4e %10.4e\n",Sl,Sr);
@@ -182,319 +457,202 @@ void fluxes(const Cons1DS Ul, const Cons1DS Ur,
 
   }
 
-  /* compute L/R fluxes */
-  flux_LR(Ul,Wl,&Fl,Bxi,&Pl);
-  flux_LR(Ur,Wr,&Fr,Bxi,&Pr);
-	
-/*--- Step 2. ------------------------------------------------------------------
- * Construct HLL fluxes & average state
- */
-  dS_1 = 1.0/(Sr - Sl);
-
-  Uhll.DN = (Sr*Ur.d  - Sl*Ul.d  + Fl.d  - Fr.d ) * dS_1;
-  Uhll.M1 = (Sr*Ur.Mx - Sl*Ul.Mx + Fl.Mx - Fr.Mx) * dS_1;
-  Uhll.M2 = (Sr*Ur.My - Sl*Ul.My + Fl.My - Fr.My) * dS_1;
-  Uhll.M3 = (Sr*Ur.Mz - Sl*Ul.Mz + Fl.Mz - Fr.Mz) * dS_1;
-  Uhll.EN = (Sr*Ur.E  - Sl*Ul.E  + Fl.E  - Fr.E ) * dS_1;
-  Uhll.B1 = (Sr*   Bxi- Sl*   Bxi               ) * dS_1;
-  Uhll.B2 = (Sr*Ur.By - Sl*Ul.By + Fl.By - Fr.By) * dS_1;
-  Uhll.B3 = (Sr*Ur.Bz - Sl*Ul.Bz + Fl.Bz - Fr.Bz) * dS_1;
-		
-  Fhll.DN = (Sr*Fl.d  - Sl*Fr.d  + Sl*Sr*(Ur.d  - Ul.d )) * dS_1;
-  Fhll.M1 = (Sr*Fl.Mx - Sl*Fr.Mx + Sl*Sr*(Ur.Mx - Ul.Mx)) * dS_1;
-  Fhll.M2 = (Sr*Fl.My - Sl*Fr.My + Sl*Sr*(Ur.My - Ul.My)) * dS_1;
-  Fhll.M3 = (Sr*Fl.Mz - Sl*Fr.Mz + Sl*Sr*(Ur.Mz - Ul.Mz)) * dS_1;
-  Fhll.EN = (Sr*Fl.E  - Sl*Fr.E  + Sl*Sr*(Ur.E  - Ul.E )) * dS_1;
-  Fhll.B1 = (                      Sl*Sr*(   Bxi-   Bxi)) * dS_1;
-  Fhll.B2 = (Sr*Fl.By - Sl*Fr.By + Sl*Sr*(Ur.By - Ul.By)) * dS_1;
-  Fhll.B3 = (Sr*Fl.Bz - Sl*Fr.Bz + Sl*Sr*(Ur.Bz - Ul.Bz)) * dS_1;
+  *pSl = Sl;
+  *pSr = Sr;
+  return switch_to_hll;
+}
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static void hll_flux(const Cons1DS Ul, const Cons1DS Ur,
+ *         const Cons1DS Fl, const Cons1DS Fr, const Real Bxi,
+ *         const Real Sl, const Real Sr, Cons1DS *pFlux)
+ *  \brief HLL flux from the L/R states and fluxes */
+static void hll_flux(const Cons1DS Ul, const Cons1DS Ur,
+                     const Cons1DS Fl, const Cons1DS Fr, const Real Bxi,
+                     const Real Sl, const Real Sr, Cons1DS *pFlux)
+{
+  Real dS_1;
 
-  if (switch_to_hll) {
+  dS_1 = 1.0/(Sr - Sl);
 
-    pFlux->d = Fhll.DN;
-    pFlux->Mx = Fhll.M1;
-    pFlux->My = Fhll.M2;
-    pFlux->Mz = Fhll.M3;
-    pFlux->E = Fhll.EN;
-    pFlux->By = Fhll.B2;
-    pFlux->Bz = Fhll.B3;
-		
-    return;
-  }
+  pFlux->d  = (Sr*Fl.d  - Sl*Fr.d  + Sl*Sr*(Ur.d  - Ul.d )) * dS_1;
+  pFlux->Mx = (Sr*Fl.Mx - Sl*Fr.Mx + Sl*Sr*(Ur.Mx - Ul.Mx)) * dS_1;
+  pFlux->My = (Sr*Fl.My - Sl*Fr.My + Sl*Sr*(Ur.My - Ul.My)) * dS_1;
+  pFlux->Mz = (Sr*Fl.Mz - Sl*Fr.Mz + Sl*Sr*(Ur.Mz - Ul.Mz)) * dS_1;
+  pFlux->E  = (Sr*Fl.E  - Sl*Fr.E  + Sl*Sr*(Ur.E  - Ul.E )) * dS_1;
+  pFlux->By = (Sr*Fl.By - Sl*Fr.By + Sl*Sr*(Ur.By - Ul.By)) * dS_1;
+  pFlux->Bz = (Sr*Fl.Bz - Sl*Fr.Bz + Sl*Sr*(Ur.Bz - Ul.Bz)) * dS_1;
+}
 
-/*--- Step 3. ------------------------------------------------------------------
- * Compute fluxes based on wave speeds (Mignone et al. eqn 26)
+/*----------------------------------------------------------------------------*/
+/*! \fn static void star_flux(const Cons1DS Ul, const Cons1DS Ur,
+ *         const Prim1DS Wl, const Prim1DS Wr, const Real Bxi,
+ *         const Real Sl, const Real Sr, const Cons1DS Fl, const Cons1DS Fr,
+ *         Cons1DS *pFlux)
+ *  \brief HLLD flux for Sl < 0 < Sr: solves for the total pressure in the
+ *   star region, and falls back to the HLL flux if that fails.
  */
-  if(Sl >= 0.0){
+static void star_flux(const Cons1DS Ul, const Cons1DS Ur,
+                      const Prim1DS Wl, const Prim1DS Wr, const Real Bxi,
+                      const Real Sl, const Real Sr,
+                      const Cons1DS Fl, const Cons1DS Fr, Cons1DS *pFlux)
+{
+  CONS_STATE Uc;
+  Cons1DS Utmp,Ftmp;
+  Prim1DS Whll;
+  Real dS_1,scrh,Sc;
+  Real Bx,p0,f0,p,f,dp;
+  Riemann_State PaL,PaR;
+  int switch_to_hll,k;
 
-    pFlux->d  = Fl.d;
-    pFlux->Mx = Fl.Mx;
-    pFlux->My = Fl.My;
-    pFlux->Mz = Fl.Mz;
-    pFlux->E  = Fl.E;
-    pFlux->By = Fl.By;
-    pFlux->Bz = Fl.Bz;
-		
-    return;
-   
-  }
-  else if(Sr <= 0.0){
+/* HLL average state, and the HLL flux to fall back on */
+  dS_1 = 1.0/(Sr - Sl);
 
-    pFlux->d  = Fr.d;
-    pFlux->Mx = Fr.Mx;
-    pFlux->My = Fr.My;
-    pFlux->Mz = Fr.Mz;
-    pFlux->E  = Fr.E;
-    pFlux->By = Fr.By;
-    pFlux->Bz = Fr.Bz;
-		
-    return;
+  Utmp.d  = (Sr*Ur.d  - Sl*Ul.d  + Fl.d  - Fr.d ) * dS_1;
+  Utmp.Mx = (Sr*Ur.Mx - Sl*Ul.Mx + Fl.Mx - Fr.Mx) * dS_1;
+  Utmp.My = (Sr*Ur.My - Sl*Ul.My + Fl.My - Fr.My) * dS_1;
+  Utmp.Mz = (Sr*Ur.Mz - Sl*Ul.Mz + Fl.Mz - Fr.Mz) * dS_1;
+  Utmp.E  = (Sr*Ur.E  - Sl*Ul.E  + Fl.E  - Fr.E ) * dS_1;
+  Utmp.By = (Sr*Ur.By - Sl*Ul.By + Fl.By - Fr.By) * dS_1;
+  Utmp.Bz = (Sr*Ur.Bz - Sl*Ul.Bz + Fl.Bz - Fr.Bz) * dS_1;
+
+  hll_flux(Ul,Ur,Fl,Fr,Bxi,Sl,Sr,&Ftmp);
+
+  PaL.S = Sl;
+  PaR.S = Sr;
+  Bx    = (Sr*Bxi - Sl*Bxi) * dS_1;
+
+  PaL.R.DN = Sl*Ul.d  - Fl.d;
+  PaL.R.EN = Sl*Ul.E  - Fl.E;
+  PaL.R.M1 = Sl*Ul.Mx - Fl.Mx;
+  PaL.R.M2 = Sl*Ul.My - Fl.My;
+  PaL.R.M3 = Sl*Ul.Mz - Fl.Mz;
+  PaL.R.B1 = Sl*  Bxi        ;
+  PaL.R.B2 = Sl*Ul.By - Fl.By;
+  PaL.R.B3 = Sl*Ul.Bz - Fl.Bz;
+
+  PaR.R.DN = Sr*Ur.d  - Fr.d;
+  PaR.R.EN = Sr*Ur.E  - Fr.E;
+  PaR.R.M1 = Sr*Ur.Mx - Fr.Mx;
+  PaR.R.M2 = Sr*Ur.My - Fr.My;
+  PaR.R.M3 = Sr*Ur.Mz - Fr.Mz;
+  PaR.R.B1 = Sr*  Bxi        ;
+  PaR.R.B2 = Sr*Ur.By - Fr.By;
+  PaR.R.B3 = Sr*Ur.Bz - Fr.Bz;
+
+  /* ---- provide an initial guess ---- */
+
+  scrh = MAX(Wl.P, Wr.P);
+  if (Bx*Bx/scrh < 0.01) { /* -- try the B->0 limit -- */
+
+    Real a,b,c;
+    a = Sr - Sl;
+    b = PaR.R.EN - PaL.R.EN + Sr*PaL.R.M1 - Sl*PaR.R.M1;
+    c = PaL.R.M1*PaR.R.EN - PaR.R.M1*PaL.R.EN;
+    scrh = b*b - 4.0*a*c;
+    scrh = MAX(scrh,0.0);
+    p0 = 0.5*(- b + sqrt(scrh))*dS_1;
+
+  } else {  /* ----  use HLL average ---- */
+
+    Whll = check_Prim1D(&Utmp, &Bxi);
+    getPtot(Bxi,Whll,&p0);
   }
-  else {
 
-    PaL.S = Sl;
-    PaR.S = Sr;
-    Bx    = Uhll.B1;
-
-    PaL.R.DN = Sl*Ul.d  - Fl.d;
-    PaL.R.EN = Sl*Ul.E  - Fl.E;
-    PaL.R.M1 = Sl*Ul.Mx - Fl.Mx;
-    PaL.R.M2 = Sl*Ul.My - Fl.My;
-    PaL.R.M3 = Sl*Ul.Mz - Fl.Mz;
-    PaL.R.B1 = Sl*  Bxi        ;
-    PaL.R.B2 = Sl*Ul.By - Fl.By;
-    PaL.R.B3 = Sl*Ul.Bz - Fl.Bz;
-
-    PaR.R.DN = Sr*Ur.d  - Fr.d;
-    PaR.R.EN = Sr*Ur.E  - Fr.E;
-    PaR.R.M1 = Sr*Ur.Mx - Fr.Mx;
-    PaR.R.M2 = Sr*Ur.My - Fr.My;
-    PaR.R.M3 = Sr*Ur.Mz - Fr.Mz;
-    PaR.R.B1 = Sr*  Bxi        ;
-    PaR.R.B2 = Sr*Ur.By - Fr.By;
-    PaR.R.B3 = Sr*Ur.Bz - Fr.Bz;
-
-    /* ---- provide an initial guess ---- */
-
-    Utmp.d = Uhll.DN;
-    Utmp.Mx = Uhll.M1;
-    Utmp.My = Uhll.M2;
-    Utmp.Mz = Uhll.M3;
-    Utmp.E = Uhll.EN;
-    Utmp.By = Uhll.B2;
-    Utmp.Bz = Uhll.B3;
-
-    Ftmp.d = Fhll.DN;
-    Ftmp.Mx = Fhll.M1;
-    Ftmp.My = Fhll.M2;
-    Ftmp.Mz = Fhll.M3;
-    Ftmp.E = Fhll.EN;
-    Ftmp.By = Fhll.B2;
-    Ftmp.Bz = Fhll.B3;
-
-    /*Whll = check_Prim1D(&Utmp, &Bxi);
-      getPtot(Bxi,Whll,&p0);*/
-
-    scrh = MAX(Wl.P, Wr.P);
-    if (Bx*Bx/scrh < 0.01) { /* -- try the B->0 limit -- */
-	
-      Real a,b,c;
-      a = Sr - Sl;
-      b = PaR.R.EN - PaL.R.EN + Sr*PaL.R.M1 - Sl*PaR.R.M1;
-      c = PaL.R.M1*PaR.R.EN - PaR.R.M1*PaL.R.EN;
-      scrh = b*b - 4.0*a*c;
-      scrh = MAX(scrh,0.0);
-      p0 = 0.5*(- b + sqrt(scrh))*dS_1;
-      
-    } else {  /* ----  use HLL average ---- */
-
-	/*Utmp.d = Uhll.DN;
-      Utmp.Mx = Uhll.M1;
-      Utmp.My = Uhll.M2;
-      Utmp.Mz = Uhll.M3;
-      Utmp.E = Uhll.EN;
-      Utmp.By = Uhll.B2;
-      Utmp.Bz = Uhll.B3;*/
-  
-      Whll = check_Prim1D(&Utmp, &Bxi);                       
-      getPtot(Bxi,Whll,&p0);
-    }
-      
-    pguess = p0;
-  /* ---- check if guess makes sense ---- */
-
-    /*switch_to_hll = 0;
-    f0 = Fstar(&PaL, &PaR, &Sc, p0, Bx);
-    if (f0 != f0 || PaL.fail){
-
-      Whll.d  = (Sr*Wr.d  - Sl*Wl.d ) * dS_1;
-      Whll.Vx = (Sr*Wr.Vx - Sl*Wl.Vx) * dS_1;
-      Whll.Vy = (Sr*Wr.Vy - Sl*Wl.Vy) * dS_1;
-      Whll.Vz = (Sr*Wr.Vz - Sl*Wl.Vz) * dS_1;
-      Whll.P  = (Sr*Wr.P  - Sl*Wl.P ) * dS_1;
-      Whll.By = (Sr*Wr.By - Sl*Wl.By) * dS_1;
-      Whll.Bz = (Sr*Wr.Bz - Sl*Wl.Bz) * dS_1;
-      getPtot(Bxi,Whll,&p0);*/
-
-      pguess = p0;
-      switch_to_hll = 0;
-      f0 = Fstar(&PaL, &PaR, &Sc, p0, Bx);
-      if (f0 != f0 || PaL.fail) switch_to_hll = 1;
-      /*}*/
-
-    /* ---- Root finder ---- */
-
-    k = 0;
-    if (fabs(f0) > 1.e-12 && !switch_to_hll){
-      p  = 1.025*p0; f  = f0;
-      for (k = 1; k < MAX_ITER; k++){
-	
-	f  = Fstar(&PaL, &PaR, &Sc, p, Bx);
-	if ( f != f  || PaL.fail || (k > 7) || 
-	     (fabs(f) > fabs(f0) && k > 4)) {
-	  switch_to_hll = 1;
-	  break;
-	}
-	
-	dp = (p - p0)/(f - f0)*f;
-	
-	p0 = p; f0 = f;
-	p -= dp;
-	if (p < 0.0) p = 1.e-6;
-	if (fabs(dp) < 1.e-5*p || fabs(f) < 1.e-6) break;
-      }
-    }else p = p0;
-    
-    if (PaL.fail) switch_to_hll = 1;
-    
-    if (switch_to_hll) {
-
-      *pFlux = Ftmp;
-      
-      return;
-    }
-
-    if (PaL.Sa >= -1.e-6){
-
-      GET_ASTATE (&PaL, p, Bx);
-
-      pFlux->d  = Fl.d  + Sl*(PaL.u.DN  - Ul.d );
-      pFlux->Mx = Fl.Mx + Sl*(PaL.u.M1  - Ul.Mx);
-      pFlux->My = Fl.My + Sl*(PaL.u.M2  - Ul.My);
-      pFlux->Mz = Fl.Mz + Sl*(PaL.u.M3  - Ul.Mz);
-      pFlux->E  = Fl.E  + Sl*(PaL.u.EN  - Ul.E );
-      pFlux->By = Fl.By + Sl*(PaL.u.B2  - Ul.By);
-      pFlux->Bz = Fl.Bz + Sl*(PaL.u.B3  - Ul.Bz);
-
-      if (pFlux->d  != pFlux->d || pFlux->E   != pFlux->E ||
-          pFlux->Mx != pFlux->Mx || pFlux->My != pFlux->My ||
-          pFlux->Mz != pFlux->Mz || pFlux->By != pFlux->By ||
-          pFlux->Bz != pFlux->Bz) {
-
-	pFlux->d = Ftmp.d;
-	pFlux->Mx = Ftmp.Mx;
-	pFlux->My = Ftmp.My;
-	pFlux->Mz = Ftmp.Mz;
-	pFlux->E = Ftmp.E;
-	pFlux->By = Ftmp.By;
-	pFlux->Bz = Ftmp.Bz;
-
-      }
-
-      return;
-
-    }else if (PaR.Sa <= 1.e-6){
-
-      GET_ASTATE (&PaR, p, Bx);
-
-      pFlux->d  = Fr.d  + Sr*(PaR.u.DN  - Ur.d );
-      pFlux->Mx = Fr.Mx + Sr*(PaR.u.M1  - Ur.Mx);
-      pFlux->My = Fr.My + Sr*(PaR.u.M2  - Ur.My);
-      pFlux->Mz = Fr.Mz + Sr*(PaR.u.M3  - Ur.Mz);
-      pFlux->E  = Fr.E  + Sr*(PaR.u.EN  - Ur.E );
-      pFlux->By = Fr.By + Sr*(PaR.u.B2  - Ur.By);
-      pFlux->Bz = Fr.Bz + Sr*(PaR.u.B3  - Ur.Bz);
+  switch_to_hll = 0;
+  f0 = Fstar(&PaL, &PaR, &Sc, p0, Bx);
+  if (f0 != f0 || PaL.fail) switch_to_hll = 1;
 
-      if (pFlux->d  != pFlux->d || pFlux->E   != pFlux->E ||
-          pFlux->Mx != pFlux->Mx || pFlux->My != pFlux->My ||
-          pFlux->Mz != pFlux->Mz || pFlux->By != pFlux->By ||
-          pFlux->Bz != pFlux->Bz) {
+  /* ---- Root finder ---- */
 
-	pFlux->d = Ftmp.d;
-	pFlux->Mx = Ftmp.Mx;
-	pFlux->My = Ftmp.My;
-	pFlux->Mz = Ftmp.Mz;
-	pFlux->E = Ftmp.E;
-	pFlux->By = Ftmp.By;
-	pFlux->Bz = Ftmp.Bz;
+  k = 0;
+  if (fabs(f0) > 1.e-12 && !switch_to_hll){
+    p  = 1.025*p0; f  = f0;
+    for (k = 1; k < MAX_ITER; k++){
 
+      f  = Fstar(&PaL, &PaR, &Sc, p, Bx);
+      if ( f != f  || PaL.fail || (k > 7) ||
+	   (fabs(f) > fabs(f0) && k > 4)) {
+	switch_to_hll = 1;
+	break;
       }
 
-      return;
+      dp = (p - p0)/(f - f0)*f;
 
-    }else{
+      p0 = p; f0 = f;
+      p -= dp;
+      if (p < 0.0) p = 1.e-6;
+      if (fabs(dp) < 1.e-5*p || fabs(f) < 1.e-6) break;
+    }
+  }else p = p0;
 
-      GET_CSTATE (&PaL, &PaR, p, &Uc, Bx);
+  if (PaL.fail) switch_to_hll = 1;
 
-      if (Sc > 0.0){
+  if (switch_to_hll) {
+    *pFlux = Ftmp;
+    return;
+  }
 
-	pFlux->d  = Fl.d  + Sl*(PaL.u.DN  - Ul.d ) + PaL.Sa*(Uc.DN - PaL.u.DN);
-	pFlux->Mx = Fl.Mx + Sl*(PaL.u.M1  - Ul.Mx) + PaL.Sa*(Uc.M1 - PaL.u.M1);
-	pFlux->My = Fl.My + Sl*(PaL.u.M2  - Ul.My) + PaL.Sa*(Uc.M2 - PaL.u.M2);
-	pFlux->Mz = Fl.Mz + Sl*(PaL.u.M3  - Ul.Mz) + PaL.Sa*(Uc.M3 - PaL.u.M3);
-	pFlux->E  = Fl.E  + Sl*(PaL.u.EN  - Ul.E ) + PaL.Sa*(Uc.EN - PaL.u.EN);
-	pFlux->By = Fl.By + Sl*(PaL.u.B2  - Ul.By) + PaL.Sa*(Uc.B2 - PaL.u.B2);
-	pFlux->Bz = Fl.Bz + Sl*(PaL.u.B3  - Ul.Bz) + PaL.Sa*(Uc.B3 - PaL.u.B3);
+  if (PaL.Sa >= -1.e-6){
 
-	if (pFlux->d  != pFlux->d || pFlux->E   != pFlux->E ||
-	    pFlux->Mx != pFlux->Mx || pFlux->My != pFlux->My ||
-	    pFlux->Mz != pFlux->Mz || pFlux->By != pFlux->By ||
-	    pFlux->Bz != pFlux->Bz) {
+    GET_ASTATE (&PaL, p, Bx);
 
-	  pFlux->d = Ftmp.d;
-	  pFlux->Mx = Ftmp.Mx;
-	  pFlux->My = Ftmp.My;
-	  pFlux->Mz = Ftmp.Mz;
-	  pFlux->E = Ftmp.E;
-	  pFlux->By = Ftmp.By;
-	  pFlux->Bz = Ftmp.Bz;
+    pFlux->d  = Fl.d  + Sl*(PaL.u.DN  - Ul.d );
+    pFlux->Mx = Fl.Mx + Sl*(PaL.u.M1  - Ul.Mx);
+    pFlux->My = Fl.My + Sl*(PaL.u.M2  - Ul.My);
+    pFlux->Mz = Fl.Mz + Sl*(PaL.u.M3  - Ul.Mz);
+    pFlux->E  = Fl.E  + Sl*(PaL.u.EN  - Ul.E );
+    pFlux->By = Fl.By + Sl*(PaL.u.B2  - Ul.By);
+    pFlux->Bz = Fl.Bz + Sl*(PaL.u.B3  - Ul.Bz);
 
-	}
+  }else if (PaR.Sa <= 1.e-6){
 
-	return;
+    GET_ASTATE (&PaR, p, Bx);
 
+    pFlux->d  = Fr.d  + Sr*(PaR.u.DN  - Ur.d );
+    pFlux->Mx = Fr.Mx + Sr*(PaR.u.M1  - Ur.Mx);
+    pFlux->My = Fr.My + Sr*(PaR.u.M2  - Ur.My);
+    pFlux->Mz = Fr.Mz + Sr*(PaR.u.M3  - Ur.Mz);
+    pFlux->E  = Fr.E  + Sr*(PaR.u.EN  - Ur.E );
+    pFlux->By = Fr.By + Sr*(PaR.u.B2  - Ur.By);
+    pFlux->Bz = Fr.Bz + Sr*(PaR.u.B3  - Ur.Bz);
 
-      }else{
+  }else{
 
-	pFlux->d  = Fr.d  + Sr*(PaR.u.DN  - Ur.d ) + PaR.Sa*(Uc.DN - PaR.u.DN);
-	pFlux->Mx = Fr.Mx + Sr*(PaR.u.M1  - Ur.Mx) + PaR.Sa*(Uc.M1 - PaR.u.M1);
-	pFlux->My = Fr.My + Sr*(PaR.u.M2  - Ur.My) + PaR.Sa*(Uc.M2 - PaR.u.M2);
-	pFlux->Mz = Fr.Mz + Sr*(PaR.u.M3  - Ur.Mz) + PaR.Sa*(Uc.M3 - PaR.u.M3);
-	pFlux->E  = Fr.E  + Sr*(PaR.u.EN  - Ur.E ) + PaR.Sa*(Uc.EN - PaR.u.EN);
-	pFlux->By = Fr.By + Sr*(PaR.u.B2  - Ur.By) + PaR.Sa*(Uc.B2 - PaR.u.B2);
-	pFlux->Bz = Fr.Bz + Sr*(PaR.u.B3  - Ur.Bz) + PaR.Sa*(Uc.B3 - PaR.u.B3);
+    GET_CSTATE (&PaL, &PaR, p, &Uc, Bx);
 
-	if (pFlux->d  != pFlux->d || pFlux->E   != pFlux->E ||
-	    pFlux->Mx != pFlux->Mx || pFlux->My != pFlux->My ||
-	    pFlux->Mz != pFlux->Mz || pFlux->By != pFlux->By ||
-	    pFlux->Bz != pFlux->Bz) {
+    if (Sc > 0.0){
 
-	  pFlux->d = Ftmp.d;
-	  pFlux->Mx = Ftmp.Mx;
-	  pFlux->My = Ftmp.My;
-	  pFlux->Mz = Ftmp.Mz;
-	  pFlux->E = Ftmp.E;
-	  pFlux->By = Ftmp.By;
-	  pFlux->Bz = Ftmp.Bz;
+      pFlux->d  = Fl.d  + Sl*(PaL.u.DN  - Ul.d ) + PaL.Sa*(Uc.DN - PaL.u.DN);
+      pFlux->Mx = Fl.Mx + Sl*(PaL.u.M1  - Ul.Mx) + PaL.Sa*(Uc.M1 - PaL.u.M1);
+      pFlux->My = Fl.My + Sl*(PaL.u.M2  - Ul.My) + PaL.Sa*(Uc.M2 - PaL.u.M2);
+      pFlux->Mz = Fl.Mz + Sl*(PaL.u.M3  - Ul.Mz) + PaL.Sa*(Uc.M3 - PaL.u.M3);
+      pFlux->E  = Fl.E  + Sl*(PaL.u.EN  - Ul.E ) + PaL.Sa*(Uc.EN - PaL.u.EN);
+      pFlux->By = Fl.By + Sl*(PaL.u.B2  - Ul.By) + PaL.Sa*(Uc.B2 - PaL.u.B2);
+      pFlux->Bz = Fl.Bz + Sl*(PaL.u.B3  - Ul.Bz) + PaL.Sa*(Uc.B3 - PaL.u.B3);
 
-	}
+    }else{
 
-	return;
+      pFlux->d  = Fr.d  + Sr*(PaR.u.DN  - Ur.d ) + PaR.Sa*(Uc.DN - PaR.u.DN);
+      pFlux->Mx = Fr.Mx + Sr*(PaR.u.M1  - Ur.Mx) + PaR.Sa*(Uc.M1 - PaR.u.M1);
+      pFlux->My = Fr.My + Sr*(PaR.u.M2  - Ur.My) + PaR.Sa*(Uc.M2 - PaR.u.M2);
+      pFlux->Mz = Fr.Mz + Sr*(PaR.u.M3  - Ur.Mz) + PaR.Sa*(Uc.M3 - PaR.u.M3);
+      pFlux->E  = Fr.E  + Sr*(PaR.u.EN  - Ur.E ) + PaR.Sa*(Uc.EN - PaR.u.EN);
+      pFlux->By = Fr.By + Sr*(PaR.u.B2  - Ur.By) + PaR.Sa*(Uc.B2 - PaR.u.B2);
+      pFlux->Bz = Fr.Bz + Sr*(PaR.u.B3  - Ur.Bz) + PaR.Sa*(Uc.B3 - PaR.u.B3);
 
-      }  
     }
   }
+
+/* revert to the HLL flux if this flux NaN'ed */
+  if (pFlux->d  != pFlux->d || pFlux->E   != pFlux->E ||
+      pFlux->Mx != pFlux->Mx || pFlux->My != pFlux->My ||
+      pFlux->Mz != pFlux->Mz || pFlux->By != pFlux->By ||
+      pFlux->Bz != pFlux->Bz) {
+    *pFlux = Ftmp;
+  }
+
+  return;
 }
 
 /* *********************************************************************** */
@@ -887,6 +1045,52 @@ void flux_LR(Cons1DS U, Prim1DS W, Cons1DS *flux, Real Bx, Real* p)
   *p = pt;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static void flux_LR_pencil(const int n, const Cons1DS *U,
+ *                 const Prim1DS *W, const Real *Bx, ConsPencil *F)
+ *  \brief flux_LR() for n <= NPENCIL interfaces, into SoA arrays */
+static void flux_LR_pencil(const int n, const Cons1DS *U, const Prim1DS *W,
+                           const Real *Bx, ConsPencil *F)
+{
+  Real wtg2, pt, g, g2, g_2, h, gmmr, theta;
+  Real bx, by, bz, vB, b2, Bmag2;
+  int m;
+
+  gmmr = Gamma / Gamma_1;
+
+  for (m=0; m<n; m++) {
+    theta = W[m].P/W[m].d;
+    h = 1.0 + gmmr*theta;
+
+    g   = U[m].d/W[m].d;
+    g2  = SQR(g);
+    g_2 = 1.0/g2;
+
+    pt = W[m].P;
+    wtg2 = W[m].d*h*g2;
+
+    vB = W[m].Vx*Bx[m] + W[m].Vy*W[m].By + W[m].Vz*W[m].Bz;
+    Bmag2 = SQR(Bx[m]) + SQR(W[m].By) + SQR(W[m].Bz);
+
+    bx = g*(Bx[m]*g_2 + vB*W[m].Vx);
+    by = g*(W[m].By*g_2 + vB*W[m].Vy);
+    bz = g*(W[m].Bz*g_2 + vB*W[m].Vz);
+
+    b2 = Bmag2*g_2 + vB*vB;
+
+    pt += 0.5*b2;
+    wtg2 += b2*g2;
+
+    F->d[m]  = U[m].d*W[m].Vx;
+    F->Mx[m] = wtg2*W[m].Vx*W[m].Vx + pt - bx*bx;
+    F->My[m] = wtg2*W[m].Vy*W[m].Vx - by*bx;
+    F->Mz[m] = wtg2*W[m].Vz*W[m].Vx - bz*bx;
+    F->E[m]  = U[m].Mx;
+    F->By[m] = W[m].Vx*W[m].By - Bx[m]*W[m].Vy;
+    F->Bz[m] = W[m].Vx*W[m].Bz - Bx[m]*W[m].Vz;
+  }
+}
+
 void getMaxSignalSpeeds_pluto(const Prim1DS Wl, const Prim1DS Wr,
 			      const Real Bx, Real* low, Real* high)
 {
@@ -12,7 +12,8 @@
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - fluxes() - all Riemann solvers in Athena must have this function name and
- *              use the same argument list as defined in rsolvers/prototypes.h*/
+ *              use the same argument list as defined in rsolvers/prototypes.h
+ * - fluxes_pencil() - fluxes() at the interfaces of a pencil               */
 /*============================================================================*/
 
 #include <math.h>
@@ -31,7 +32,23 @@
 #error : The SR HLLE flux does not work with passive scalars.
 #endif
 
+/* L/R fluxes of a block of NPENCIL interfaces in fluxes_pencil(), in SoA
+ * layout */
+#define NPENCIL 64
+
+typedef struct CONS_PENCIL{
+  Real d[NPENCIL],E[NPENCIL];
+  Real Mx[NPENCIL],My[NPENCIL],Mz[NPENCIL];
+#ifdef MHD
+  Real By[NPENCIL],Bz[NPENCIL];
+#endif
+} ConsPencil;
+
 void flux_LR(Cons1DS U, Prim1DS W, Cons1DS *flux, Real Bx, Real* p);
+static void flux_LR_pencil(const int n, const Cons1DS *U, const Prim1DS *W,
+                           const Real *Bx, ConsPencil *F);
+static void signal_speeds(const Prim1DS Wl, const Prim1DS Wr,
+                          const Real Bx, Real *pSl, Real *pSr);
 void getMaxSignalSpeeds_pluto(const Prim1DS Wl, const Prim1DS Wr,
 			      const Real Bx, Real* low, Real* high);
 void getMaxSignalSpeeds_echo(const Prim1DS Wl, const Prim1DS Wr,
@@ -69,77 +86,12 @@ void fluxes(const Cons1DS Ul, const Cons1DS Ur,
   Prim1DS Whll;
   Real Pl, Pr;
   Real Sl, Sr;
-  Real Sla, Sra;
-  Real dS_1, V2l;
-  int wave_speed_fail;
+  Real dS_1;
 
-  wave_speed_fail = 0;
-	
 /*--- Step 1. ------------------------------------------------------------------
- * Compute the max and min wave speeds used in Mignone 
+ * Compute the max and min wave speeds used in Mignone
  */
-  getMaxSignalSpeeds_pluto(Wl,Wr,Bx,&Sl,&Sr);
-	
-  if (Sl != Sl) {
-    wave_speed_fail = 1;
-    printf("[hlle_sr_mhd]: NaN in Sl %10.4e %10.4e\n",Sl,Sr);
-    Sl = -1.0;
-    Sr =  1.0;
-  }
-	
-  if (Sr != Sr) {
-    wave_speed_fail = 1;
-    printf("[hlle_sr_mhd]: NaN in Sr %10.4e %10.4e\n",Sl,Sr);
-    Sl = -1.0;
-    Sr = 1.0;
-  }
-	
-  if (Sl < -1.0) {
-    wave_speed_fail = 1;
-    printf("[hlle_sr_mhd]: Superluminal Sl %10.4e %10.4e\n",Sl,Sr);
-    Sl = -1.0;
-    Sr = 1.0;
-  }
-  if (Sr > 1.0) {
-    wave_speed_fail = 1;
-    printf("[hlle_sr_mhd]: Superluminal Sr %10.4e %10.4e\n",Sl,Sr);
-    Sl = -1.0;
-    Sr = 1.0;
-  }
-
-/*--- Step 1a. -----------------------------------------------------------------
- * If PLUTO wavespeeds are bad, fall back to the estimate used in ECHO
- */
-  if (wave_speed_fail){
-    getMaxSignalSpeeds_echo (Wl,Wr,Bx,&Sla,&Sra);
-	
-    if (Sla != Sla) {
-      printf("[hlle_sr_mhd]: NaN in Sl %10.4e %10.4e\n",Sl,Sr);
-      Sla = -1.0;
-      Sra =  1.0;
-    }
-	
-    if (Sra != Sra) {
-      printf("[hlle_sr_mhd]: NaN in Sr %10.4e %10.4e\n",Sl,Sr);
-      Sla = -1.0;
-      Sra = 1.0;
-    }
-	
-    if (Sla < -1.0) {
-      printf("[hlle_sr_mhd]: Superluminal Sl %10.4e %10.4e\n",Sl,Sr);
-      Sla = -1.0;
-      Sra = 1.0;
-    }
-    if (Sra > 1.0) {
-      printf("[hlle_sr_mhd]: Superluminal Sr %10.4e %10.4e\n",Sl,Sr);
-      Sla = -1.0;
-      Sra = 1.0;
-    }
-
-    Sl = Sla;
-    Sr = Sra;
-
-  }
+  signal_speeds(Wl,Wr,Bx,&Sl,&Sr);
 
   /* compute L/R fluxes */
   flux_LR(Ul,Wl,&Fl,Bx,&Pl);
@@ -212,6 +164,153 @@ void fluxes(const Cons1DS Ul, const Cons1DS Ur,
   }
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn void fluxes_pencil(const int il, const int iu,
+ *         const Cons1DS *Ul, const Cons1DS *Ur, const Prim1DS *Wl,
+ *         const Prim1DS *Wr, const Real *Bxi, Cons1DS *pFlux)
+ *  \brief Computes 1D fluxes at the interfaces il..iu of a pencil, the same
+ *   as fluxes() at each interface.
+ *
+ *   The interfaces are taken in blocks of NPENCIL.  The wave speeds are found
+ *   one interface at a time (the quartic does not vectorise), then the L/R
+ *   fluxes of the block into SoA arrays, and the HLL, left or right flux of
+ *   each interface is selected with masks in one loop without calls.
+ */
+
+void fluxes_pencil(const int il, const int iu,
+                   const Cons1DS *Ul, const Cons1DS *Ur,
+                   const Prim1DS *Wl, const Prim1DS *Wr,
+                   const Real *Bxi, Cons1DS *pFlux)
+{
+  ConsPencil Fl, Fr;
+  Real Sl[NPENCIL], Sr[NPENCIL];
+  Real dS_1, SlSr, fd, fMx, fMy, fMz, fE;
+#ifdef MHD
+  Real fBy, fBz;
+#endif
+  int i0, i, m, n, left, right;
+
+  for (i0=il; i0<=iu; i0+=NPENCIL) {
+    n = MIN(NPENCIL, iu-i0+1);
+
+/* Wave speeds, one interface at a time */
+    for (m=0; m<n; m++)
+      signal_speeds(Wl[i0+m],Wr[i0+m],Bxi[i0+m],&Sl[m],&Sr[m]);
+
+/* L/R fluxes of the block */
+    flux_LR_pencil(n, &Ul[i0], &Wl[i0], &Bxi[i0], &Fl);
+    flux_LR_pencil(n, &Ur[i0], &Wr[i0], &Bxi[i0], &Fr);
+
+/* HLL flux, replaced by the L (R) flux where the fan is right (left) of the
+ * interface */
+    for (m=0; m<n; m++) {
+      i = i0 + m;
+      dS_1 = 1.0/(Sr[m] - Sl[m]);
+      SlSr = Sl[m]*Sr[m];
+      fd  = (Sr[m]*Fl.d[m]  - Sl[m]*Fr.d[m]  + SlSr*(Ur[i].d  - Ul[i].d )) * dS_1;
+      fMx = (Sr[m]*Fl.Mx[m] - Sl[m]*Fr.Mx[m] + SlSr*(Ur[i].Mx - Ul[i].Mx)) * dS_1;
+      fMy = (Sr[m]*Fl.My[m] - Sl[m]*Fr.My[m] + SlSr*(Ur[i].My - Ul[i].My)) * dS_1;
+      fMz = (Sr[m]*Fl.Mz[m] - Sl[m]*Fr.Mz[m] + SlSr*(Ur[i].Mz - Ul[i].Mz)) * dS_1;
+      fE  = (Sr[m]*Fl.E[m]  - Sl[m]*Fr.E[m]  + SlSr*(Ur[i].E  - Ul[i].E )) * dS_1;
+#ifdef MHD
+      fBy = (Sr[m]*Fl.By[m] - Sl[m]*Fr.By[m] + SlSr*(Ur[i].By - Ul[i].By)) * dS_1;
+      fBz = (Sr[m]*Fl.Bz[m] - Sl[m]*Fr.Bz[m] + SlSr*(Ur[i].Bz - Ul[i].Bz)) * dS_1;
+#endif
+
+      left  = (Sl[m] >= 0.0);
+      right = !left && (Sr[m] <= 0.0);
+
+      pFlux[i].d  = left ? Fl.d[m]  : (right ? Fr.d[m]  : fd );
+      pFlux[i].Mx = left ? Fl.Mx[m] : (right ? Fr.Mx[m] : fMx);
+      pFlux[i].My = left ? Fl.My[m] : (right ? Fr.My[m] : fMy);
+      pFlux[i].Mz = left ? Fl.Mz[m] : (right ? Fr.Mz[m] : fMz);
+      pFlux[i].E  = left ? Fl.E[m]  : (right ? Fr.E[m]  : fE );
+#ifdef MHD
+      pFlux[i].By = left ? Fl.By[m] : (right ? Fr.By[m] : fBy);
+      pFlux[i].Bz = left ? Fl.Bz[m] : (right ? Fr.Bz[m] : fBz);
+#endif
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void signal_speeds(const Prim1DS Wl, const Prim1DS Wr,
+ *                               const Real Bx, Real *pSl, Real *pSr)
+ *  \brief Max and min wave speeds of Mignone, or of ECHO if these fail */
+static void signal_speeds(const Prim1DS Wl, const Prim1DS Wr,
+                          const Real Bx, Real *pSl, Real *pSr)
+{
+  Real Sl, Sr;
+  Real Sla, Sra;
+  int wave_speed_fail;
+
+  wave_speed_fail = 0;
+
+  getMaxSignalSpeeds_pluto(Wl,Wr,Bx,&Sl,&Sr);
+	
+  if (Sl != Sl) {
+    wave_speed_fail = 1;
+    printf("[hlle_sr_mhd]: NaN in Sl %10.4e %10.4e\n",Sl,Sr);
+    Sl = -1.0;
+    Sr =  1.0;
+  }
+	
+  if (Sr != Sr) {
+    wave_speed_fail = 1;
+    printf("[hlle_sr_mhd]: NaN in Sr %10.4e %10.4e\n",Sl,Sr);
+    Sl = -1.0;
+    Sr = 1.0;
+  }
+	
+  if (Sl < -1.0) {
+    wave_speed_fail = 1;
+    printf("[hlle_sr_mhd]: Superluminal Sl %10.4e %10.4e\n",Sl,Sr);
+    Sl = -1.0;
+    Sr = 1.0;
+  }
+  if (Sr > 1.0) {
+    wave_speed_fail = 1;
+    printf("[hlle_sr_mhd]: Superluminal Sr %10.4e %10.4e\n",Sl,Sr);
+    Sl = -1.0;
+    Sr = 1.0;
+  }
+
+/* If PLUTO wavespeeds are bad, fall back to the estimate used in ECHO */
+  if (wave_speed_fail){
+    getMaxSignalSpeeds_echo (Wl,Wr,Bx,&Sla,&Sra);
+	
+    if (Sla != Sla) {
+      printf("[hlle_sr_mhd]: NaN in Sl %10.4e %10.4e\n",Sl,Sr);
+      Sla = -1.0;
+      Sra =  1.0;
+    }
+	
+    if (Sra != Sra) {
+      printf("[hlle_sr_mhd]: NaN in Sr %10.4e %10.4e\n",Sl,Sr);
+      Sla = -1.0;
+      Sra = 1.0;
+    }
+	
+    if (Sla < -1.0) {
+      printf("[hlle_sr_mhd]: Superluminal Sl %10.4e %10.4e\n",Sl,Sr);
+      Sla = -1.0;
+      Sra = 1.0;
+    }
+    if (Sra > 1.0) {
+      printf("[hlle_sr_mhd]: Superluminal Sr %10.4e %10.4e\n",Sl,Sr);
+      Sla = -1.0;
+      Sra = 1.0;
+    }
+
+    Sl = Sla;
+    Sr = Sra;
+
+  }
+
+  *pSl = Sl;
+  *pSr = Sr;
+}
+
 /*! \fn void entropy_flux (const Cons1DS Ul, const Cons1DS Ur,
  *            const Prim1DS Wl, const Prim1DS Wr, const Real Bx, Real *pFlux)
  *  \brief Compute entropy flux. */
@@ -374,6 +473,62 @@ void flux_LR(Cons1DS U, Prim1DS W, Cons1DS *flux, Real Bx, Real* p)
   *p = pt;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static void flux_LR_pencil(const int n, const Cons1DS *U,
+ *                 const Prim1DS *W, const Real *Bx, ConsPencil *F)
+ *  \brief flux_LR() for n <= NPENCIL interfaces, into SoA arrays */
+static void flux_LR_pencil(const int n, const Cons1DS *U, const Prim1DS *W,
+                           const Real *Bx, ConsPencil *F)
+{
+  Real wtg2, pt, g, g2, g_2, h, gmmr, theta;
+#ifdef MHD
+  Real bx, by, bz, vB, b2, Bmag2;
+#endif
+  int m;
+
+  gmmr = Gamma / Gamma_1;
+
+  for (m=0; m<n; m++) {
+    theta = W[m].P/W[m].d;
+    h = 1.0 + gmmr*theta;
+
+    g   = U[m].d/W[m].d;
+    g2  = SQR(g);
+    g_2 = 1.0/g2;
+
+    pt = W[m].P;
+    wtg2 = W[m].d*h*g2;
+
+#ifdef MHD
+    vB = W[m].Vx*Bx[m] + W[m].Vy*W[m].By + W[m].Vz*W[m].Bz;
+    Bmag2 = SQR(Bx[m]) + SQR(W[m].By) + SQR(W[m].Bz);
+
+    bx = g*(Bx[m]*g_2 + vB*W[m].Vx);
+    by = g*(W[m].By*g_2 + vB*W[m].Vy);
+    bz = g*(W[m].Bz*g_2 + vB*W[m].Vz);
+
+    b2 = Bmag2*g_2 + vB*vB;
+
+    pt += 0.5*b2;
+    wtg2 += b2*g2;
+#endif
+
+    F->d[m]  = U[m].d*W[m].Vx;
+    F->E[m]  = U[m].Mx;
+#ifdef MHD
+    F->Mx[m] = wtg2*W[m].Vx*W[m].Vx + pt - bx*bx;
+    F->My[m] = wtg2*W[m].Vy*W[m].Vx - by*bx;
+    F->Mz[m] = wtg2*W[m].Vz*W[m].Vx - bz*bx;
+    F->By[m] = W[m].Vx*W[m].By - Bx[m]*W[m].Vy;
+    F->Bz[m] = W[m].Vx*W[m].Bz - Bx[m]*W[m].Vz;
+#else
+    F->Mx[m] = wtg2*W[m].Vx*W[m].Vx + pt;
+    F->My[m] = wtg2*W[m].Vy*W[m].Vx;
+    F->Mz[m] = wtg2*W[m].Vz*W[m].Vx;
+#endif
+  }
+}
+
 void getMaxSignalSpeeds_pluto(const Prim1DS Wl, const Prim1DS Wr,
 			      const Real Bx, Real* low, Real* high)
 {
@@ -37,6 +37,19 @@ void fluxes(const Cons1DS Ul, const Cons1DS Ur,
             const Prim1DS Wl, const Prim1DS Wr,
             const Real Bxi, Cons1DS *pF);
 
+/* fluxes() at the interfaces il..iu of a pencil: Ul[i],...,pF[i]; the SR
+ * HLLE and HLLD solvers have their own, and fluxes_pencil.c the default */
+void fluxes_pencil(const int il, const int iu,
+                   const Cons1DS *Ul, const Cons1DS *Ur,
+                   const Prim1DS *Wl, const Prim1DS *Wr,
+                   const Real *Bxi, Cons1DS *pF);
+
+#if defined(SPECIAL_RELATIVITY) && defined(HLLD_FLUX)
+/* hlld_sr.c: HLLE flux at the smooth interfaces with <time>/hybrid_flux=1 */
+void hybrid_flux_init(void);
+void hybrid_flux_destruct(void);
+#endif
+
 #ifdef SPECIAL_RELATIVITY
 void entropy_flux (const Cons1DS Ul, const Cons1DS Ur,
 		   const Prim1DS Wl, const Prim1DS Wr,
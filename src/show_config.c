@@ -165,6 +165,18 @@ void show_config(void)
   ath_pout(0," FFT:                     OFF\n");
 #endif
 
+#ifdef ASYNC_IO
+  ath_pout(0," Asynchronous I/O:        ON\n");
+#else
+  ath_pout(0," Asynchronous I/O:        OFF\n");
+#endif
+
+#ifdef OPENMP
+  ath_pout(0," OpenMP threads:          ON\n");
+#else
+  ath_pout(0," OpenMP threads:          OFF\n");
+#endif
+
 #ifdef SHEARING_BOX
   ath_pout(0," Shearing Box:            ON\n");
 #else
@@ -331,6 +343,18 @@ void show_config_par(void)
   par_sets("configure","FFT","no","FFT enabled?");
 #endif
 
+#ifdef ASYNC_IO
+  par_sets("configure","AsyncIO","yes","Asynchronous I/O enabled?");
+#else
+  par_sets("configure","AsyncIO","no","Asynchronous I/O enabled?");
+#endif
+
+#ifdef OPENMP
+  par_sets("configure","OpenMP","yes","OpenMP threads enabled?");
+#else
+  par_sets("configure","OpenMP","no","OpenMP threads enabled?");
+#endif
+
 #ifdef SHEARING_BOX
   par_sets("configure","ShearingBox","yes","Shearing box enabled?");
 #else
@@ -14,6 +14,9 @@
  * - minmax1()        - fast Min/Max for a 1d array using registers
  * - minmax2()        - fast Min/Max for a 2d array using registers
  * - minmax3()        - fast Min/Max for a 3d array using registers
+ * - ath_philox()       - Philox4x32-10 counter-based random integers
+ * - ath_rand_uniform() - counter-based uniform deviates in (0,1)
+ * - ath_rand_normal()  - counter-based standard normal deviates
  *============================================================================*/
 
 #include <stdio.h>
@@ -196,6 +199,93 @@ void minmax3(Real ***data, int nx3, int nx2, int nx1, Real *dmino, Real *dmaxo)
   *dmaxo = dmax;
 }
 
+/*============================================================================
+ * COUNTER-BASED RANDOM NUMBERS
+ *============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void ath_philox(const unsigned long seed, const unsigned long id,
+ *                      const unsigned int stream, const unsigned int n,
+ *                      unsigned int r[4])
+ *  \brief Philox4x32-10 counter-based random number generator (Salmon et al.
+ *   2011).
+ *
+ *   Returns in r[] four independent, uniformly distributed 32-bit integers,
+ *   which are a function only of the key (seed) and of the counter (id,
+ *   stream, n).  There is no state, so the deviates of e.g. a particle with
+ *   global id can be generated on any processor, in any order, and are the
+ *   same for any domain decomposition.  Use a different stream for each
+ *   quantity (x1, x2, v1, ...) and n = 0,1,2,... for successive deviates.
+ */
+void ath_philox(const unsigned long seed, const unsigned long id,
+                const unsigned int stream, const unsigned int n,
+                unsigned int r[4])
+{
+  unsigned int c0, c1, c2, c3, k0, k1;
+  unsigned long long p0, p1;
+  int i;
+
+  k0 = (unsigned int)(seed & 0xffffffffUL);
+  k1 = (unsigned int)(((unsigned long long)seed >> 32) & 0xffffffffUL);
+  c0 = (unsigned int)(id & 0xffffffffUL);
+  c1 = (unsigned int)(((unsigned long long)id >> 32) & 0xffffffffUL);
+  c2 = stream;
+  c3 = n;
+
+  for (i=0; i<10; i++) {
+    p0 = 0xD2511F53ULL*(unsigned long long)c0;
+    p1 = 0xCD9E8D57ULL*(unsigned long long)c2;
+    c0 = (unsigned int)(p1 >> 32) ^ c1 ^ k0;
+    c1 = (unsigned int)p1;
+    c2 = (unsigned int)(p0 >> 32) ^ c3 ^ k1;
+    c3 = (unsigned int)p0;
+    k0 += 0x9E3779B9U;
+    k1 += 0xBB67AE85U;
+  }
+
+  r[0] = c0;  r[1] = c1;  r[2] = c2;  r[3] = c3;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn Real ath_rand_uniform(const unsigned long seed, const unsigned long id,
+ *                            const unsigned int stream, const unsigned int n)
+ *  \brief The n-th uniform deviate in (0,1) (endpoints excluded) of the given
+ *   (seed, id, stream), with 53 random bits.  Two deviates per Philox block.
+ */
+Real ath_rand_uniform(const unsigned long seed, const unsigned long id,
+                      const unsigned int stream, const unsigned int n)
+{
+  unsigned int r[4], *w;
+
+  ath_philox(seed, id, stream, n/2, r);
+  w = &(r[2*(n%2)]);
+
+  return (Real)(((double)(w[0] >> 5)*67108864.0 + (double)(w[1] >> 6) + 0.5)
+                /9007199254740992.0);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn Real ath_rand_normal(const unsigned long seed, const unsigned long id,
+ *                           const unsigned int stream, const unsigned int n)
+ *  \brief The n-th standard normal deviate of the given (seed, id, stream),
+ *   by the Box-Muller transform of one Philox block.  Do not mix with
+ *   ath_rand_uniform() on the same stream.
+ */
+Real ath_rand_normal(const unsigned long seed, const unsigned long id,
+                     const unsigned int stream, const unsigned int n)
+{
+  unsigned int r[4];
+  double u1, u2;
+
+  ath_philox(seed, id, stream, n, r);
+  u1 = ((double)(r[0] >> 5)*67108864.0 + (double)(r[1] >> 6) + 0.5)
+       /9007199254740992.0;
+  u2 = ((double)(r[2] >> 5)*67108864.0 + (double)(r[3] >> 6) + 0.5)
+       /9007199254740992.0;
+
+  return (Real)(sqrt(-2.0*log(u1))*cos(2.0*PI*u2));
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \fn  void do_nothing_bc(GridS *pG)
  *
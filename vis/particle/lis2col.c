@@ -0,0 +1,351 @@
+/*==============================================================================
+ * FILE: lis2col.c
+ *
+ * PURPOSE: Transposes a sequence of particle snapshots (joined .lis files, see
+ *   join_lis.c, or single-file .plis snapshots) into one particle-major
+ *   columnar store (see par_colstore.h), in which the trajectory of a
+ *   particle is contiguous.  Particles are identified by (cpuid, pid) from
+ *   the first snapshot; particles that appear later are skipped, particles
+ *   that disappear get NaN values.  The output is filled through a shared
+ *   mmap() of the new file, so only one snapshot is held in memory.
+ *
+ * COMPILE USING: gcc -Wall -W -o lis2col lis2col.c par_colstore.c -lm
+ *
+ * USAGE: ./lis2col -d <dir> -i <basename-in> -s <post-name> -f <f1:f2:fi>
+ *                  -o <outfile> [-c <chunk size>] [-m]
+ *============================================================================*/
+
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "par_colstore.h"
+
+/* one snapshot in memory */
+typedef struct Snapshot_s{
+  long n;
+  float time;
+  float *data[PCOL_NQ];  /* x1,x2,x3,v1,v2,v3,dpar */
+  int *property, *cpuid;
+  long *pid;
+}Snapshot;
+
+static void read_snapshot(const char *fname, int single, Snapshot *snap);
+static void free_snapshot(Snapshot *snap);
+static void quicksort(int *cpuid, long *pid, long *order, long ns, long ne);
+static void col_error(const char *fmt, ...);
+static void usage(const char *arg);
+
+/* ========================================================================== */
+
+int main(int argc, char* argv[])
+{
+  /* argument variables */
+  int f1=0,f2=0,fi=1,single=0;
+  long C=4096;
+  char *defdir = ".";
+  char *inbase = NULL, *postname = NULL, *outname = NULL;
+  char *indir = defdir;
+  /* file variables */
+  char fname[256];
+  int fd;
+  /* data variables */
+  int i,q;
+  long p,n,t,T,N,c,idx,nskip=0,*order;
+  PColHeader hdr;
+  PColStore st;
+  PColChunk *index;
+  Snapshot snap;
+  char *map;
+  float *chunk;
+  int *cpuid,*property;
+  long *pid;
+
+  /* Read Arguments */
+  for (i=1; i<argc; i++) {
+/* If argv[i] is a 2 character string of the form "-?" then: */
+    if(*argv[i] == '-'  && *(argv[i]+1) != '\0' && *(argv[i]+2) == '\0'){
+      switch(*(argv[i]+1)) {
+      case 'd':                                /* -d <indir> */
+        indir = argv[++i];
+        break;
+      case 'i':                                /* -i <basename>   */
+        inbase = argv[++i];
+        break;
+      case 's':                                /* -s <post-name> */
+        postname = argv[++i];
+        break;
+      case 'f':                                /* -f <# range(f1:f2:fi)>*/
+        sscanf(argv[++i],"%d:%d:%d",&f1,&f2,&fi);
+        if (f2 == 0) f2 = f1;
+        break;
+      case 'o':                                /* -o <outfile> */
+        outname = argv[++i];
+        break;
+      case 'c':                                /* -c <chunk size> */
+        C = atol(argv[++i]);
+        break;
+      case 'm':                                /* -m: .plis input */
+        single = 1;
+        break;
+      default:
+        usage(argv[0]);
+        break;
+      }
+    }
+  }
+
+  /* Checkpoints */
+  if (inbase == NULL)
+    col_error("Please specify input file basename using -i option!\n");
+  if (postname == NULL)
+    col_error("Please specify posterior file name using -s option!\n");
+  if (outname == NULL)
+    col_error("Please specify the output file using -o option!\n");
+  if ((f1>f2) || (f2<0) || (fi<=0))
+    col_error("Wrong number sequence in the -f option!\n");
+  if (C <= 0)
+    col_error("The chunk size must be positive!\n");
+
+  /* ====================================================================== */
+
+  /* Step 1: particle identifiers from the first snapshot, sorted */
+  sprintf(fname,"%s/%s.%04d.%s.%s",indir,inbase,f1,postname,
+          single ? "plis" : "lis");
+  read_snapshot(fname, single, &snap);
+
+  N = snap.n;
+  T = (f2 - f1)/fi + 1;
+
+  order = (long*)malloc(N*sizeof(long));
+  if (order == NULL) col_error("Fail to allocate memory!\n");
+  for (p=0; p<N; p++) order[p] = p;
+  quicksort(snap.cpuid, snap.pid, order, 0, N-1);
+
+  /* Step 2: create and map the store */
+  pcol_layout(&hdr, N, T, C);
+
+  fd = open(outname, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) col_error("Fail to open output file %s!\n",outname);
+  if (ftruncate(fd, (off_t)pcol_file_size(&hdr)) != 0)
+    col_error("Fail to set the size of %s!\n",outname);
+  map = (char*)mmap(NULL, pcol_file_size(&hdr), PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) col_error("Fail to map %s!\n",outname);
+  close(fd);
+
+  memcpy(map, &hdr, sizeof(PColHeader));
+
+  cpuid    = (int*)(map + hdr.off_ids);
+  property = cpuid + N;
+  pid      = (long*)(property + N);
+  for (p=0; p<N; p++) {
+    cpuid[p]    = snap.cpuid[order[p]];
+    property[p] = snap.property[order[p]];
+    pid[p]      = snap.pid[order[p]];
+  }
+
+  index = (PColChunk*)(map + hdr.off_index);
+  for (c=0; c<hdr.nchunk; c++) {
+    index[c].first  = c*C;
+    index[c].count  = (c < hdr.nchunk-1) ? C : N - c*C;
+    index[c].offset = (long)pcol_chunk_offset(&hdr, c);
+    chunk = (float*)(map + index[c].offset);
+    for (p=0; p<PCOL_NQ*index[c].count*T; p++)
+      chunk[p] = NAN;
+  }
+
+  /* a read view of the new store, for pcol_find() */
+  st.map = map;
+  st.size = pcol_file_size(&hdr);
+  st.hdr = (const PColHeader*)map;
+  st.time = (const float*)(map + hdr.off_time);
+  st.cpuid = cpuid;  st.property = property;  st.pid = pid;
+  st.index = index;
+
+  free(order);
+
+  /* Step 3: scatter every snapshot into the trajectories */
+  for (t=0; t<T; t++)
+  {
+    i = f1 + t*fi;
+    fprintf(stderr,"Processing file number %d...\n",i);
+
+    if (t > 0) {
+      free_snapshot(&snap);
+      sprintf(fname,"%s/%s.%04d.%s.%s",indir,inbase,i,postname,
+              single ? "plis" : "lis");
+      read_snapshot(fname, single, &snap);
+    }
+
+    ((float*)(map + hdr.off_time))[t] = snap.time;
+
+    for (n=0; n<snap.n; n++) {
+      idx = pcol_find(&st, snap.cpuid[n], snap.pid[n]);
+      if (idx < 0) { nskip++; continue; }
+
+      c = idx/C;
+      chunk = (float*)(map + index[c].offset);
+      for (q=0; q<PCOL_NQ; q++)
+        chunk[(q*index[c].count + idx - index[c].first)*T + t] =
+          snap.data[q][n];
+    }
+  }
+  free_snapshot(&snap);
+
+  if (nskip > 0)
+    fprintf(stderr,"Skipped %ld entries of particles not in the first "
+                   "snapshot.\n",nskip);
+
+  munmap(map, pcol_file_size(&hdr));
+
+  return 0;
+}
+
+/* ========================================================================== */
+
+/* Reads a joined .lis file (single=0) or a .plis file (single=1) */
+static void read_snapshot(const char *fname, int single, Snapshot *snap)
+{
+  FILE *fid;
+  float header[12], time[2], rad;
+  int ntype, i, q;
+  long p;
+  char *buf, *pb;
+  size_t rec = 7*sizeof(float) + 2*sizeof(int) + sizeof(long);
+
+  fid = fopen(fname,"rb");
+  if (fid == NULL)
+    col_error("Fail to open input file %s!\n",fname);
+
+  /* read header */
+  if (fread(header,sizeof(float),12,fid) != 12 ||
+      fread(&ntype,sizeof(int),1,fid) != 1)
+    col_error("Fail to read the header of %s!\n",fname);
+  for (i=0; i<ntype; i++)
+    fread(&rad,sizeof(float),1,fid);
+  fread(time,sizeof(float),2,fid);
+  fread(&(snap->n),sizeof(long),1,fid);
+  snap->time = time[0];
+
+  for (q=0; q<PCOL_NQ; q++)
+    snap->data[q] = (float*)malloc((snap->n+1)*sizeof(float));
+  snap->property = (int*)malloc((snap->n+1)*sizeof(int));
+  snap->cpuid    = (int*)malloc((snap->n+1)*sizeof(int));
+  snap->pid      = (long*)malloc((snap->n+1)*sizeof(long));
+  if (snap->data[PCOL_NQ-1] == NULL || snap->pid == NULL)
+    col_error("Fail to allocate memory!\n");
+
+  if (single) { /* column blocks */
+    for (q=0; q<PCOL_NQ; q++)
+      fread(snap->data[q],sizeof(float),snap->n,fid);
+    fread(snap->property,sizeof(int),snap->n,fid);
+    fread(snap->pid,sizeof(long),snap->n,fid);
+    fread(snap->cpuid,sizeof(int),snap->n,fid);
+  }
+  else {        /* particle records, read in one block */
+    buf = (char*)malloc(snap->n*rec + 1);
+    if (buf == NULL) col_error("Fail to allocate memory!\n");
+    if (fread(buf,rec,snap->n,fid) != (size_t)snap->n)
+      col_error("Fail to read the particles of %s!\n",fname);
+    for (p=0; p<snap->n; p++) {
+      pb = buf + p*rec;
+      for (q=0; q<PCOL_NQ; q++)
+        memcpy(&(snap->data[q][p]), pb + q*sizeof(float), sizeof(float));
+      pb += 7*sizeof(float);
+      memcpy(&(snap->property[p]), pb, sizeof(int));   pb += sizeof(int);
+      memcpy(&(snap->pid[p]), pb, sizeof(long));       pb += sizeof(long);
+      memcpy(&(snap->cpuid[p]), pb, sizeof(int));
+    }
+    free(buf);
+  }
+
+  fclose(fid);
+}
+
+static void free_snapshot(Snapshot *snap)
+{
+  int q;
+
+  for (q=0; q<PCOL_NQ; q++) free(snap->data[q]);
+  free(snap->property);  free(snap->cpuid);  free(snap->pid);
+}
+
+/* Sorts order[] by (cpuid, pid), as in sort_lis.c */
+static void quicksort(int *cpuid, long *pid, long *order, long ns, long ne)
+{
+  long i, a, b, ind, pivot;
+
+  if (ne <= ns) return;
+
+  /* location of the pivot at half chain length */
+  pivot = (long)((ns+ne+1)/2);
+
+  /* move the pivot to the start */
+  ind = order[pivot];
+  order[pivot] = order[ns];
+  order[ns] = ind;
+
+  /* initial configuration */
+  pivot = ns;
+  i = ns + 1;
+
+  /* move the particles that are "smaller" than the pivot before it */
+  while (i <= ne)
+  {
+    a = order[i];   b = order[pivot];
+
+    if ((cpuid[a] < cpuid[b]) || ((cpuid[a] == cpuid[b]) && (pid[a] < pid[b])))
+    {/* the ith particle is smaller, move it before the pivot */
+      order[pivot] = a;
+      pivot++;
+      order[i] = order[pivot];
+      order[pivot] = b;
+    }
+    i++;
+  }
+
+  /* recursively call this routine to complete sorting */
+  quicksort(cpuid,pid,order,ns,pivot-1);
+  quicksort(cpuid,pid,order,pivot+1,ne);
+
+  return;
+}
+
+/* Write an error message and terminate with an error status. */
+static void col_error(const char *fmt, ...){
+  va_list ap;
+
+  va_start(ap, fmt);         /* ap starts after the fmt parameter */
+  vfprintf(stderr, fmt, ap); /* print the error message to stderr */
+  va_end(ap);                /* end stdargs (clean up the va_list ap) */
+
+  fflush(stderr);            /* flush it NOW */
+  exit(1);                   /* clean up and exit */
+}
+
+static void usage(const char *arg)
+{
+  fprintf(stderr,"\nUsage: %s [options] [block] ...\n", arg);
+  fprintf(stderr,"\nOptions:\n");
+  fprintf(stderr,"  -d <directory>  name of the input directory\n");
+  fprintf(stderr,"                  Default: current directory\n");
+  fprintf(stderr,"  -i <name>       basename of input file\n");
+  fprintf(stderr,"  -s <name>       posterior name of input file\n");
+  fprintf(stderr,"  -f f1:f2:fi     file number range and interval\n");
+  fprintf(stderr,"                  Default: <0:0:1>\n");
+  fprintf(stderr,"  -o <file>       output columnar store\n");
+  fprintf(stderr,"  -c <n>          particles per chunk, Default: 4096\n");
+  fprintf(stderr,"  -m              input are single-file .plis snapshots\n");
+  fprintf(stderr,"  -h              this help\n");
+
+  fprintf(stderr,"\nExample:\n");
+  fprintf(stderr,"%s -d joined_lis -i cr -s ds -f 0:500 -o cr.pcol\n\n", arg);
+
+  exit(0);
+}
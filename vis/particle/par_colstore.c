@@ -0,0 +1,165 @@
+/*==============================================================================
+ * FILE: par_colstore.c
+ *
+ * PURPOSE: Library to access the particle-major columnar store written by
+ *   lis2col (see par_colstore.h for the file layout).  The store is mapped
+ *   read-only with mmap(), so that pcol_trajectory() returns a pointer into
+ *   the mapping without any copy, and only the pages actually touched are
+ *   read from disk.
+ *
+ * COMPILE USING: gcc -Wall -W -c par_colstore.c, and link with your program
+ *
+ * CONTAINS FUNCTIONS:
+ * - pcol_layout()       - offsets of all sections of a new store
+ * - pcol_chunk_offset() - file offset of one chunk
+ * - pcol_file_size()    - total size of a store
+ * - pcol_open()         - maps a store and checks its header
+ * - pcol_close()        - unmaps a store
+ * - pcol_find()         - index of the particle (cpuid, pid), or -1
+ * - pcol_trajectory()   - pointer to the T values of quantity q of particle i
+ * - pcol_snapshot()     - gathers quantity q of all particles at output t
+ *============================================================================*/
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "par_colstore.h"
+
+#define PCOL_PAGE 4096L
+
+static long align(long n, long a) { return ((n + a - 1)/a)*a; }
+
+/* ========================================================================== */
+
+/* Sets the header of a new store with N particles, T outputs, chunk size C */
+void pcol_layout(PColHeader *hdr, long N, long T, long C)
+{
+  memset(hdr, 0, sizeof(PColHeader));
+  memcpy(hdr->magic, PCOL_MAGIC, 8);
+  hdr->version = PCOL_VERSION;
+  hdr->nq = PCOL_NQ;
+  hdr->N = N;
+  hdr->T = T;
+  hdr->C = C;
+  hdr->nchunk = (N + C - 1)/C;
+
+  hdr->off_time  = align(sizeof(PColHeader), 8);
+  hdr->off_ids   = align(hdr->off_time + T*sizeof(float), 8);
+  hdr->off_index = hdr->off_ids + N*(2*sizeof(int) + sizeof(long));
+  hdr->off_data  = align(hdr->off_index + hdr->nchunk*sizeof(PColChunk),
+                         PCOL_PAGE);
+}
+
+/* File offset of chunk c; every chunk starts on a page boundary */
+size_t pcol_chunk_offset(const PColHeader *hdr, long c)
+{
+  return hdr->off_data
+       + c*align(hdr->nq*hdr->C*hdr->T*sizeof(float), PCOL_PAGE);
+}
+
+/* Total file size of the store */
+size_t pcol_file_size(const PColHeader *hdr)
+{
+  long last;
+
+  if (hdr->nchunk == 0) return hdr->off_data;
+  last = hdr->N - (hdr->nchunk - 1)*hdr->C;
+
+  return pcol_chunk_offset(hdr, hdr->nchunk-1)
+       + hdr->nq*last*hdr->T*sizeof(float);
+}
+
+/* ========================================================================== */
+
+/* Maps the store fname read-only.  Returns 0 on success, -1 on error. */
+int pcol_open(PColStore *s, const char *fname)
+{
+  struct stat st;
+  int fd;
+
+  memset(s, 0, sizeof(PColStore));
+
+  if ((fd = open(fname, O_RDONLY)) < 0) return -1;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(PColHeader)) {
+    close(fd);
+    return -1;
+  }
+
+  s->size = (size_t)st.st_size;
+  s->map = mmap(NULL, s->size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd); /* the mapping stays valid */
+  if (s->map == MAP_FAILED) {
+    s->map = NULL;
+    return -1;
+  }
+
+  s->hdr = (const PColHeader*)s->map;
+  if (memcmp(s->hdr->magic, PCOL_MAGIC, 8) != 0 ||
+      s->hdr->version != PCOL_VERSION || pcol_file_size(s->hdr) > s->size) {
+    pcol_close(s);
+    return -1;
+  }
+
+  s->time     = (const float*)((const char*)s->map + s->hdr->off_time);
+  s->cpuid    = (const int*)((const char*)s->map + s->hdr->off_ids);
+  s->property = s->cpuid + s->hdr->N;
+  s->pid      = (const long*)(s->property + s->hdr->N);
+  s->index    = (const PColChunk*)((const char*)s->map + s->hdr->off_index);
+
+  return 0;
+}
+
+/* Unmaps the store */
+void pcol_close(PColStore *s)
+{
+  if (s->map != NULL) munmap(s->map, s->size);
+  memset(s, 0, sizeof(PColStore));
+}
+
+/* Index of the particle (cpuid, pid) by binary search, or -1 if absent */
+long pcol_find(const PColStore *s, int cpuid, long pid)
+{
+  long lo = 0, hi = s->hdr->N - 1, mid;
+
+  while (lo <= hi) {
+    mid = (lo + hi)/2;
+    if ((s->cpuid[mid] < cpuid) ||
+        ((s->cpuid[mid] == cpuid) && (s->pid[mid] < pid)))
+      lo = mid + 1;
+    else if ((s->cpuid[mid] == cpuid) && (s->pid[mid] == pid))
+      return mid;
+    else
+      hi = mid - 1;
+  }
+
+  return -1;
+}
+
+/* Pointer to the T contiguous values of quantity q of particle i */
+const float *pcol_trajectory(const PColStore *s, long i, int q)
+{
+  const PColChunk *ch = &(s->index[i/s->hdr->C]);
+  const float *data = (const float*)((const char*)s->map + ch->offset);
+
+  return data + (q*ch->count + (i - ch->first))*s->hdr->T;
+}
+
+/* Copies quantity q of all N particles at output t into out[N].  This is a
+ * strided gather (stride T floats), see the trade-off in par_colstore.h */
+void pcol_snapshot(const PColStore *s, int q, long t, float *out)
+{
+  const PColChunk *ch;
+  const float *data;
+  long c, i;
+
+  for (c=0; c<s->hdr->nchunk; c++) {
+    ch = &(s->index[c]);
+    data = (const float*)((const char*)s->map + ch->offset)
+         + q*ch->count*s->hdr->T + t;
+    for (i=0; i<ch->count; i++)
+      out[ch->first + i] = data[i*s->hdr->T];
+  }
+}
@@ -0,0 +1,87 @@
+#ifndef PAR_COLSTORE_H
+#define PAR_COLSTORE_H
+/*==============================================================================
+ * FILE: par_colstore.h
+ *
+ * PURPOSE: Particle-major columnar store of a particle time series, written by
+ *   lis2col from a sequence of .lis (or .plis) snapshots, and a small library
+ *   to access it through mmap().
+ *
+ *   The particles are identified by their (cpuid, pid) = (init_id, my_id) pair
+ *   and numbered 0..N-1 in sorted order.  They are grouped in chunks of C
+ *   consecutive indices.  Inside a chunk, quantity q of particle i at output t
+ *   is stored at data[q][i][t], so the trajectory of one quantity of one
+ *   particle is T contiguous floats, and one chunk holds the full trajectories
+ *   of its particles in one contiguous, page aligned block.  Values of
+ *   particles missing from a snapshot are NaN.
+ *
+ *   The layout favours trajectories over snapshots.  pcol_snapshot() is a
+ *   strided gather, with one float every T*4 bytes, so once T >= 1024 each
+ *   particle costs a page from disk.  Reading the quantity of all N
+ *   particles at one output then costs about N pages, against N*4 bytes in
+ *   a time-major [t][q][i] layout.  The store does not keep a second,
+ *   time-major copy: that would double its size.  The input snapshots
+ *   (.lis/.plis) already are time-major, so read these for whole snapshots.
+ *
+ *   File layout (native endianness, all sections 8-byte aligned):
+ *   - header:  char magic[8] = "ATHPCOL1", int version, int nq,
+ *              long N, long T, long C, long nchunk,
+ *              long off_time, long off_ids, long off_index, long off_data
+ *   - off_time:  float time[T]
+ *   - off_ids:   int cpuid[N], int property[N], long pid[N]
+ *   - off_index: PColChunk index[nchunk] = {first, count, offset}
+ *   - chunk data at index[c].offset (page aligned): float [nq][count][T]
+ *
+ *   The quantities are q = 0..6: x1, x2, x3, v1, v2, v3, dpar.
+ *============================================================================*/
+
+#include <stddef.h>
+
+#define PCOL_MAGIC   "ATHPCOL1"
+#define PCOL_VERSION 1
+#define PCOL_NQ      7
+
+/* quantity indices */
+enum PColQuantity {PCOL_X1, PCOL_X2, PCOL_X3, PCOL_V1, PCOL_V2, PCOL_V3,
+                   PCOL_DPAR};
+
+/* index entry of one chunk */
+typedef struct PColChunk_s{
+  long first;   /* index of the first particle in the chunk */
+  long count;   /* number of particles in the chunk */
+  long offset;  /* file offset of the chunk data */
+}PColChunk;
+
+/* header of the store, as written to the file */
+typedef struct PColHeader_s{
+  char magic[8];
+  int version, nq;
+  long N, T, C, nchunk;
+  long off_time, off_ids, off_index, off_data;
+}PColHeader;
+
+/* an opened (mapped) store */
+typedef struct PColStore_s{
+  void *map;            /* start of the mapping */
+  size_t size;          /* size of the mapping */
+  const PColHeader *hdr;
+  const float *time;    /* output times [T] */
+  const int *cpuid;     /* sorted particle identifiers [N] */
+  const int *property;
+  const long *pid;
+  const PColChunk *index;
+}PColStore;
+
+/* layout of a new store with N particles, T outputs and chunk size C */
+void pcol_layout(PColHeader *hdr, long N, long T, long C);
+size_t pcol_chunk_offset(const PColHeader *hdr, long c);
+size_t pcol_file_size(const PColHeader *hdr);
+
+/* read access */
+int  pcol_open(PColStore *s, const char *fname);
+void pcol_close(PColStore *s);
+long pcol_find(const PColStore *s, int cpuid, long pid);
+const float *pcol_trajectory(const PColStore *s, long i, int q);
+void pcol_snapshot(const PColStore *s, int q, long t, float *out);
+
+#endif /* PAR_COLSTORE_H */
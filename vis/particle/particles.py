@@ -469,4 +469,112 @@ class Particles:
             datax = np.repeat(phis,2)
             datay = np.repeat(self.hist[name][0],2)
             datay = np.insert(datay, [0,len(datay)], [datay[0],datay[0]])
-            ax.plot(datax, datay)
\ No newline at end of file
+            ax.plot(datax, datay)
+# Reads the in-situ spectra written by the pspec output (dump_particle_spectrum.c)
+#  returns a dictionary with the bin edges, output times and the histograms
+#  [ dimensions: <time> <particle type> <ekin bin> <mu bin> ]
+def read_spectrum (filename):
+    with open(filename, 'rb') as f:
+        prec, nparttypes, nekin, nmu = struct.unpack('i'*4, f.read(4*4))
+        real = {4: np.float32, 8: np.float64}[prec]
+        ekin_edges = np.frombuffer(f.read(prec*(nekin+1)), dtype=real)
+        mu_edges = np.frombuffer(f.read(prec*(nmu+1)), dtype=real)
+        record = np.dtype([('time', real), ('hist', real, (nparttypes, nekin, nmu))])
+        data = np.frombuffer(f.read(), dtype=record)
+    return {'ekin_edges': ekin_edges, 'mu_edges': mu_edges, \
+            'times': data['time'], 'hist': data['hist']}
+
+# Reads the in-situ displacement moments written by the pdif output
+#  (dump_particle_diffusion.c) and computes the running diffusion coefficients
+#  D_ij = (<dx_i dx_j> - <dx_i><dx_j>) / (2 (t - t0)), t0 the time the particle
+#  origins were set  [ dimensions: <time> <particle type> <ekin bin> <i> <j> ]
+def read_diffusion (filename, t0=0.0):
+    with open(filename, 'rb') as f:
+        prec, nparttypes, nekin, nmom = struct.unpack('i'*4, f.read(4*4))
+        real = {4: np.float32, 8: np.float64}[prec]
+        ekin_edges = np.frombuffer(f.read(prec*(nekin+1)), dtype=real)
+        record = np.dtype([('time', real), ('mom', real, (nparttypes, nekin, nmom))])
+        data = np.frombuffer(f.read(), dtype=record)
+    mom = data['mom']
+    mean = mom[...,1:4]
+    second = np.empty(mom.shape[:-1]+(3,3), dtype=real)
+    for n, (i,j) in enumerate([(0,0),(0,1),(0,2),(1,1),(1,2),(2,2)]):
+        second[...,i,j] = second[...,j,i] = mom[...,4+n]
+    cov = second - mean[...,:,None]*mean[...,None,:]
+    dt = (data['time'] - t0).reshape((-1,)+(1,)*(cov.ndim-1))
+    with np.errstate(divide='ignore', invalid='ignore'):
+        diff = np.where(dt > 0.0, cov/(2.0*dt), 0.0)
+    return {'ekin_edges': ekin_edges, 'times': data['time'], \
+            'count': mom[...,0], 'mean': mean, 'msd': second, 'D': diff}
+
+# Reads the trajectory file written by the ptrk output (dump_particle_track.c)
+#  of one processor, using the .tri index to locate the records.
+#  returns a list of (nstep, time, columns) with columns a dictionary of arrays
+#  my_id, init_id, property, x1, x2, x3, v1, v2, v3
+def read_tracks (filename):
+    index = filename[:-len('trk')] + 'tri'
+    with open(index, 'rb') as f:
+        prec, = struct.unpack('i', f.read(4))
+        real = {4: np.float32, 8: np.float64}[prec]
+        entry = np.dtype([('nstep', np.int32), ('time', real), ('offset', np.int64), ('n', np.int64)])
+        idx = np.frombuffer(f.read(), dtype=entry)
+    records = []
+    with open(filename, 'rb') as f:
+        for e in idx:
+            n = int(e['n'])
+            f.seek(int(e['offset']) + 4 + prec + 8)
+            cols = {'my_id': np.fromfile(f, dtype=np.int64, count=n),
+                    'init_id': np.fromfile(f, dtype=np.int32, count=n),
+                    'property': np.fromfile(f, dtype=np.int32, count=n)}
+            for name in ['x1', 'x2', 'x3', 'v1', 'v2', 'v3']:
+                cols[name] = np.fromfile(f, dtype=real, count=n)
+            records.append((int(e['nstep']), float(e['time']), cols))
+    return records
+
+# Reads a single-file particle snapshot written with out_fmt=lis, single_file=1
+#  (dump_particle_mpiio.c). Only the requested columns are read, one seek each.
+#  returns (time, dt, columns) with columns a dictionary of arrays
+def read_plis (filename, names=['x1','x2','x3','v1','v2','v3','dpar','property','my_id','init_id']):
+    layout = [(name, np.float32) for name in ['x1','x2','x3','v1','v2','v3','dpar']] \
+           + [('property', np.int32), ('my_id', np.int64), ('init_id', np.int32)]
+    with open(filename, 'rb') as f:
+        f.seek(12*4)
+        npartypes, = struct.unpack('i', f.read(4))
+        f.seek(4*npartypes, 1)
+        time, dt = struct.unpack('ff', f.read(8))
+        n, = struct.unpack('q', f.read(8))
+        offset = f.tell()
+        columns = {}
+        for name, dtype in layout:
+            if name in names:
+                f.seek(offset)
+                columns[name] = np.fromfile(f, dtype=dtype, count=n)
+            offset += n*np.dtype(dtype).itemsize
+    return time, dt, columns
+
+# Maps a particle-major columnar store written by lis2col (par_colstore.h).
+#  returns (times, ids, data) where ids is a structured array (cpuid, pid,
+#  property) and data(i) returns the [7, T] trajectory view of particle i
+#  (x1, x2, x3, v1, v2, v3, dpar) straight from the memory map
+def read_colstore (filename):
+    hdr = np.dtype([('magic', 'S8'), ('version', np.int32), ('nq', np.int32),
+                    ('N', np.int64), ('T', np.int64), ('C', np.int64), ('nchunk', np.int64),
+                    ('off_time', np.int64), ('off_ids', np.int64), ('off_index', np.int64),
+                    ('off_data', np.int64)])
+    mm = np.memmap(filename, dtype=np.uint8, mode='r')
+    h = mm[:hdr.itemsize].view(hdr)[0]
+    if h['magic'] != b'ATHPCOL1':
+        raise ValueError('%s is not a particle columnar store' % filename)
+    nq, N, T, C = int(h['nq']), int(h['N']), int(h['T']), int(h['C'])
+    times = mm[h['off_time']:h['off_time']+4*T].view(np.float32)
+    o = int(h['off_ids'])
+    ids = np.zeros(N, dtype=[('cpuid', np.int32), ('pid', np.int64), ('property', np.int32)])
+    ids['cpuid'] = mm[o:o+4*N].view(np.int32)
+    ids['property'] = mm[o+4*N:o+8*N].view(np.int32)
+    ids['pid'] = mm[o+8*N:o+16*N].view(np.int64)
+    index = mm[h['off_index']:h['off_index']+24*int(h['nchunk'])].view(np.int64).reshape(-1,3)
+    def data (i):
+        first, count, offset = index[i//C]
+        chunk = mm[offset:offset+4*nq*count*T].view(np.float32).reshape(nq, count, T)
+        return chunk[:, i-first, :]
+    return times, ids, data